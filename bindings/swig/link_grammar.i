@@ -24,7 +24,7 @@
 %ignore dictionary_create_default_lang;
 %ignore parse_options_memory_exhausted(Parse_Options opts); // Obsolete
 %ignore parse_options_resources_exhausted(Parse_Options opts);
-%ignore parse_options_set_max_memory(Parse_Options  opts, int mem); // No-Op
+%ignore parse_options_set_max_memory(Parse_Options  opts, size_t mem);
 %ignore parse_options_get_max_memory(Parse_Options opts);
 // End of ignored API calls.
 
@@ -80,11 +80,14 @@ struct Resources_s
 	size_t max_memory;      /* in bytes */
 	double time_when_parse_started;
 	size_t space_when_parse_started;
+	const size_t *space_in_use; /* Of the sentence being parsed, or NULL */
 	double when_created;
 	double when_last_called;
 	double cumulative_time;
+	double wall_deadline;   /* Wall-clock seconds, or -1 for none */
 	bool   memory_exhausted;
 	bool   timer_expired;
+	bool   cancel_requested; /* May be set by another thread */
 };
 
 struct Parse_Options_s
@@ -101,6 +104,7 @@ struct Parse_Options_s
 	/* Choice of the parser to use */
 #if USE_SAT_SOLVER
 	bool use_sat_solver;   /* Use the Boolean SAT based parser */
+	bool portfolio;        /* Race the classic and the SAT parsers */
 #endif
 
 	/* Options governing the parser internals operation */
@@ -115,6 +119,9 @@ struct Parse_Options_s
 	                          no longer than this.  Default = 16 */
 	bool all_short;        /* If true, no connectors that are exempt. */
 	bool repeatable_rand;  /* Reset rand number gen after every parse. */
+	bool anytime;          /* On timeout, keep the linkages counted so far */
+	bool adaptive_cost;    /* Lower disjunct_cost if the count overflows */
+	bool keep_forest;      /* Keep the packed parse forest of the sentence */
 
 	/* Options governing post-processing */
 	bool perform_pp_prune; /* Perform post-processing-based pruning TRUE */
@@ -143,7 +150,6 @@ struct Sentence_s
 	size_t length;              /* Number of words */
 	Word  *word;                /* Array of words after tokenization */
 	String_set *   string_set;  /* Used for assorted strings */
-	Pool_desc * Match_node_pool;
 	Pool_desc * Table_tracon_pool; /* Count memoizing memory pool */
 	Pool_desc * wordvec_pool;   /* For tracon-word zero-count memoizing */
 	Pool_desc * Exp_pool;
@@ -152,6 +158,7 @@ struct Sentence_s
 	Pool_desc * Connector_pool;
 	Pool_desc * Clause_pool;
 	Pool_desc * Tconnector_pool;
+	size_t space_in_use;        /* Bytes in the parse pools and tables */
 
 	/* Connector encoding, packing & sharing. */
 	size_t min_len_encoding;     /* Encode from this sentence length. */
@@ -165,13 +172,22 @@ struct Sentence_s
 	word_queue_t *word_queue_last;
 	size_t gword_node_num;       /* Debug - for differentiating between
 	                                wordgraph nodes with identical subwords. */
+	Token_memo_rec *token_memo_rec; /* Tokenization being recorded */
 
 	size_t min_len_multi_pruning; /* Do it from this sentence length. */
+	bool exp_pruned;             /* Expressions already pruned (pipeline.c) */
+	Prune_cache_entry *prune_cache_entry; /* Lookup result (prune-cache.c) */
+
+	/* Disjunct reuse between sentence versions (sentence_reparse()). */
+	Sentence reparse_prev;       /* Previous version, during its reparse */
+	bool record_disjuncts;       /* Record them for the next version */
+	Disjunct_record *disjunct_record;
 
 	/* Parse results */
 	int    num_linkages_found;  /* Total number before postprocessing.  This
 	                               is returned by the do_count() function */
 	bool   overflowed;          /* True, if counting overflowed. */
+	float  disjunct_cost;       /* The disjunct cost cutoff actually used */
 	size_t num_linkages_alloced;/* Total number of linkages allocated.
 	                               the number post-processed might be fewer
 	                               because some are non-canonical */
@@ -183,6 +199,8 @@ struct Sentence_s
 	size_t num_valid_linkages;  /* Number with no pp violations */
 	unsigned int null_count;    /* Number of null links in linkages */
 	Linkage        lnkages;     /* Sorted array of valid & invalid linkages */
+	Result_cache_entry *result_cache_entry; /* Borrowed parse results */
+	Forest forest;              /* Packed parse forest, if kept */
 	Postprocessor * postprocessor;
 	Postprocessor * constituent_pp;
 
@@ -202,4 +220,7 @@ struct Sentence_s
 	unsigned int wildcard_word_num_disjuncts;
 };
 
+/* A private copy of the options, for another thread (see options.c). */
+Parse_Options parse_options_copy(Parse_Options);
+
 #endif
@@ -38,6 +38,13 @@ typedef struct tracon_sharing_s Tracon_sharing;
 typedef struct Dialect_s Dialect;
 typedef struct Word_file_struct Word_file;
 typedef struct Wordgraph_pathpos_s Wordgraph_pathpos;
+typedef struct Result_cache_s Result_cache;
+typedef struct Result_cache_entry_s Result_cache_entry;
+typedef struct Prune_cache_s Prune_cache;
+typedef struct Prune_cache_entry_s Prune_cache_entry;
+typedef struct Token_memo_s Token_memo;
+typedef struct Token_memo_rec_s Token_memo_rec;
+typedef struct Disjunct_record_s Disjunct_record;
 
 /* Post-processing structures */
 typedef struct pp_knowledge_s pp_knowledge;
@@ -39,8 +39,8 @@ void free_connectors(Connector *e)
 	}
 }
 
-static unsigned int get_connector_length_limit(condesc_t *cd,
-                                               Parse_Options opts)
+unsigned int get_connector_length_limit(const condesc_t *cd,
+                                        Parse_Options opts)
 {
 	if (NULL == opts) return UNLIMITED_LEN;
 
@@ -225,6 +225,8 @@ static void set_all_condesc_length_limit(Dictionary dict)
 				sdesc[en]->more->length_limit = UNLIMITED_LEN;
 		}
 	}
+	/* For connectors that are added later (see condesc_update()). */
+	ct->default_length_limit = unlimited_len_found ? 0 : UNLIMITED_LEN;
 
 	condesc_length_limit_def_delete(&dict->contable);
 
@@ -420,14 +422,10 @@ static bool sort_condesc_by_uc_constring(Dictionary dict)
 		return true;
 
 	condesc_t **sdesc = malloc(ct->num_con * sizeof(condesc_t *));
-	size_t i = 0;
-	for (size_t n = 0; n < ct->size; n++)
+	for (size_t n = 0; n < ct->num_con; n++)
 	{
-		condesc_t *condesc = ct->hdesc[n].desc;
-
-		if (NULL == condesc) continue;
-		calculate_connector_info(condesc);
-		sdesc[i++] = condesc;
+		calculate_connector_info(ct->desc[n]);
+		sdesc[n] = ct->desc[n];
 	}
 
 	qsort(sdesc, ct->num_con, sizeof(*ct->sdesc), condesc_by_uc_constring);
@@ -467,16 +465,411 @@ static bool sort_condesc_by_uc_constring(Dictionary dict)
 	ct->sdesc = sdesc;
 	ct->num_uc = uc_num + 1;
 
-	/* hdesc is not freed here because it is needed for finding ZZZ.
-	 * It could be freed here if we have ZZZ cached in the dict structure. */
 	return true;
 }
 
+/* ================ Compiled connector descriptor table. ================ */
+/*
+ * Connector descriptors are looked up by their connector string (in
+ * make_connector_node()). When a dictionary has been loaded, its
+ * connectors are compiled into an immutable lookup table, which is
+ * never changed after that. It uses a perfect hash (by the "hash and
+ * displace" method): The string hash selects a bucket, and the
+ * displacement of this bucket then selects the slot, which is different
+ * for each connector in the table. So a lookup is a single probe, with
+ * no collision handling.
+ *
+ * New connectors are added to the hdesc hash table, which is used only
+ * by the dictionary writer (the dictionary reader, or a dynamic
+ * dictionary backend, which serializes its lookups), and they are
+ * published when they have been set up (condesc_setup() for a
+ * dictionary file, condesc_update() for a dynamic dictionary).
+ *
+ * Dynamic dictionaries (SQL, Atomese) publish new connectors after each
+ * sentence lookup. This is done by copy-on-write: A new version of the
+ * table is compiled from the connectors that have been added since its
+ * base version (the base is compiled again from all the connectors when
+ * they become too many), and then it replaces the published one. So a
+ * concurrent lookup never observes a table that is being rebuilt. The
+ * versions that are replaced are freed when no lookup is in progress.
+ */
+
+/* The published table and the readers count are accessed concurrently.
+ * With other compilers, a plain access is the best we can do. */
+#if defined __GNUC__
+#define CT_LOAD(v) __atomic_load_n(&(v), __ATOMIC_SEQ_CST)
+#define CT_STORE(v, x) __atomic_store_n(&(v), (x), __ATOMIC_SEQ_CST)
+#define CT_INC(v) __atomic_add_fetch(&(v), 1, __ATOMIC_SEQ_CST)
+#define CT_DEC(v) __atomic_sub_fetch(&(v), 1, __ATOMIC_SEQ_CST)
+#else
+#define CT_LOAD(v) (v)
+#define CT_STORE(v, x) ((v) = (x))
+#define CT_INC(v) (++(v))
+#define CT_DEC(v) (--(v))
+#endif
+
+#define CONDESC_BUCKET_SIZE 4 /* Average number of connectors per bucket */
+#define CONDESC_SEED_TRIES 8  /* Hash seeds to try before enlarging a table */
+#define CONDESC_PENDING_SIZE (1<<8) /* Initial hdesc size after publishing */
+
+struct condesc_table_s
+{
+	const condesc_table_t *base; /* Table of the preceding connectors */
+	condesc_table_t *next;       /* Next older version */
+	condesc_t **slot;
+	uint32_t *disp;              /* Displacement, by bucket */
+	uint32_t mask;               /* Number of slots - 1 */
+	uint32_t bucket_mask;        /* Number of buckets - 1 */
+	uint64_t seed;
+	size_t first_num;            /* The con_num of the first connector */
+	size_t num_con;              /* Number of connectors, including base */
+	unsigned int version;
+};
+
+static uint64_t condesc_str_hash64(const char *s, uint64_t seed)
+{
+	/* FNV-1a, and then the MurmurHash3 finalizer for mixing the bits. */
+	uint64_t h = 14695981039346656037ULL ^ seed;
+	for (; '\0' != *s; s++)
+		h = (h ^ (unsigned char)*s) * 1099511628211ULL;
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	return h;
+}
+
+static inline uint32_t condesc_table_bucket(const condesc_table_t *t,
+                                            uint64_t h)
+{
+	return (uint32_t)(h >> 32) & t->bucket_mask;
+}
+
+static inline uint32_t condesc_table_slot(const condesc_table_t *t,
+                                          uint64_t h, uint32_t disp)
+{
+	/* The step is odd, so all the slots can be reached. */
+	uint32_t step = (uint32_t)((h * 0x9E3779B97F4A7C15ULL) >> 32) | 1;
+	return ((uint32_t)h + disp * step) & t->mask;
+}
+
+static condesc_t *condesc_table_lookup(const condesc_table_t *t,
+                                       const char *constring)
+{
+	for (; NULL != t; t = t->base)
+	{
+		uint64_t h = condesc_str_hash64(constring, t->seed);
+		uint32_t disp = t->disp[condesc_table_bucket(t, h)];
+		condesc_t *desc = t->slot[condesc_table_slot(t, h, disp)];
+
+		if ((NULL != desc) && string_set_cmp(constring, desc->more->string))
+			return desc;
+	}
+
+	return NULL;
+}
+
+/**
+ * Find a displacement for each bucket, such that the slots of all the
+ * connectors are different. The largest buckets are placed first,
+ * each one at the first displacement at which all of its slots are
+ * still free.
+ * Return false if there is a bucket for which there is none.
+ */
+static bool condesc_table_place(condesc_table_t *t, size_t n,
+                                const uint64_t *hash, uint32_t *order,
+                                uint32_t *bstart, uint8_t *used)
+{
+	size_t nbuckets = t->bucket_mask + 1;
+	size_t nslots = (size_t)t->mask + 1;
+
+	/* Sort the connectors by their bucket. */
+	memset(bstart, 0, (nbuckets + 1) * sizeof(*bstart));
+	for (size_t i = 0; i < n; i++)
+		bstart[condesc_table_bucket(t, hash[i]) + 1]++;
+
+	size_t max_bucket_size = 0;
+	for (size_t b = 0; b < nbuckets; b++)
+	{
+		max_bucket_size = MAX(max_bucket_size, bstart[b + 1]);
+		bstart[b + 1] += bstart[b];
+	}
+
+	for (size_t i = 0; i < n; i++)
+	{
+		uint32_t b = condesc_table_bucket(t, hash[i]);
+		order[bstart[b]++] = (uint32_t)i;
+	}
+	for (size_t b = nbuckets; b > 0; b--) /* Restore the bucket starts. */
+		bstart[b] = bstart[b - 1];
+	bstart[0] = 0;
+
+	memset(used, 0, nslots);
+	memset(t->disp, 0, nbuckets * sizeof(*t->disp));
+
+	for (size_t bsize = max_bucket_size; bsize > 0; bsize--)
+	{
+		for (size_t b = 0; b < nbuckets; b++)
+		{
+			if (bsize != bstart[b + 1] - bstart[b]) continue;
+			const uint32_t *key = &order[bstart[b]];
+
+			uint32_t disp;
+			for (disp = 0; disp < nslots; disp++)
+			{
+				size_t k;
+				for (k = 0; k < bsize; k++)
+				{
+					uint32_t slot = condesc_table_slot(t, hash[key[k]], disp);
+					if (used[slot]) break;
+					used[slot] = 1;
+				}
+				if (k == bsize) break;
+
+				while (k-- > 0)
+					used[condesc_table_slot(t, hash[key[k]], disp)] = 0;
+			}
+			if (disp == nslots) return false;
+
+			t->disp[b] = disp;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Compile a lookup table for the connectors from \p first_num up to
+ * \p num_con (exclusive) in the \p desc array. The preceding ones are
+ * looked up in \p base.
+ */
+static condesc_table_t *condesc_table_compile(condesc_t **desc,
+                                              size_t first_num, size_t num_con,
+                                              const condesc_table_t *base)
+{
+	size_t n = num_con - first_num;
+	desc += first_num;
+
+	/* A load factor of up to 3/4 makes the placement fast. */
+	size_t nslots = 1;
+	while (3 * nslots < 4 * n) nslots <<= 1;
+	size_t nbuckets = 1;
+	while (CONDESC_BUCKET_SIZE * nbuckets < n) nbuckets <<= 1;
+
+	condesc_table_t *t = malloc(sizeof(condesc_table_t));
+	memset(t, 0, sizeof(condesc_table_t));
+	t->base = base;
+	t->first_num = first_num;
+	t->num_con = num_con;
+	t->bucket_mask = (uint32_t)(nbuckets - 1);
+	t->disp = malloc(nbuckets * sizeof(*t->disp));
+
+	uint64_t *hash = malloc(n * sizeof(*hash));
+	uint32_t *order = malloc(n * sizeof(*order));
+	uint32_t *bstart = malloc((nbuckets + 1) * sizeof(*bstart));
+	uint8_t *used = NULL;
+
+	/* Another seed is very likely to succeed. Else the table is too
+	 * crowded (or the connectors are very unlucky), so it is enlarged. */
+	for (unsigned int try = 0; ; try++)
+	{
+		if (0 == try % CONDESC_SEED_TRIES)
+		{
+			if (0 != try) nslots *= 2;
+			used = realloc(used, nslots);
+			t->mask = (uint32_t)(nslots - 1);
+		}
+
+		t->seed = try * 0x9E3779B97F4A7C15ULL;
+		for (size_t i = 0; i < n; i++)
+			hash[i] = condesc_str_hash64(desc[i]->more->string, t->seed);
+
+		if (condesc_table_place(t, n, hash, order, bstart, used)) break;
+		lgdebug(+11, "Connector table: Placement failed (try %u)\n", try);
+	}
+
+	t->slot = malloc(nslots * sizeof(*t->slot));
+	memset(t->slot, 0, nslots * sizeof(*t->slot));
+	for (size_t i = 0; i < n; i++)
+	{
+		uint32_t disp = t->disp[condesc_table_bucket(t, hash[i])];
+		t->slot[condesc_table_slot(t, hash[i], disp)] = desc[i];
+	}
+
+	free(hash);
+	free(order);
+	free(bstart);
+	free(used);
+
+	return t;
+}
+
+static void condesc_table_free(condesc_table_t *t)
+{
+	free(t->slot);
+	free(t->disp);
+	free(t);
+}
+
+/**
+ * Free the versions that are not used by the published one.
+ * No lookup may be in progress.
+ */
+static void condesc_table_free_unused(ConTable *ct)
+{
+	const condesc_table_t *table = ct->table;
+	condesc_table_t **prev = &ct->versions;
+
+	for (condesc_table_t *t = ct->versions; NULL != t; t = *prev)
+	{
+		if ((t == table) || ((NULL != table) && (t == table->base)))
+		{
+			prev = &t->next;
+			continue;
+		}
+
+		*prev = t->next;
+		condesc_table_free(t);
+	}
+}
+
+static void condesc_table_alloc(ConTable *ct, size_t size)
+{
+	ct->hdesc = malloc(size * sizeof(hdesc_t));
+	memset(ct->hdesc, 0, size * sizeof(hdesc_t));
+	ct->size = size;
+}
+
+/**
+ * Publish the connectors that have been set up since the last time,
+ * as a new version of the lookup table.
+ */
+static void condesc_publish(ConTable *ct)
+{
+	const condesc_table_t *table = ct->table;
+	const condesc_table_t *base = NULL;
+	size_t first_num = 0;
+
+	if (0 == ct->num_con) return;
+	if (NULL != table)
+	{
+		if (table->num_con == ct->num_con) return;
+
+		/* Compile only the new connectors, unless they are too many
+		 * relative to the base table; then compile it again. */
+		base = (NULL == table->base) ? table : table->base;
+		if (2 * (ct->num_con - base->num_con) < base->num_con)
+			first_num = base->num_con;
+		else
+			base = NULL;
+	}
+
+	condesc_table_t *t =
+		condesc_table_compile(ct->desc, first_num, ct->num_con, base);
+	t->version = ++ct->version;
+	t->next = ct->versions;
+	ct->versions = t;
+
+	CT_STORE(ct->table, (const condesc_table_t *)t);
+
+	lgdebug(+11, "Connector table version %u: %zu connectors, %zu compiled\n",
+	        t->version, t->num_con, t->num_con - t->first_num);
+
+	/* A lookup that starts after the new version has been published
+	 * cannot use the older ones. */
+	if (0 == CT_LOAD(ct->readers))
+		condesc_table_free_unused(ct);
+
+	/* The published connectors are not needed in hdesc any more. */
+	free(ct->hdesc);
+	condesc_table_alloc(ct, CONDESC_PENDING_SIZE);
+}
+
+/* ======================== UC part hashing. ========================== */
+
+static uint32_t uc_str_hash(const condesc_t *desc)
+{
+	const char *s = &desc->more->string[desc->more->uc_start];
+	uint32_t h = 2166136261U; /* FNV-1a */
+
+	for (size_t i = 0; i < desc->more->uc_length; i++)
+		h = (h ^ (unsigned char)s[i]) * 16777619U;
+
+	return h;
+}
+
+static hdesc_t *uc_find(ConTable *ct, const condesc_t *desc)
+{
+	const char *uc = &desc->more->string[desc->more->uc_start];
+	size_t uc_length = desc->more->uc_length;
+	uint32_t i = uc_str_hash(desc) & (ct->huc_size-1);
+
+	while (NULL != ct->huc[i].desc)
+	{
+		const condesc_more_t *m = ct->huc[i].desc->more;
+		if ((m->uc_length == uc_length) &&
+		    (0 == strncmp(&m->string[m->uc_start], uc, uc_length)))
+			break;
+		i = (i + 1) & (ct->huc_size-1);
+	}
+
+	return &ct->huc[i];
+}
+
+static void uc_table_alloc(ConTable *ct, size_t size)
+{
+	ct->huc = malloc(size * sizeof(hdesc_t));
+	memset(ct->huc, 0, size * sizeof(hdesc_t));
+	ct->huc_size = size;
+}
+
+static void uc_table_grow(ConTable *ct)
+{
+	size_t old_size = ct->huc_size;
+	hdesc_t *old_huc = ct->huc;
+
+	uc_table_alloc(ct, 2 * old_size);
+	for (size_t i = 0; i < old_size; i++)
+	{
+		if (NULL == old_huc[i].desc) continue;
+		*uc_find(ct, old_huc[i].desc) = old_huc[i];
+	}
+
+	free(old_huc);
+}
+
+/**
+ * Return the uc_num of the UC part of \p desc, which is a new number if
+ * no previous connector has the same UC part.
+ */
+static uint32_t condesc_uc_num(ConTable *ct, condesc_t *desc)
+{
+	hdesc_t *h = uc_find(ct, desc);
+
+	if (NULL != h->desc) return h->desc->uc_num;
+
+	if (UINT32_MAX == desc->uc_num) desc->uc_num = (uint32_t)ct->num_uc++;
+	h->desc = desc;
+	if ((8 * ct->num_uc) > (3 * ct->huc_size))
+		uc_table_grow(ct);
+
+	return desc->uc_num;
+}
+
+/* ==================================================================== */
+
 void condesc_delete(Dictionary dict)
 {
 	ConTable *ct = &dict->contable;
 
+	ct->table = NULL;
+	condesc_table_free_unused(ct);
 	free(ct->hdesc);
+	free(ct->huc);
+	free(ct->desc);
 	pool_delete(ct->desc_pool);
 	pool_delete(ct->more_pool);
 	condesc_length_limit_def_delete(ct);
@@ -486,8 +879,14 @@ void condesc_reuse(Dictionary dict)
 {
 	ConTable *ct = &dict->contable;
 
+	ct->table = NULL;
+	condesc_table_free_unused(ct);
+	free(ct->huc);
+	ct->huc = NULL;
+
 	ct->num_con = 0;
 	ct->num_uc = 0;
+	ct->last_num = 0;
 	memset(ct->hdesc, 0, ct->size * sizeof(hdesc_t));
 	pool_reuse(ct->desc_pool);
 	pool_reuse(ct->more_pool);
@@ -506,13 +905,6 @@ static hdesc_t *condesc_find(ConTable *ct, const char *constring, uint32_t hash)
 	return &ct->hdesc[i];
 }
 
-static void condesc_table_alloc(ConTable *ct, size_t size)
-{
-	ct->hdesc = malloc(size * sizeof(hdesc_t));
-	memset(ct->hdesc, 0, size * sizeof(hdesc_t));
-	ct->size = size;
-}
-
 #define CONDESC_TABLE_GROWTH_FACTOR 2
 
 static bool condesc_grow(ConTable *ct)
@@ -543,8 +935,32 @@ static bool condesc_grow(ConTable *ct)
 	return true;
 }
 
+/**
+ * Return the published descriptor of the given connector string, which
+ * must be in the dictionary string set, or NULL if it is not published.
+ * It takes no lock, and it may run concurrently with the dictionary
+ * writer.
+ */
+condesc_t *condesc_lookup(ConTable *ct, const char *constring)
+{
+	CT_INC(ct->readers);
+	condesc_t *desc = condesc_table_lookup(CT_LOAD(ct->table), constring);
+	CT_DEC(ct->readers);
+
+	return desc;
+}
+
+/**
+ * Return the descriptor of the given connector string, which must be
+ * in the dictionary string set. Published connectors are looked up
+ * with no lock. A new connector is added (the caller must be the
+ * dictionary writer), and it gets published after it is set up.
+ */
 condesc_t *condesc_add(ConTable *ct, const char *constring)
 {
+	condesc_t *desc = condesc_lookup(ct, constring);
+	if (NULL != desc) return desc;
+
 	uint32_t hash = (connector_uc_hash_t)connector_str_hash(constring);
 	hdesc_t *h = condesc_find(ct, constring, hash);
 
@@ -556,13 +972,19 @@ condesc_t *condesc_add(ConTable *ct, const char *constring)
 		h->desc->uc_num = UINT32_MAX;
 		h->desc->con_num = ct->num_con;
 
-		condesc_more_t *m = h->desc->more = pool_alloc(ct->desc_pool);
+		condesc_more_t *m = h->desc->more = pool_alloc(ct->more_pool);
 		m->string = constring;
 		m->str_hash = hash;
 
+		if (ct->num_con == ct->desc_size)
+		{
+			ct->desc_size = MAX(2 * ct->desc_size, CONDESC_PENDING_SIZE);
+			ct->desc = realloc(ct->desc, ct->desc_size * sizeof(condesc_t *));
+		}
+		ct->desc[ct->num_con] = h->desc;
 		ct->num_con++;
 
-		if ((8 * ct->num_con) > (3 * ct->size))
+		if ((8 * (ct->num_con - ct->last_num)) > (3 * ct->size))
 		{
 			if (!condesc_grow(ct)) return NULL;
 			h = condesc_find(ct, constring, hash);
@@ -583,6 +1005,9 @@ void condesc_init(Dictionary dict, size_t num_con)
 								  /*num_elements*/num_con, sizeof(condesc_more_t),
 								  /*zero_out*/true, /*align*/true, /*exact*/false);
 
+	ct->desc_size = num_con;
+	ct->desc = malloc(num_con * sizeof(condesc_t *));
+
 	// Connector hash table must be an exact power of two.
 	int nbits = 0;
 	while (num_con) { nbits++; num_con >>= 1; }
@@ -593,13 +1018,78 @@ void condesc_init(Dictionary dict, size_t num_con)
 
 	ct->length_limit_def = NULL;
 	ct->length_limit_def_next = &ct->length_limit_def;
+	ct->default_length_limit = UNLIMITED_LEN;
 }
 
+/**
+ * Set up the connectors of a dictionary that has been read, and publish
+ * them. Their uc_num is assigned in the alphabetical order of their UC
+ * part.
+ */
 void condesc_setup(Dictionary dict)
 {
+	ConTable *ct = &dict->contable;
+
+	/* The empty connector is used when tokenizing (see lookup-exprs.c),
+	 * so it should be published even if no expression uses it. */
+	if (NULL != dict->zzz_connector)
+		condesc_add(ct, dict->zzz_connector);
+
 	sort_condesc_by_uc_constring(dict);
 	set_all_condesc_length_limit(dict);
-	free(dict->contable.sdesc);
+	free(ct->sdesc);
+	ct->sdesc = NULL;
+
+	ct->last_num = ct->num_con;
+	condesc_publish(ct);
+}
+
+/**
+ * Set up the connectors that have been added to a dynamic dictionary
+ * since the last time, and publish them.
+ *
+ * New connectors dribble in with each new sentence. As there may be
+ * millions grand-total, sorting them all again as condesc_setup() does
+ * would be stunningly inefficient; only the new ones are processed.
+ * Published connectors may be in use by sentences that are being
+ * parsed, so they are never changed. Hence a new connector with a new
+ * UC part gets the next uc_num (not the one by the alphabetical order),
+ * which is found by the huc table. All of them get the default length
+ * limit.
+ *
+ * The caller must hold the dictionary writer lock.
+ */
+void condesc_update(Dictionary dict)
+{
+	ConTable *ct = &dict->contable;
+
+	if (ct->last_num == ct->num_con) return;
+
+	if (NULL == ct->huc)
+	{
+		/* Index the UC parts of the connectors that have been set up. */
+		size_t size = CONDESC_PENDING_SIZE;
+		while ((3 * size) < (8 * ct->num_uc)) size *= 2;
+		uc_table_alloc(ct, size);
+		for (size_t n = 0; n < ct->last_num; n++)
+			condesc_uc_num(ct, ct->desc[n]);
+	}
+
+	for (size_t n = ct->last_num; n < ct->num_con; n++)
+	{
+		condesc_t *desc = ct->desc[n];
+
+		calculate_connector_info(desc);
+		desc->more->length_limit = ct->default_length_limit;
+		desc->uc_num = condesc_uc_num(ct, desc);
+	}
+
+	lgdebug(+11, "Dictionary %s: added %zu different connectors "
+	        "(%zu with a different UC part)\n",
+	        dict->name, ct->num_con - ct->last_num, ct->num_uc);
+
+	ct->last_num = ct->num_con;
+	condesc_publish(ct);
 }
 
 /* ========================= END OF FILE ============================== */
@@ -132,11 +132,23 @@ typedef struct length_limit_def
 	int length_limit;
 } length_limit_def_t;
 
+/* A compiled (immutable) connector descriptor lookup table.
+ * See connectors.c. */
+typedef struct condesc_table_s condesc_table_t;
+
 typedef struct
 {
-	hdesc_t *hdesc;       /* Hashed connector descriptors table */
+	const condesc_table_t *table; /* The published lookup table */
+	condesc_table_t *versions;    /* All the compiled tables, newest first */
+	unsigned int readers; /* Number of lookups in progress */
+	unsigned int version; /* Number of published versions */
+	condesc_t **desc;     /* The connector descriptors, by con_num */
+	size_t desc_size;     /* Allocated size of desc */
+	hdesc_t *hdesc;       /* Hashed descriptors, not published yet */
+	size_t size;          /* Allocated size of hdesc */
+	hdesc_t *huc;         /* Descriptors hashed by their UC part */
+	size_t huc_size;      /* Allocated size of huc */
 	condesc_t **sdesc;    /* Alphabetically sorted descriptors */
-	size_t size;          /* Allocated size */
 	size_t num_con;       /* Number of connector types */
 	size_t num_uc;        /* Number of connector types with different UC part */
 	size_t last_num;      /* All condescs up to here have been done already. */
@@ -144,6 +156,7 @@ typedef struct
 	Pool_desc *more_pool; /* For condesc_t::more. */
 	length_limit_def_t *length_limit_def;
 	length_limit_def_t **length_limit_def_next;
+	uint8_t default_length_limit; /* For connectors with no defined limit */
 } ConTable;
 
 /* On a 64-bit machine, this struct should be exactly 4*8=32 bytes long.
@@ -182,6 +195,8 @@ struct Connector_struct
 void condesc_init(Dictionary, size_t);
 void condesc_reset(Dictionary);
 void condesc_setup(Dictionary);
+void condesc_update(Dictionary);
+condesc_t *condesc_lookup(ConTable *ct, const char *);
 condesc_t *condesc_add(ConTable *ct, const char *);
 void condesc_delete(Dictionary);
 void condesc_reuse(Dictionary);
@@ -227,6 +242,7 @@ static inline unsigned int connector_num(const Connector * c)
 
 /* Connector utilities ... */
 Connector * connector_new(Pool_desc *, const condesc_t *);
+unsigned int get_connector_length_limit(const condesc_t *, Parse_Options);
 void set_connector_farthest_word(Exp *, int, int, Parse_Options);
 void free_connectors(Connector *);
 void calculate_connector_info(condesc_t *);
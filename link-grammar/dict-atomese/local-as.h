@@ -10,6 +10,8 @@
 #include <opencog/atomspace/AtomSpace.h>
 #include <opencog/persist/api/StorageNode.h>
 
+#include "read-cache.h"
+
 using namespace opencog;
 
 class Local
@@ -18,6 +20,10 @@ public:
 	std::mutex dict_mutex; // Avoid corruption of Dictionary
 	std::mutex pair_mutex; // Guarantee unique link-name assignment
 
+	// Lock-free read path for cache hits. Writers hold dict_mutex.
+	ReadCache<const char*> word_cache; // Strings in dict->string_set
+	ReadCache<Exp*> dict_cache;        // Expressions in dict->root
+
 	// General housekeeping
 	bool using_external_as; // If false, then `asp` below is private.
 	AtomSpacePtr asp;
@@ -46,7 +52,8 @@ public:
 
 	// Word-pairs
 	Dictionary pair_dict;  // Cache of pre-computed word-pair exprs.
-	std::unordered_map<std::string, bool> have_pword;  // T/F cache.
+	ReadCache<Exp*> pair_cache;        // Expressions in pair_dict
+	ReadCache<bool> have_pword;        // T/F cache.
 	Handle prp;            // (Predicate "word-pair") or (Bond "ANY")
 	Handle mikey;          // (Predicate "*-Mutual Info Key-*")
 	Handle miformula;      // (DefinedProcedure "*-dynamic MI ANY")
@@ -67,6 +74,7 @@ public:
 Dictionary create_pair_cache_dict(Dictionary);
 
 const char* ss_add(const char *, Dictionary);
+Dict_node* dict_cache_lookup(Dictionary, const char*);
 
 double total_usage_time(void);
 
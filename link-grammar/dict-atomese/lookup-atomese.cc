@@ -385,90 +385,6 @@ void as_close(Dictionary dict)
 
 // ===============================================================
 
-/**
- * Specialized version of `condesc_setup()`, tuned for Atomese.
- * When new expressions are created (even temporary ones, e.g. for MST)
- * the connectors in those expressions are placed into a connector
- * hash table. The connectors are then compiled into a form that is
- * used to speed up matching. For a one-time dictionary load, this is
- * done by `condesc_setup()`.
- *
- * For Atomese, new connectors dribble in with each new sentance.
- * As there are millions grand-total, calling `condesc_setup()` is
- * stunningly inefficient; only the new ones need to be processed.
- * That's what this routine does.
- *
- * Limitations:
- * ++ All connectors are marked UNLIMITED_LEN.
- * ++ All connectors are assumed to be upper-case only, with no
- *    lower-case parts. (That means that there will never be two or
- *    more connectors with the same upper-case part, thus shortening
- *    the qsort, below.)
- */
-static void update_condesc(Dictionary dict)
-{
-	ConTable *ct = &dict->contable;
-
-	// How many new ones are there?
-	size_t num_new = ct->num_con - ct->last_num;
-	if (0 == num_new) return;
-
-	condesc_t **sdesc = (condesc_t **) malloc(num_new * sizeof(condesc_t *));
-	size_t i = 0;
-	for (size_t n = 0; n < ct->size; n++)
-	{
-		condesc_t *condesc = ct->hdesc[n].desc;
-
-		if (NULL == condesc) continue;
-		if (UINT32_MAX != condesc->uc_num) continue;
-
-		calculate_connector_info(condesc);
-		condesc->more->length_limit = UNLIMITED_LEN;
-		sdesc[i++] = condesc;
-	}
-
-	qsort(sdesc, num_new, sizeof(condesc_t *),
-	      condesc_by_uc_constring);
-
-	/* Enumerate the connectors according to their UC part. */
-	int uc_num = ct->num_uc;
-
-	sdesc[0]->uc_num = uc_num;
-	for (size_t n=1; n < num_new; n++)
-	{
-		condesc_t **condesc = &sdesc[n];
-
-		if (condesc[0]->more->uc_length != condesc[-1]->more->uc_length)
-		{
-			/* We know that the UC part has been changed. */
-			uc_num++;
-		}
-		else
-		{
-			const char *uc1 = &condesc[0]->more->string[condesc[0]->more->uc_start];
-			const char *uc2 = &condesc[-1]->more->string[condesc[-1]->more->uc_start];
-			if (0 != strncmp(uc1, uc2, condesc[0]->more->uc_length))
-			{
-				uc_num++;
-			}
-		}
-
-		//printf("%5d constring=%s\n", uc_num, condesc[0]->string);
-		condesc[0]->uc_num = uc_num;
-	}
-
-	lgdebug(+11, "Dictionary %s: added %zu different connectors "
-	        "(%d with a different UC part)\n",
-	        dict->name, ct->num_con, uc_num+1);
-
-	ct->num_uc = uc_num + 1;
-	ct->last_num = ct->num_con;
-
-	free(sdesc);
-}
-
-// ===============================================================
-
 // The sentence that this thread is working with. Assume one thread
 // per Sentence, which should be a perfectly valid assumption.
 thread_local Sentence sentlo = nullptr;
@@ -530,13 +446,16 @@ void as_end_lookup(Dictionary dict, Sentence sent)
 
 	// Create connector descriptors for any new connectors.
 	std::lock_guard<std::mutex> guard(local->dict_mutex);
-	update_condesc(dict);
+	condesc_update(dict);
 }
 
-/// Thread-safe dict lookup.
+/// Thread-safe dict lookup. Cache hits take no lock.
 static bool locked_dict_node_exists_lookup(Dictionary dict, const char *s)
 {
 	Local* local = (Local*) (dict->as_server);
+	Exp* exp;
+	if (local->dict_cache.find(s, exp)) return true;
+
 	std::lock_guard<std::mutex> guard(local->dict_mutex);
 	return dict_node_exists_lookup(dict, s);
 }
@@ -663,6 +582,11 @@ void make_dn(Dictionary dict, Exp* exp, const char* ssc)
 	dict->root = dict_node_insert(dict, dict->root, dn);
 	dict->num_entries++;
 
+	// Publish it for lock-free lookups. The word-pair cache dict
+	// has no server; get_pair_exprs() publishes those entries itself.
+	Local* local = (Local*) (dict->as_server);
+	if (local) local->dict_cache.insert(ssc, exp);
+
 	// Rebalance the tree every now and then.
 	if (0 == dict->num_entries%60)
 	{
@@ -675,8 +599,28 @@ void make_dn(Dictionary dict, Exp* exp, const char* ssc)
 const char* ss_add(const char *s, Dictionary dict)
 {
 	Local* local = (Local*) (dict->as_server);
+	const char* ssc;
+	if (local->word_cache.find(s, ssc)) return ssc;
+
 	std::lock_guard<std::mutex> guard(local->dict_mutex);
-	return string_set_add(s, dict->string_set);
+	ssc = string_set_add(s, dict->string_set);
+	local->word_cache.insert(ssc, ssc);
+	return ssc;
+}
+
+/// Lock-free lookup of a word that was already placed in the dict
+/// by make_dn(). Returns a lookup list (to be freed with
+/// dict_node_free_lookup()), or nullptr if the word is not cached.
+Dict_node* dict_cache_lookup(Dictionary dict, const char* ssc)
+{
+	Local* local = (Local*) (dict->as_server);
+	Exp* exp;
+	if (not local->dict_cache.find(ssc, exp)) return nullptr;
+
+	Dict_node* dn = dict_node_new();
+	dn->string = ssc;
+	dn->exp = exp;
+	return dn;
 }
 
 /// Given a word, return the collection of Dict_nodes holding the
@@ -737,10 +681,14 @@ Dict_node * as_lookup_list(Dictionary dict, const char *s)
 	// Create disjuncts consisting entirely of "ANY" links.
 	if (local->any_disjuncts)
 	{
+		// If it's cached, just return that.
+		Dict_node* dn = dict_cache_lookup(dict, ssc);
+		if (dn) return dn;
+
 		std::lock_guard<std::mutex> guard(local->dict_mutex);
 
-		// If it's cached, just return that.
-		Dict_node* dn = dict_node_lookup(dict, ssc);
+		// Some other thread might have just made it.
+		dn = dict_node_lookup(dict, ssc);
 		if (dn) return dn;
 
 		// Make a new one.
@@ -788,8 +736,6 @@ void as_clear_cache(Dictionary dict)
 	free_dict_node_recursive(local->pair_dict->root);
 	pool_reuse(dict->Exp_pool);
 
-	local->have_pword.clear();
-
 	// Clear the local AtomSpace too.
 	// Easiest way to do this is to just close and reopen
 	// the connection.
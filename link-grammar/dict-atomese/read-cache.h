@@ -0,0 +1,139 @@
+/*
+ * read-cache.h
+ *
+ * Insert-only string-keyed hash table, with a lock-free read path.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _ATOMESE_READ_CACHE_H
+#define _ATOMESE_READ_CACHE_H
+
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+/// Hash table from word strings to values, with lookups that take no
+/// lock. Writers must be serialized by the caller (with `dict_mutex`);
+/// readers may run concurrently with a writer.
+///
+/// Entries are never changed or removed once they are published, and
+/// a table that has been outgrown is retired, not freed: a reader that
+/// is still probing it sees a consistent, if slightly stale, snapshot.
+/// A stale miss is harmless, because a miss is always re-checked under
+/// the lock. Everything is freed when the cache is destroyed, i.e. when
+/// the dictionary is closed or its cache is cleared; no lookup can be
+/// in progress then.
+///
+/// The key strings are not copied; they must live as long as the cache.
+template<typename T>
+class ReadCache
+{
+	struct Entry
+	{
+		const char* key;
+		T value;
+	};
+
+	struct Table
+	{
+		size_t mask;
+		std::atomic<Entry*>* slot;
+	};
+
+	std::atomic<Table*> _table;
+	std::vector<Table*> _retired;
+	std::deque<Entry> _entries;
+
+	static size_t hash(const char* s)
+	{
+		size_t h = 14695981039346656037ULL; // FNV-1a
+		for (; '\0' != *s; s++)
+			h = (h ^ (unsigned char)*s) * 1099511628211ULL;
+		return h;
+	}
+
+	static Table* new_table(size_t size)
+	{
+		Table* t = new Table;
+		t->mask = size - 1;
+		t->slot = new std::atomic<Entry*>[size];
+		for (size_t i = 0; i < size; i++)
+			t->slot[i].store(nullptr, std::memory_order_relaxed);
+		return t;
+	}
+
+	static void delete_table(Table* t)
+	{
+		delete[] t->slot;
+		delete t;
+	}
+
+	static void put(Table* t, Entry* e)
+	{
+		size_t i = hash(e->key) & t->mask;
+		while (nullptr != t->slot[i].load(std::memory_order_relaxed))
+			i = (i + 1) & t->mask;
+
+		// Release: the entry is complete before it can be seen.
+		t->slot[i].store(e, std::memory_order_release);
+	}
+
+public:
+	ReadCache(void) : _table(new_table(256)) {}
+	ReadCache(const ReadCache&) = delete;
+	ReadCache& operator=(const ReadCache&) = delete;
+
+	~ReadCache()
+	{
+		delete_table(_table.load(std::memory_order_relaxed));
+		for (Table* t : _retired)
+			delete_table(t);
+	}
+
+	/// Lock-free lookup. Return true, and set `value`, if `key` is
+	/// in the cache.
+	bool find(const char* key, T& value) const
+	{
+		const Table* t = _table.load(std::memory_order_acquire);
+		size_t i = hash(key) & t->mask;
+		for (;;)
+		{
+			const Entry* e = t->slot[i].load(std::memory_order_acquire);
+			if (nullptr == e) return false;
+			if (0 == strcmp(e->key, key))
+			{
+				value = e->value;
+				return true;
+			}
+			i = (i + 1) & t->mask;
+		}
+	}
+
+	/// Publish `value` for `key`. The caller must hold the writer lock.
+	/// If `key` is already there, the first value is kept.
+	void insert(const char* key, const T& value)
+	{
+		T old;
+		if (find(key, old)) return;
+
+		// Keep the load factor at most 1/2. The bigger table is filled
+		// before it is published, so readers never see it half-built.
+		Table* t = _table.load(std::memory_order_relaxed);
+		if (2 * (_entries.size() + 1) > t->mask + 1)
+		{
+			Table* nt = new_table(2 * (t->mask + 1));
+			for (Entry& e : _entries)
+				put(nt, &e);
+			_table.store(nt, std::memory_order_release);
+			_retired.push_back(t);
+			t = nt;
+		}
+
+		_entries.push_back({key, value});
+		put(t, &_entries.back());
+	}
+};
+
+#endif /* _ATOMESE_READ_CACHE_H */
@@ -273,10 +273,14 @@ static Dict_node * lookup_plain_section(Dictionary dict, const Handle& germ)
 	const char* ssc = germ->get_name().c_str();
 
 	// Do we already have this word cached? If so, pull from
-	// the cache.
+	// the cache. Hits take no lock.
+	Dict_node* dn = dict_cache_lookup(dict, ssc);
+	if (dn) return dn;
+
+	// Another thread might have just created it.
 	{
 		std::lock_guard<std::mutex> guard(local->dict_mutex);
-		Dict_node* dn = dict_node_lookup(dict, ssc);
+		dn = dict_node_lookup(dict, ssc);
 		if (dn) return dn;
 	}
 
@@ -215,18 +215,15 @@ bool pair_boolean_lookup(Dictionary dict, const char *s)
 	Local* local = (Local*) (dict->as_server);
 
 	// Don't bother going to the AtomSpace, if we've looked this up
-	// word before. This will be faster, in all cases.
-	{
-		std::lock_guard<std::mutex> guard(local->dict_mutex);
-		const auto& havew = local->have_pword.find(s);
-		if (local->have_pword.end() != havew)
-			return havew->second;
-	}
+	// word before. This will be faster, in all cases. No lock needed.
+	bool have;
+	if (local->have_pword.find(s, have))
+		return have;
 
 	bool rc = bool_pair_fetch(dict, s);
 
 	std::lock_guard<std::mutex> guard(local->dict_mutex);
-	local->have_pword.insert({s,rc});
+	local->have_pword.insert(string_set_add(s, dict->string_set), rc);
 	return rc;
 }
 
@@ -298,6 +295,15 @@ static Exp* make_pair_exprs(Dictionary dict, const Handle& germ)
 static Exp* get_pair_exprs(Dictionary dict, const Handle& germ)
 {
 	Local* local = (Local*) (dict->as_server);
+	const char* wrd = germ->get_name().c_str();
+
+	// Cache hits take no lock.
+	Exp* exp;
+	if (local->pair_cache.find(wrd, exp))
+	{
+		lgdebug(D_USER_INFO, "Atomese: Found pairs in cache: >>%s<<\n", wrd);
+		return exp;
+	}
 
 	// Single big fat lock. The goal of this lock is to protect the
 	// Exp_pool in `local->pair_dict`. We have to hold it, begining
@@ -305,25 +311,25 @@ static Exp* get_pair_exprs(Dictionary dict, const Handle& germ)
 	// expressions for the same word, which then trip over a
 	// duplicate_word error during the second dictionary insert.
 	// Sadly, this wraps a big, fat slow Atomese section in the middle,
-	// but I don't see a way out. Over time, lookups should become
-	// increasingly rare, so this shouldn't matter, after a while.
+	// but I don't see a way out. It is taken only on cache misses,
+	// which should become increasingly rare, after a while.
 	std::lock_guard<std::mutex> guard(local->dict_mutex);
 
-	const char* wrd = germ->get_name().c_str();
 	Dictionary prdct = local->pair_dict;
 	Dict_node* dn = dict_node_lookup(prdct, wrd);
 
 	if (dn)
 	{
 		lgdebug(D_USER_INFO, "Atomese: Found pairs in cache: >>%s<<\n", wrd);
-		Exp* exp = dn->exp;
+		exp = dn->exp;
 		dict_node_free_lookup(prdct, dn);
 		return exp;
 	}
 
-	Exp* exp = make_pair_exprs(dict, germ);
+	exp = make_pair_exprs(dict, germ);
 	const char* ssc = string_set_add(wrd, dict->string_set);
 	make_dn(prdct, exp, ssc);
+	local->pair_cache.insert(ssc, exp);
 	return exp;
 }
 
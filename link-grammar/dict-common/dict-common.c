@@ -20,10 +20,13 @@
 #include "disjunct-utils.h"
 #include "file-utils.h"                // free_categories_from_disjunct_array
 #include "post-process/pp_knowledge.h" // Needed only for pp_close !!??
+#include "prune-cache.h"
 #include "regex-morph.h"
+#include "result-cache.h"
 #include "string-set.h"
 #include "tokenize/anysplit.h"
 #include "tokenize/spellcheck.h"
+#include "tokenize/token-memo.h"
 
 #include "dict-sql/read-sql.h"
 #include "dict-file/read-dict.h"
@@ -206,7 +209,10 @@ const Category *dictionary_get_categories(const Dictionary dict)
  */
 void dictionary_clear_cache(const Dictionary dict)
 {
-	if (dict) dict->clear_cache(dict);
+	if (!dict) return;
+	result_cache_clear(dict);
+	token_memo_clear(dict);
+	dict->clear_cache(dict);
 }
 
 /* ======================================================================== */
@@ -333,6 +339,9 @@ void dictionary_delete(Dictionary dict)
 	}
 	affix_list_delete(dict);
 
+	result_cache_delete(dict);
+	prune_cache_delete(dict);
+	token_memo_delete(dict);
 	spellcheck_destroy(dict->spell_checker);
 	if ((locale_t) 0 != dict->lctype) {
 		freelocale(dict->lctype);
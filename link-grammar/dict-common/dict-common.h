@@ -126,8 +126,10 @@ struct Dictionary_s
 	const char * name;
 	const char * lang;
 	const char * version;
+	uint64_t     file_fingerprint; /* Of its files (see dictopen_fingerprint()) */
 	const char * locale;    /* Locale name */
 	locale_t     lctype;    /* Locale argument for the *_l() functions */
+	bool         ascii_space[128]; /* iswspace_l() of the ASCII characters */
 
 	int          num_entries;
 	dfine_s      dfine;    /* Name-value definitions */
@@ -201,6 +203,15 @@ struct Dictionary_s
 	pp_knowledge  * base_knowledge;    /* Core post-processing rules */
 	pp_knowledge  * hpsg_knowledge;    /* Head-Phrase Structure rules */
 
+	/* Sentence parse results (see result-cache.c) */
+	Result_cache  * result_cache;
+
+	/* Persistent cache of pruned disjuncts (see prune-cache.c) */
+	Prune_cache   * prune_cache;
+
+	/* Tokenization of single tokens (see tokenize/token-memo.c) */
+	Token_memo    * token_memo;
+
 	/* Sentence generation */
 	unsigned int num_categories;
 	unsigned int num_categories_alloced;
@@ -18,6 +18,7 @@
 #include "dict-locale.h"
 #include "string-id.h"
 #include "string-set.h"
+#include "tokenize/token-memo.h"
 
 /* ======================================================================= */
 
@@ -387,6 +388,11 @@ void dictionary_setup_locale(Dictionary dict)
 	dict->lctype = 0;
 #endif /* HAVE_LOCALE_T */
 
+	/* The tokenizer looks up ASCII characters in this table instead of
+	 * calling mbrtowc() and iswspace_l() per character. */
+	for (wint_t c = 0; c < 128; c++)
+		dict->ascii_space[c] = iswspace_l(c, dict->lctype);
+
 	/* setlocale() returns a string owned by the system. Copy it. */
 	dict->locale = string_set_add(dict->locale, dict->string_set);
 }
@@ -445,6 +451,11 @@ bool dictionary_setup_defines(Dictionary dict)
 
 	dictionary_setup_locale(dict);
 
+	/* Old-style dictionaries keep their version in an expression, from
+	 * which linkgrammar_get_dict_version() makes a string. Make it now,
+	 * as the string set is frozen after the dictionary is read. */
+	linkgrammar_get_dict_version(dict);
+
 	dict->disable_downcasing = false;
 	const char * ddn =
 		linkgrammar_get_dict_define(dict, LG_DISABLE_DOWNCASING);
@@ -458,6 +469,8 @@ bool dictionary_setup_defines(Dictionary dict)
 		dict->default_max_disjuncts = atoi(mdstr);
 
 	if (!dictionary_setup_max_disjunct_cost(dict)) return false;
+
+	token_memo_create(dict);
 	return true;
 }
 
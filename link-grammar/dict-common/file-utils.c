@@ -278,9 +278,32 @@ static const char *get_dictionary_dir(bool find)
 #endif /* _MSC_VER */
 }
 
+/* Of the files opened by dictopen(); see dictopen_fingerprint(). */
+static TLS uint64_t dict_file_fingerprint;
+
 static void *dict_file_open(const char *fullname, const void *how)
 {
-	return fopen(fullname, how);
+	FILE *fp = fopen(fullname, how);
+	if (NULL == fp) return NULL;
+
+	/* Hash the content, 8 bytes at a time (FNV-1a on words). */
+	const uint64_t fnv_prime = UINT64_C(1099511628211);
+	uint64_t h = dict_file_fingerprint;
+	uint64_t buf[1024];
+	size_t n;
+
+	while (0 < (n = fread(buf, 1, sizeof(buf), fp)))
+	{
+		size_t nw = n / sizeof(uint64_t);
+		for (size_t i = 0; i < nw; i++)
+			h = (h ^ buf[i]) * fnv_prime;
+		for (size_t i = nw * sizeof(uint64_t); i < n; i++)
+			h = (h ^ ((unsigned char *)buf)[i]) * fnv_prime;
+	}
+	dict_file_fingerprint = h;
+	rewind(fp);
+
+	return fp;
 }
 
 /**
@@ -418,6 +441,21 @@ FILE *dictopen(const char *filename, const char *how)
 	return object_open(filename, dict_file_open, how);
 }
 
+/**
+ * Set the fingerprint of the files that dictopen() opens in this
+ * thread to \p fingerprint, and return its previous value.
+ *
+ * The content of each file that dictopen() opens is hashed into it.
+ * So the value after a dictionary is read, starting from a known one,
+ * identifies the content of its files (see the prune cache).
+ */
+uint64_t dictopen_fingerprint(uint64_t fingerprint)
+{
+	uint64_t previous = dict_file_fingerprint;
+	dict_file_fingerprint = fingerprint;
+	return previous;
+}
+
 /*
  * XXX - dict_file_open() cannot be used due to the Info printout
  * of opening a dictionary.
@@ -14,11 +14,13 @@
 #define _DICT_FILE_UTILITIES_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
 char * join_path(const char * prefix, const char * suffix);
 
 FILE * dictopen(const char *filename, const char *how);
+uint64_t dictopen_fingerprint(uint64_t fingerprint);
 void * object_open(const char *filename,
                    void * (*opencb)(const char *, const void *),
                    const void * user_data);
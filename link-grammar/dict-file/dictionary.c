@@ -318,6 +318,7 @@ Dictionary dictionary_create_from_file(const char * lang)
 		char * cons_name;
 		char * affix_name;
 		char * regex_name;
+		uint64_t saved_fingerprint = dictopen_fingerprint(0);
 
 		dict_name = join_path(lang, "4.0.dict");
 		pp_name = join_path(lang, "4.0.knowledge");
@@ -351,6 +352,16 @@ Dictionary dictionary_create_from_file(const char * lang)
 			}
 			free(dialect_name);
 		}
+
+		uint64_t file_fingerprint = dictopen_fingerprint(saved_fingerprint);
+		if (dictionary != NULL)
+			dictionary->file_fingerprint = file_fingerprint;
+
+		/* Sentences intern their strings on top of the dictionary's
+		 * ones (see sentence_create()). In generation mode, strings
+		 * are still added to it when parsing wildcard words. */
+		if ((dictionary != NULL) && !IS_GENERATION(dictionary))
+			string_set_freeze(dictionary->string_set);
 	}
 	else
 	{
@@ -576,7 +576,7 @@ static void db_end_lookup(Dictionary dict, Sentence sent)
 #if HAVE_THREADS_H
 	mtx_lock(&global_mutex);
 #endif
-	condesc_setup(dict);
+	condesc_update(dict);
 #if HAVE_THREADS_H
 	mtx_unlock(&global_mutex);
 #endif
@@ -122,6 +122,23 @@ link_public_api(void)
 link_public_api(void)
      dictionary_clear_cache(Dictionary);
 
+link_public_api(void)
+     dictionary_set_result_cache(Dictionary, size_t max_entries, size_t max_bytes);
+link_public_api(size_t)
+     dictionary_get_result_cache_hits(Dictionary);
+link_public_api(size_t)
+     dictionary_get_result_cache_misses(Dictionary);
+link_public_api(void)
+     dictionary_set_prune_cache(Dictionary, const char * dir);
+link_public_api(size_t)
+     dictionary_get_prune_cache_hits(Dictionary);
+link_public_api(size_t)
+     dictionary_get_prune_cache_misses(Dictionary);
+link_public_api(size_t)
+     dictionary_get_token_memo_hits(Dictionary);
+link_public_api(size_t)
+     dictionary_get_token_memo_misses(Dictionary);
+
 link_public_api(void)
      dictionary_set_data_dir(const char * path);
 link_public_api(char *)
@@ -187,13 +204,19 @@ link_public_api(void)
 link_public_api(int)
      parse_options_get_short_length(Parse_Options opts);
 link_public_api(void)
-     parse_options_set_max_memory(Parse_Options  opts, int mem);
-link_public_api(int)
+     parse_options_set_max_memory(Parse_Options  opts, size_t mem);
+link_public_api(size_t)
      parse_options_get_max_memory(Parse_Options opts);
 link_public_api(void)
      parse_options_set_max_parse_time(Parse_Options  opts, int secs);
 link_public_api(int)
      parse_options_get_max_parse_time(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_deadline(Parse_Options opts, double secs);
+link_public_api(double)
+     parse_options_get_deadline(Parse_Options opts);
+link_public_api(void)
+     parse_options_cancel(Parse_Options opts);
 link_public_api(void)
      parse_options_set_cost_model_type(Parse_Options opts, Cost_Model_type cm);
 link_public_api(Cost_Model_type)
@@ -206,6 +229,10 @@ link_public_api(void)
      parse_options_set_use_sat_parser(Parse_Options opts, bool use_sat_solver);
 link_public_api(bool)
      parse_options_get_use_sat_parser(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_portfolio(Parse_Options opts, bool val);
+link_public_api(bool)
+     parse_options_get_portfolio(Parse_Options opts);
 link_public_api(bool)
      parse_options_timer_expired(Parse_Options opts);
 link_public_api(bool)
@@ -220,6 +247,18 @@ link_public_api(void)
      parse_options_set_repeatable_rand(Parse_Options opts, bool val);
 link_public_api(bool)
      parse_options_get_repeatable_rand(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_anytime(Parse_Options opts, bool val);
+link_public_api(bool)
+     parse_options_get_anytime(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_adaptive_cost(Parse_Options opts, bool val);
+link_public_api(bool)
+     parse_options_get_adaptive_cost(Parse_Options opts);
+link_public_api(void)
+     parse_options_set_keep_forest(Parse_Options opts, bool val);
+link_public_api(bool)
+     parse_options_get_keep_forest(Parse_Options opts);
 link_public_api(void)
      parse_options_reset_resources(Parse_Options opts);
 
@@ -270,6 +309,8 @@ link_public_api(int)
      sentence_split(Sentence sent, Parse_Options opts);
 link_public_api(int)
      sentence_parse(Sentence sent, Parse_Options opts);
+link_public_api(int)
+     sentence_reparse(Sentence sent, Sentence prev, Parse_Options opts);
 link_public_api(int)
      sentence_length(Sentence sent);
 link_public_api(int)
@@ -284,11 +325,118 @@ link_public_api(int)
      sentence_num_violations(Sentence sent, LinkageIdx linkage_num);
 link_public_api(float)
      sentence_disjunct_cost(Sentence sent, LinkageIdx linkage_num);
+link_public_api(float)
+     sentence_max_disjunct_cost(Sentence sent);
 link_public_api(int)
      sentence_link_cost(Sentence sent, LinkageIdx linkage_num);
 link_public_api(bool)
      sentence_display_wordgraph(Sentence sent, const char *modestr);
 
+/**********************************************************************
+ *
+ * Functions to split a document (a stream of text) into sentences
+ *
+ ***********************************************************************/
+
+typedef struct Document_s * Document;
+
+link_public_api(Document)
+     document_create(Dictionary dict);
+link_public_api(void)
+     document_delete(Document doc);
+link_public_api(void)
+     document_feed(Document doc, const char *text, size_t len);
+link_public_api(void)
+     document_end(Document doc);
+link_public_api(const char *)
+     document_next_sentence(Document doc, size_t *offset, size_t *length);
+
+/**********************************************************************
+ *
+ * Functions to parse a sequence of sentences in a pipeline, in which
+ * helper threads tokenize and prune the next sentences while the
+ * current one is parsed
+ *
+ ***********************************************************************/
+
+typedef struct Pipeline_s * Pipeline;
+
+link_public_api(Pipeline)
+     pipeline_create(Dictionary dict, Parse_Options opts,
+                     int num_threads, int depth);
+link_public_api(void)
+     pipeline_delete(Pipeline p);
+link_public_api(bool)
+     pipeline_submit(Pipeline p, const char *input, void *user_data);
+link_public_api(Sentence)
+     pipeline_next(Pipeline p, int *num_linkages, void **user_data);
+
+/**********************************************************************
+ *
+ * Functions to access the packed parse forest, which encodes all the
+ * linkages of a sentence (at its final null count) in space linear
+ * in the size of the parse search, not in the number of linkages.
+ * It is kept only if the parse option "keep_forest" is set.
+ *
+ * The nodes are ordered children-first, so a single pass over them
+ * can compute any bottom-up quantity (best score, marginals, ...);
+ * the last node is the root. A node encodes all the linkages of the
+ * word range [lw, rw]; each of its choices selects the disjunct of a
+ * word between lw and rw, and a sub-forest on each side of it. The
+ * number of linkages of a choice is the product of the counts of its
+ * two children.
+ *
+ * The null count of a node is that of its linkages, as counted by
+ * sentence_null_count(). It is the sum of the null counts of the
+ * children of each of its choices, plus one for a choice that has no
+ * links (that skips a null word or starts an island), except at the
+ * root. The disjunct of a choice that skips a null word is
+ * LG_FOREST_NULL_WORD.
+ *
+ ***********************************************************************/
+
+typedef struct Forest_s * Forest;
+
+typedef struct
+{
+	unsigned int first_choice; /* Index of its first choice */
+	unsigned int num_choices;  /* 0 if it has no choices (a leaf) */
+	int count;                 /* Number of linkages (clamped to INT_MAX) */
+	short lw, rw;              /* Word range; lw is -1 at the root */
+	short null_count;          /* Null count of its linkages */
+} lg_forest_node;
+
+#define LG_FOREST_LEFT_LINK  1 /* The disjunct links to the node lw */
+#define LG_FOREST_RIGHT_LINK 2 /* The disjunct links to the node rw */
+#define LG_FOREST_NULL_WORD ((unsigned int)-1) /* Disjunct of a null word */
+
+typedef struct
+{
+	unsigned int child[2];     /* The left and right sub-forest nodes */
+	unsigned int disjunct;     /* Disjunct index, see forest_get_disjunct_*() */
+	short word;                /* Word of the disjunct */
+	short links;               /* LG_FOREST_LEFT_LINK | LG_FOREST_RIGHT_LINK */
+} lg_forest_choice;
+
+link_public_api(Forest)
+     sentence_get_forest(Sentence sent);
+link_public_api(size_t)
+     forest_num_nodes(Forest forest);
+link_public_api(const lg_forest_node *)
+     forest_get_nodes(Forest forest);
+link_public_api(size_t)
+     forest_num_choices(Forest forest);
+link_public_api(const lg_forest_choice *)
+     forest_get_choices(Forest forest);
+link_public_api(size_t)
+     forest_num_disjuncts(Forest forest);
+link_public_api(const char *)
+     forest_get_disjunct_str(Forest forest, size_t index);
+link_public_api(const char *)
+     forest_get_disjunct_word(Forest forest, size_t index);
+link_public_api(float)
+     forest_get_disjunct_cost(Forest forest, size_t index);
+
 /**********************************************************************
  *
  * Functions that create and manipulate Linkages.
@@ -784,6 +784,7 @@ void compute_generated_words(Sentence sent, Linkage linkage)
 Linkage linkage_create(LinkageIdx k, Sentence sent, Parse_Options opts)
 {
 	Linkage linkage;
+	bool chosen_words_done = false;
 
 #if USE_SAT_SOLVER
 	if (opts->use_sat_solver)
@@ -797,10 +798,14 @@ Linkage linkage_create(LinkageIdx k, Sentence sent, Parse_Options opts)
 		/* Cannot create a Linkage for a discarded linkage. */
 		if (sent->num_linkages_post_processed <= k) return NULL;
 		linkage = &sent->lnkages[k];
+
+		/* Linkages that have been created before, including those that
+		 * came from the result cache, already have their chosen words. */
+		chosen_words_done = (NULL != linkage->wg_path_display);
 	}
 
 	/* Perform remaining initialization we haven't done yet...*/
-	if (!IS_GENERATION(sent->dict))
+	if (!chosen_words_done && !IS_GENERATION(sent->dict))
 		compute_chosen_words(sent, linkage, opts);
 
 	linkage->is_sent_long = (linkage->num_words >= opts->twopass_length);
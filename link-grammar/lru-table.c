@@ -0,0 +1,130 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lru-table.h"
+
+static size_t table_size_for(size_t max_entries)
+{
+	size_t table_size = 16;
+	while (table_size < max_entries) table_size *= 2;
+	return table_size;
+}
+
+/**
+ * Initialize an empty table with a hash table sized for \p max_entries.
+ */
+void lru_table_init(Lru_table *t, size_t max_entries)
+{
+	memset(t, 0, sizeof(*t));
+	t->table_size = table_size_for(max_entries);
+	t->table = calloc(t->table_size, sizeof(*t->table));
+#if HAVE_THREADS_H
+	mtx_init(&t->mutex, mtx_plain);
+#endif
+}
+
+/**
+ * Size the hash table for \p max_entries, rehashing the existing entries.
+ */
+void lru_table_resize(Lru_table *t, size_t max_entries)
+{
+	size_t table_size = table_size_for(max_entries);
+	if (table_size == t->table_size) return;
+
+	free(t->table);
+	t->table = calloc(table_size, sizeof(*t->table));
+	t->table_size = table_size;
+
+	for (Lru_node *e = t->lru_first; NULL != e; e = e->lru_next)
+	{
+		Lru_node **bucket = &t->table[e->hash & (t->table_size - 1)];
+		e->hash_next = *bucket;
+		*bucket = e;
+	}
+}
+
+/** The entries should have been removed by the user. */
+void lru_table_destroy(Lru_table *t)
+{
+#if HAVE_THREADS_H
+	mtx_destroy(&t->mutex);
+#endif
+	free(t->table);
+	t->table = NULL;
+}
+
+Lru_node *lru_table_find(Lru_table *t, const char *key, uint32_t hash)
+{
+	for (Lru_node *e = t->table[hash & (t->table_size - 1)];
+	     NULL != e; e = e->hash_next)
+	{
+		if ((e->hash == hash) && (0 == strcmp(e->key, key))) return e;
+	}
+	return NULL;
+}
+
+static void lru_unlink(Lru_table *t, Lru_node *e)
+{
+	if (NULL == e->lru_prev)
+		t->lru_first = e->lru_next;
+	else
+		e->lru_prev->lru_next = e->lru_next;
+
+	if (NULL == e->lru_next)
+		t->lru_last = e->lru_prev;
+	else
+		e->lru_next->lru_prev = e->lru_prev;
+}
+
+static void lru_push_first(Lru_table *t, Lru_node *e)
+{
+	e->lru_prev = NULL;
+	e->lru_next = t->lru_first;
+	if (NULL == t->lru_first)
+		t->lru_last = e;
+	else
+		t->lru_first->lru_prev = e;
+	t->lru_first = e;
+}
+
+/**
+ * Add \p e as the most recently used entry.
+ * Its \c key and \c hash must have been set.
+ */
+void lru_table_insert(Lru_table *t, Lru_node *e)
+{
+	Lru_node **bucket = &t->table[e->hash & (t->table_size - 1)];
+	e->hash_next = *bucket;
+	*bucket = e;
+
+	lru_push_first(t, e);
+	t->num_entries++;
+}
+
+void lru_table_remove(Lru_table *t, Lru_node *e)
+{
+	Lru_node **p = &t->table[e->hash & (t->table_size - 1)];
+	while (*p != e) p = &(*p)->hash_next;
+	*p = e->hash_next;
+
+	lru_unlink(t, e);
+	t->num_entries--;
+}
+
+/** Make \p e the most recently used entry. */
+void lru_table_touch(Lru_table *t, Lru_node *e)
+{
+	lru_unlink(t, e);
+	lru_push_first(t, e);
+}
@@ -0,0 +1,77 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _LRU_TABLE_H
+#define _LRU_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#if HAVE_THREADS_H
+#include <threads.h>                    // mtx_t
+#endif
+
+/**
+ * A string-keyed hash table whose entries are also kept in the order
+ * of their last use, for the bounded caches (result-cache.c,
+ * tokenize/token-memo.c).
+ *
+ * An entry embeds an Lru_node as its first member. The table doesn't
+ * allocate or free entries; eviction policy is up to the user, which
+ * usually evicts lru_last. The lock is for the user too; the table
+ * functions don't take it.
+ */
+typedef struct Lru_node_s Lru_node;
+struct Lru_node_s
+{
+	Lru_node *hash_next;
+	Lru_node *lru_prev;            /* Toward the most recently used */
+	Lru_node *lru_next;            /* Toward the least recently used */
+	const char *key;               /* Owned by the entry */
+	uint32_t hash;
+};
+
+typedef struct
+{
+	Lru_node **table;
+	size_t table_size;             /* A power of 2 */
+	Lru_node *lru_first;           /* Most recently used */
+	Lru_node *lru_last;            /* Least recently used */
+	size_t num_entries;
+#if HAVE_THREADS_H
+	mtx_t mutex;
+#endif
+} Lru_table;
+
+void lru_table_init(Lru_table *, size_t);
+void lru_table_resize(Lru_table *, size_t);
+void lru_table_destroy(Lru_table *);
+
+Lru_node *lru_table_find(Lru_table *, const char *, uint32_t);
+void lru_table_insert(Lru_table *, Lru_node *);
+void lru_table_remove(Lru_table *, Lru_node *);
+void lru_table_touch(Lru_table *, Lru_node *);
+
+static inline void lru_table_lock(Lru_table *t)
+{
+#if HAVE_THREADS_H
+	mtx_lock(&t->mutex);
+#endif
+}
+
+static inline void lru_table_unlock(Lru_table *t)
+{
+#if HAVE_THREADS_H
+	mtx_unlock(&t->mutex);
+#endif
+}
+
+#endif /* _LRU_TABLE_H */
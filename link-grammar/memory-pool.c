@@ -85,6 +85,7 @@ Pool_desc *pool_new(const char *func, const char *name,
 	mp->alloced_elements = 0;
 	mp->num_elements = num_elements;
 	mp->alloced_bytes = 0;
+	mp->account = NULL;
 
 	lgdebug(+D_MEMPOOL, "%sElement size %zu, alignment %zu (pool '%s' created in %s())\n",
 	        POOL_ALLOCATOR?"":"(Fake pool allocator) ",
@@ -92,6 +93,18 @@ Pool_desc *pool_new(const char *func, const char *name,
 	return mp;
 }
 
+/**
+ * Charge the memory of the given pool to \p account (or to nothing if
+ * it is \c NULL). The account is then kept up to date when the pool
+ * grows, shrinks or gets deleted.
+ */
+void pool_set_account(Pool_desc *mp, size_t *account)
+{
+	if (NULL != mp->account) *mp->account -= mp->alloced_bytes;
+	mp->account = account;
+	if (NULL != mp->account) *mp->account += mp->alloced_bytes;
+}
+
 #if POOL_ALLOCATOR
 /**
  * Delete the given memory pool.
@@ -111,6 +124,8 @@ void pool_delete (const char *func, Pool_desc *mp)
 	lgdebug(+D_MEMPOOL, "Used %zu (%zu) elements (%s deleted pool '%s' created in %s())\n",
 	        mp->issued_elements, mp->num_elements, from_func, mp->name, mp->func);
 
+	if (NULL != mp->account) *mp->account -= mp->alloced_bytes;
+
 	/* Free its chained memory blocks. */
 	size_t alloc_size = mp->data_size;
 	char *c_next;
@@ -186,6 +201,7 @@ void *pool_alloc_vec(Pool_desc *mp, size_t vecsize)
 			 */
 			mp->alloced_elements += mp->num_elements;
 			mp->alloced_bytes += mp->block_size;
+			if (NULL != mp->account) *mp->account += mp->block_size;
 
 			/* aligned_alloc() has strict requirements. */
 			assert(NULL != mp->ring, "Aligned_alloc(%zu, %zu): %s",
@@ -276,6 +292,7 @@ void *pool_alloc_vec(Pool_desc *mp, size_t vecsize)
 	size_t totsz = sizeof(alloc_attr) + alloc_size;
 	mp->chain = malloc(totsz);
 	mp->alloced_bytes += totsz;
+	if (NULL != mp->account) *mp->account += totsz;
 
 	alloc_attr *at = (alloc_attr *)mp->chain;
 	at->next = next;
@@ -311,6 +328,8 @@ void pool_reuse(Pool_desc *mp)
 
 	mp->chain = NULL;
 	mp->issued_elements = 0;
+	if (NULL != mp->account) *mp->account -= mp->alloced_bytes;
+	mp->alloced_bytes = 0;
 }
 
 /*
@@ -331,6 +350,8 @@ void pool_delete (const char *func, Pool_desc *mp)
 	lgdebug(+D_MEMPOOL, "Used %zu (%zu) elements (%s deleted pool '%s' created in %s())\n",
 	        mp->issued_elements, mp->num_elements, from_func, mp->name, mp->func);
 
+	if (NULL != mp->account) *mp->account -= mp->alloced_bytes;
+
 	/* Free its chained memory blocks. */
 	char *c_next;
 
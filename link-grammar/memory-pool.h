@@ -32,6 +32,7 @@ Pool_desc *pool_new(const char *, const char *, size_t, size_t, bool, bool, bool
 void *pool_alloc_vec(Pool_desc *, size_t) GNUC_MALLOC;
 
 void pool_reuse(Pool_desc *);
+void pool_set_account(Pool_desc *, size_t *);
 #ifndef DEBUG
 void pool_delete(Pool_desc *);
 #else
@@ -90,6 +91,7 @@ struct  Pool_desc_s
 	size_t issued_elements;     // Number of elements issued to users.
 	size_t alloced_elements;    // Issued plus free (unissued) elements.
 	size_t alloced_bytes;       // Total bytes, including padding, etc.
+	size_t *account;            // Memory usage account, or NULL.
 
 	/* Flags that are used by pool_alloc(). */
 	bool zero_out;              // Zero out allocated elements.
@@ -65,6 +65,7 @@ Parse_Options parse_options_create(void)
 	po->islands_ok = false;
 #if USE_SAT_SOLVER
 	po->use_sat_solver = false;
+	po->portfolio = false;
 #endif
 	po->linkage_limit = 100;
 
@@ -79,6 +80,9 @@ Parse_Options parse_options_create(void)
 	po->perform_pp_prune = true;
 	po->twopass_length = 30;
 	po->repeatable_rand = true;
+	po->anytime = false;
+	po->adaptive_cost = false;
+	po->keep_forest = false;
 	po->resources = resources_create();
 	po->display_morphology = true;
 	po->dialect = (dialect_info){ .conf = strdup("") };
@@ -86,6 +90,24 @@ Parse_Options parse_options_create(void)
 	return po;
 }
 
+/**
+ * Return a copy of \p src for the exclusive use of another thread.
+ * It has its own resources (with the same limits, but not the same
+ * wall-clock deadline) and its own dialect cost table.
+ */
+Parse_Options parse_options_copy(Parse_Options src)
+{
+	Parse_Options opts = malloc(sizeof(struct Parse_Options_s));
+
+	*opts = *src;
+	opts->resources = resources_create();
+	opts->resources->max_parse_time = src->resources->max_parse_time;
+	opts->resources->max_memory = src->resources->max_memory;
+	opts->dialect = (dialect_info){ .conf = strdup(src->dialect.conf) };
+
+	return opts;
+}
+
 static void free_dialect_info(dialect_info *);
 int parse_options_delete(Parse_Options opts)
 {
@@ -246,6 +268,26 @@ bool parse_options_get_use_sat_parser(Parse_Options opts) {
 #endif
 }
 
+void parse_options_set_portfolio(Parse_Options opts, bool val) {
+#ifdef USE_SAT_SOLVER
+	opts->portfolio = val;
+#else
+	if (val && (verbosity > D_USER_BASIC))
+	{
+		prt_error("Error: Cannot enable portfolio parsing; "
+		          "this library was built without SAT solver support.\n");
+	}
+#endif
+}
+
+bool parse_options_get_portfolio(Parse_Options opts) {
+#if USE_SAT_SOLVER
+	return opts->portfolio;
+#else
+	return false;
+#endif
+}
+
 void parse_options_set_linkage_limit(Parse_Options opts, int dummy)
 {
 	opts->linkage_limit = dummy;
@@ -333,6 +375,47 @@ bool parse_options_get_repeatable_rand(Parse_Options opts) {
 	return opts->repeatable_rand;
 }
 
+/**
+ * True means that if the parse timer expires while counting, the
+ * linkages that have been completely counted so far are kept, instead
+ * of reporting no linkages. See classic_parse().
+ */
+void parse_options_set_anytime(Parse_Options opts, bool val) {
+	opts->anytime = val;
+}
+
+bool parse_options_get_anytime(Parse_Options opts) {
+	return opts->anytime;
+}
+
+/**
+ * True means that if the number of linkages of a sentence overflows
+ * (a "combinatorial explosion"), the parse is retried with the highest
+ * lower disjunct cost cutoff for which it doesn't overflow. The cutoff
+ * that has been used is returned by sentence_max_disjunct_cost().
+ * See classic_parse().
+ */
+void parse_options_set_adaptive_cost(Parse_Options opts, bool val) {
+	opts->adaptive_cost = val;
+}
+
+bool parse_options_get_adaptive_cost(Parse_Options opts) {
+	return opts->adaptive_cost;
+}
+
+/**
+ * True means that the parse keeps the packed parse forest of the
+ * sentence, for sentence_get_forest(). The parse result cache is not
+ * used then, since it doesn't hold forests.
+ */
+void parse_options_set_keep_forest(Parse_Options opts, bool val) {
+	opts->keep_forest = val;
+}
+
+bool parse_options_get_keep_forest(Parse_Options opts) {
+	return opts->keep_forest;
+}
+
 void parse_options_set_max_parse_time(Parse_Options opts, int dummy) {
 	opts->resources->max_parse_time = dummy;
 }
@@ -341,11 +424,42 @@ int parse_options_get_max_parse_time(Parse_Options opts) {
 	return opts->resources->max_parse_time;
 }
 
-void parse_options_set_max_memory(Parse_Options opts, int dummy) {
-	opts->resources->max_memory = dummy;
+/**
+ * Set a wall-clock deadline, \p secs seconds from now, for everything
+ * that is done with these options: tokenization, pruning, counting,
+ * linkage extraction and post-processing. Unlike max_parse_time, which
+ * is per-parse CPU time, the deadline is not restarted by each parse.
+ * A non-positive value removes it.
+ */
+void parse_options_set_deadline(Parse_Options opts, double secs) {
+	resources_set_deadline(opts->resources, secs);
+}
+
+double parse_options_get_deadline(Parse_Options opts) {
+	return resources_get_deadline(opts->resources);
+}
+
+/**
+ * Abort the parse that currently uses these options, as soon as possible.
+ * This may be called from any thread. The parse then behaves as if its
+ * timer has expired. The request stays in effect until
+ * parse_options_reset_resources() is called.
+ */
+void parse_options_cancel(Parse_Options opts) {
+	resources_cancel(opts->resources);
+}
+
+/**
+ * Set a per-parse memory budget, in bytes ((size_t)-1 for no budget).
+ * It covers the disjunct, count and parse-set memory of the sentence.
+ * When it is exhausted, the parse stops as on a timeout, and
+ * parse_options_memory_exhausted() returns true.
+ */
+void parse_options_set_max_memory(Parse_Options opts, size_t mem) {
+	opts->resources->max_memory = mem;
 }
 
-int parse_options_get_max_memory(Parse_Options opts) {
+size_t parse_options_get_max_memory(Parse_Options opts) {
 	return opts->resources->max_memory;
 }
 
@@ -370,6 +484,7 @@ bool parse_options_resources_exhausted(Parse_Options opts) {
 }
 
 void parse_options_reset_resources(Parse_Options opts) {
+	resources_clear_cancel(opts->resources);
 	resources_reset(opts->resources);
 }
 
@@ -118,6 +118,7 @@ struct count_context_s
 	bool    exhausted;
 	uint8_t num_growth;       /* Number of table growths, for debug */
 	bool    is_short;
+	unsigned int null_count;  /* The sentence null count of the table_lrcnt */
 	uint32_t checktimer;      /* Avoid excess system calls */
 	size_t table_size;        /* Can exceed 2**32 during generation. */
 	size_t table_mask;        /* 2**table_size -1 */
@@ -205,6 +206,7 @@ static void table_alloc(count_context_t *ctxt, unsigned int logsz)
 
 	size_t reqsz = 1ULL << logsz;
 	if (0 < logsz && reqsz <= ctxt->table_size) return; // It's big enough, already.
+	const size_t old_table_size = ctxt->table_size;
 
 #if HAVE_THREADS_H && !__EMSCRIPTEN__
 	// Install a thread-exit handler, to free kept_table on thread-exit.
@@ -224,6 +226,8 @@ static void table_alloc(count_context_t *ctxt, unsigned int logsz)
 		ctxt->table_size  = (1ULL << MAX_LOG2_TABLE_SIZE);
 
 	lgdebug(+D_COUNT, "Tracon table size %lu\n", ctxt->table_size);
+	ctxt->sent->space_in_use +=
+		(ctxt->table_size - old_table_size) * sizeof(Table_tracon *);
 
 	/* Keep the table indefinitely (until thread-exit), so that it can
 	 * be reused. This avoids a large overhead in malloc/free when
@@ -399,6 +403,7 @@ static void init_table_lrcnt(count_context_t *ctxt)
 			pool_new(__func__, "count_expectation", /*num_elements*/initial_size,
 			         sizeof(count_expectation), /*zero_out*/true,
 			         /*align*/false, /*exact*/false);
+		pool_set_account(sent->wordvec_pool, &sent->space_in_use);
 	}
 
 	const size_t match_list_pool_size = match_list_pool_size_estimate(sent);
@@ -408,6 +413,7 @@ static void init_table_lrcnt(count_context_t *ctxt)
 		pool_new(__func__, "Match list cache",
 		         /*num_elements*/match_list_pool_size, sizeof(match_list_cache),
 		         /*zero_out*/false, /*align*/false, /*exact*/false);
+	pool_set_account(ctxt->mlc_pool, &sent->space_in_use);
 }
 
 #ifdef DEBUG
@@ -539,6 +545,17 @@ static void table_grow(count_context_t *ctxt)
 		return;
 	}
 
+	// Don't grow beyond the memory budget. The table then just gets
+	// more crowded, and is_panic() stops the parse if the table entries
+	// themselves exhaust the budget.
+	if ((NULL != ctxt->current_resources) &&
+	    !resources_space_available(ctxt->current_resources,
+	                               ctxt->table_size * sizeof(Table_tracon *)))
+	{
+		ctxt->table_available_count = UINT_MAX;
+		return;
+	}
+
 	table_alloc(ctxt, 0);
 
 	/* Rehash. */
@@ -929,12 +946,13 @@ static bool is_panic(count_context_t *ctxt)
 	/* Panic mode: Return a parse bypass indication if resources are
 	 * exhausted.  checktimer is a device to avoid a gazillion system calls
 	 * to get the timer value. On circa-2018 machines, it results in
-	 * several timer calls per second. */
+	 * several hundred timer calls per second. A cancellation request
+	 * is noticed on the next call. */
 	if (ctxt->exhausted) return true;
 	ctxt->checktimer++;
-	if (((0 == ctxt->checktimer%(1<<18)) && (ctxt->current_resources != NULL) &&
+	if ((ctxt->current_resources != NULL) &&
 	     //fprintf(stderr, "T") &&
-	     resources_exhausted(ctxt->current_resources)))
+	     resources_poll(ctxt->current_resources, ctxt->checktimer, 1<<14))
 	{
 		ctxt->exhausted = true;
 		return true;
@@ -1705,6 +1723,17 @@ int do_parse(Sentence sent, fast_matcher_t *mchxt, count_context_t *ctxt,
 	ctxt->islands_ok = opts->islands_ok;
 	ctxt->mchxt = mchxt;
 
+	if ((sent->null_count != ctxt->null_count) && !ctxt->is_short)
+	{
+		/* The context is reused for another null count. The Table_tracon
+		 * entries are keyed by the null count and remain valid, but the
+		 * word-skip vectors of table_lrcnt assume the sentence null count
+		 * as the maximum one, so it is started anew. */
+		free_table_lrcnt(ctxt);
+		init_table_lrcnt(ctxt);
+	}
+	ctxt->null_count = sent->null_count;
+
 	hist = do_count("E", ctxt, -1, sent->length, NULL, NULL, sent->null_count+1);
 
 	table_stat(ctxt);
@@ -1718,6 +1747,7 @@ count_context_t * alloc_count_context(Sentence sent, Tracon_sharing *ts)
 	memset(ctxt, 0, sizeof(count_context_t));
 
 	ctxt->sent = sent;
+	ctxt->null_count = sent->null_count;
 	ctxt->is_short = !ENABLE_TABLE_LRCNT ||
 		((sent->length <= min_len_word_vector) && !IS_GENERATION(ctxt->sent->dict));
 
@@ -1756,6 +1786,7 @@ count_context_t * alloc_count_context(Sentence sent, Tracon_sharing *ts)
 			pool_new(__func__, "Table_tracon",
 			         16382 /* num_elts */, sizeof(Table_tracon),
 			         /*zero_out*/false, /*align*/false, /*exact*/false);
+		pool_set_account(sent->Table_tracon_pool, &sent->space_in_use);
 	}
 
 	init_table(ctxt);
@@ -1771,5 +1802,6 @@ void free_count_context(count_context_t *ctxt, Sentence sent)
 	            ctxt->count_cost[0], ctxt->count_cost[1], ctxt->count_cost[2]);)
 
 	free_table_lrcnt(ctxt);
+	sent->space_in_use -= ctxt->table_size * sizeof(Table_tracon *);
 	free(ctxt);
 }
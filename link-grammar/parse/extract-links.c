@@ -24,7 +24,11 @@
 #include "disjunct-utils.h"             // Disjunct
 #include "extract-links.h"
 #include "fast-match.h"
+#include "forest.h"
 #include "memory-pool.h"
+#include "print/print-util.h"       // patch_subscript_mark
+#include "resources.h"
+#include "string-set.h"
 #include "utilities.h"                  // Windows rand_r()
 #include "linkage/linkage.h"
 #include "tokenize/word-structures.h"   // Word_Struct
@@ -69,6 +73,7 @@ struct Parse_set_struct
 	uint8_t        null_count; /* number of island words */
 
 	count_t count;             /* The number of ways to parse. */
+	unsigned int choice_index; /* of its first element in pex->choice[] */
 #ifdef RECOUNT
 	count_t recount;  /* Exactly the same as above, but counted at a later stage. */
 	count_t cut_count;  /* Count only low-cost parses, i.e. below the cost cutoff */
@@ -96,7 +101,14 @@ struct extractor_s
 	Word           *words;
 	Pool_desc *    Pset_bucket_pool;
 	Pool_desc *    Parse_choice_pool;
+	Parse_choice **choice;            /* All the Parse_choice elements */
+	w_count_t *    cum_count;         /* Running sums of their counts */
+	size_t         num_choices;
 	bool           islands_ok;
+	bool           exhausted;         /* Building the parse set stopped */
+	unsigned int   checktimer;
+	Resources      resources;
+	size_t *       space_in_use;      /* Memory accounting */
 
 	/* thread-safe random number state */
 	unsigned int rand_state;
@@ -228,6 +240,8 @@ extractor_t * extractor_new(Sentence sent)
 
 	pex->x_table = (Pset_bucket**) xalloc(pex->x_table_size * sizeof(Pset_bucket*));
 	memset(pex->x_table, 0, pex->x_table_size * sizeof(Pset_bucket*));
+	pex->space_in_use = &sent->space_in_use;
+	*pex->space_in_use += pex->x_table_size * sizeof(Pset_bucket*);
 
 	// What's good for the goose is good for the gander.
 	// The pex->x_table_size is a good upper-bound estimate for how
@@ -245,6 +259,9 @@ extractor_t * extractor_new(Sentence sent)
 		         /*num_elements*/pcsze, sizeof(Parse_choice),
 		         /*zero_out*/false, /*align*/false, /*exact*/false);
 
+	pool_set_account(pex->Pset_bucket_pool, pex->space_in_use);
+	pool_set_account(pex->Parse_choice_pool, pex->space_in_use);
+
 	return pex;
 }
 
@@ -278,10 +295,19 @@ void free_extractor(extractor_t * pex)
 
 	pex->parse_set = NULL;
 
+	*pex->space_in_use -= pex->x_table_size * sizeof(Pset_bucket*);
 	xfree((void *) pex->x_table, pex->x_table_size * sizeof(Pset_bucket*));
 	pex->x_table_size = 0;
 	pex->x_table = NULL;
 
+	if (NULL != pex->choice)
+	{
+		*pex->space_in_use -= pex->num_choices *
+			(sizeof(Parse_choice *) + sizeof(w_count_t));
+		xfree(pex->choice, pex->num_choices * sizeof(Parse_choice *));
+		xfree(pex->cum_count, pex->num_choices * sizeof(w_count_t));
+	}
+
 #if HAVE_MALLOC_TRIM
 	// MST parsing can result in pathological cases, with almost a
 	// billion elts in the Parse_choice_pool. This blows up the
@@ -458,6 +484,27 @@ bool smk_parse_set(fast_matcher_t *mchxt,
 	return ((s[0] != NULL) || (s[1] != NULL) || (s[2] != NULL) || (s[3] != NULL));
 }
 
+/**
+ * Return true if building the parse set should stop, because the memory
+ * budget is exhausted or the parse has been cancelled. A timeout alone
+ * doesn't stop it, so that the linkages of a partial "anytime" count can
+ * still be extracted.
+ */
+static bool is_panic(extractor_t *pex)
+{
+	if (pex->exhausted) return true;
+	Resources r = pex->resources;
+	if (resources_cancel_requested(r) ||
+	    ((0 == (++pex->checktimer & 1023)) && resources_memory_exhausted(r)))
+	{
+		(void)resources_exhausted(r); /* Record the reason. */
+		pex->exhausted = true;
+		return true;
+	}
+
+	return false;
+}
+
 /**
  * returns NULL if there are no ways to parse, or returns a pointer
  * to a set structure representing all the ways to parse.
@@ -488,6 +535,8 @@ Parse_set * mk_parse_set(fast_matcher_t *mchxt,
 	/* Perhaps we've already computed it; if so, return it. */
 	if (xtp != NULL) return &xtp->set;
 
+	if (is_panic(pex)) return NULL;
+
 	/* Start it out with the empty set of parse choices. */
 	/* This entry must be updated before we return. */
 	xtp = x_table_store(lw, rw, le, re, null_count, pex);
@@ -732,37 +781,78 @@ Parse_set * mk_parse_set(fast_matcher_t *mchxt,
 }
 
 /**
+ * Index the Parse_choice elements of each Parse_set: copy them, in
+ * chain order, to consecutive slots of pex->choice[], and store the
+ * running sums of their counts in the parallel pex->cum_count[].
+ * This allows list_links() and list_random_links() to select a
+ * Parse_choice by a binary search instead of walking the chain.
+ *
+ * The count of a Parse_choice is clamped to INT_MAX, as in
+ * parse_count_clamp(), so the sums cannot overflow.
+ *
  * Return TRUE if and only if an overflow in the number of parses
- * occurred. Use a 64-bit int for counting.
+ * occurred.
  */
-static bool set_node_overflowed(Parse_set *set)
+static bool index_choices(extractor_t * pex)
 {
-	Parse_choice *pc;
-	w_count_t n = 0;
-	if (set == NULL || set->first == NULL) return false;
+	assert(pex->x_table != NULL, "called index_choices with x_table==NULL");
+
+	size_t num_choices = pool_num_elements_issued(pex->Parse_choice_pool);
+	pex->num_choices = num_choices;
+	pex->choice = xalloc(num_choices * sizeof(Parse_choice *));
+	pex->cum_count = xalloc(num_choices * sizeof(w_count_t));
+	*pex->space_in_use +=
+		num_choices * (sizeof(Parse_choice *) + sizeof(w_count_t));
 
-	for (pc = set->first; pc != NULL; pc = pc->next)
+	bool overflowed = false;
+	unsigned int n = 0;
+	for (unsigned int i = 0; i < pex->x_table_size; i++)
 	{
-		n += (w_count_t)pc->set[0]->count * pc->set[1]->count;
-		if (PARSE_NUM_OVERFLOW < n) return true;
+		for (Pset_bucket *t = pex->x_table[i]; t != NULL; t = t->next)
+		{
+			Parse_set *set = &t->set;
+			w_count_t total = 0;
+
+			set->choice_index = n;
+			for (Parse_choice *pc = set->first; pc != NULL; pc = pc->next)
+			{
+				w_count_t pc_count = (w_count_t)pc->set[0]->count * pc->set[1]->count;
+				if (INT_MAX < pc_count) pc_count = INT_MAX;
+				total += pc_count;
+
+				pex->choice[n] = pc;
+				pex->cum_count[n] = total;
+				n++;
+			}
+			if (PARSE_NUM_OVERFLOW < total) overflowed = true;
+		}
 	}
-	return false;
+	assert(n == num_choices, "Parse_choice count mismatch (%u != %zu)",
+	       n, num_choices);
+
+	return overflowed;
 }
 
-static bool set_overflowed(extractor_t * pex)
+/**
+ * Return the position, within \p set, of the Parse_choice element
+ * whose share of the set's linkages contains \p index, i.e. the first
+ * one whose running count sum is greater than \p index.
+ */
+static unsigned int find_choice(const extractor_t *pex, const Parse_set *set,
+                                w_count_t index)
 {
-	unsigned int i;
+	const w_count_t *cum_count = &pex->cum_count[set->choice_index];
+	unsigned int lo = 0, hi = set->num_pc - 1;
 
-	assert(pex->x_table != NULL, "called set_overflowed with x_table==NULL");
-	for (i=0; i<pex->x_table_size; i++)
+	while (lo < hi)
 	{
-		Pset_bucket *t;
-		for (t = pex->x_table[i]; t != NULL; t = t->next)
-		{
-			if (set_node_overflowed(&t->set)) return true;
-		}
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (cum_count[mid] > index)
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
-	return false;
+	return lo;
 }
 
 /**
@@ -786,12 +876,21 @@ bool build_parse_set(extractor_t* pex, Sentence sent,
 {
 	pex->words = sent->word;
 	pex->islands_ok = opts->islands_ok;
+	pex->resources = opts->resources;
 
 	pex->parse_set =
 		mk_parse_set(mchxt, ctxt, -1,
 		             -1, sent->length, NULL, NULL, null_count+1, pex);
 
-	return set_overflowed(pex);
+	if (pex->exhausted)
+	{
+		/* The parse set is incomplete, so no linkage can be extracted. */
+		pex->parse_set = NULL;
+		sent->num_linkages_found = 0;
+		return false;
+	}
+
+	return index_choices(pex);
 }
 
 static Connector *get_tracon_by_id(const Disjunct *d, int32_t tracon_id,
@@ -900,8 +999,9 @@ static void issue_links_for_choice(Linkage lkg, Parse_choice *pc,
  *
  * The linkage paths of of a Parse_set element are distributed between its
  * Parse_choice elements, each has its share ((S0ₘ * S1ₘ) for the m'th
- * element). We scan these Parse_choice elements until we find the element
- * that corresponds to \p index. A new index (called Nindex below) is
+ * element). We binary-search the running sums of these shares (see
+ * index_choices()) for the element that corresponds to \p index, so the
+ * selection takes O(log k) steps. A new index (called Nindex below) is
  * computed, which has the property of ranging between 0 and
  * (S0ₘ * S1ₘ)-1. It is used to further select a path in the selected
  * Parse_choice element m. To that end we need to use its S0 and S1
@@ -911,42 +1011,52 @@ static void issue_links_for_choice(Linkage lkg, Parse_choice *pc,
  * For S0: (Nindex % pc->set[0]->count) ranges from 0 to (S0ₘ-1).
  * For S1: (Nindex / pc->set[0]->count) ranges from 0 to (S1ₘ-1).
  */
-static void list_links(Linkage lkg, Parse_set * set, int index)
+static void list_links(Linkage lkg, const extractor_t *pex,
+                       Parse_set * set, int index)
 {
-	Parse_choice *pc;
-	count_t n; /* No overflow - see extract_links() and process_linkages() */
-
 	assert(set != NULL, "Unexpected NULL Parse_set");
 	if (set->first == NULL) return;
-	for (pc = set->first; pc != NULL; pc = pc->next) {
-		n = pc->set[0]->count * pc->set[1]->count;
-		if (index < n) break;
-		index -= n;
-	}
-	assert(pc != NULL, "walked off the end in list_links");
+
+	/* No overflow - see extract_links() and process_linkages() */
+	unsigned int m = find_choice(pex, set, index);
+	assert(index < pex->cum_count[set->choice_index + m],
+	       "walked off the end in list_links");
+	if (m > 0) index -= (int)pex->cum_count[set->choice_index + m - 1];
+
+	Parse_choice *pc = pex->choice[set->choice_index + m];
 	issue_links_for_choice(lkg, pc, set);
 
-	list_links(lkg, pc->set[0], index % pc->set[0]->count);
-	list_links(lkg, pc->set[1], index / pc->set[0]->count);
+	list_links(lkg, pex, pc->set[0], index % pc->set[0]->count);
+	list_links(lkg, pex, pc->set[1], index / pc->set[0]->count);
 }
 
-static void list_random_links(Linkage lkg, unsigned int *rand_state,
-                              Parse_set * set)
+/**
+ * Construct a random linkage into \p lkg. Each Parse_choice element is
+ * selected with a probability proportional to its share of the linkages
+ * of its Parse_set, so all the linkages are equally likely (up to count
+ * clamping, see index_choices()).
+ */
+static void list_random_links(Linkage lkg, const extractor_t *pex,
+                              unsigned int *rand_state, Parse_set * set)
 {
 	assert(set != NULL, "Unexpected NULL Parse_set");
 	if (set->first == NULL) return;
 
 	/* Avoid calling rand_r() for the common case of a single element. */
-	unsigned int new_index = (set->num_pc == 1) ? 0 :
-		rand_r(rand_state) % set->num_pc;
-
-	Parse_choice *pc;
-	for (pc = set->first; new_index > 0; pc = pc->next)
-		new_index--;
+	unsigned int m = 0;
+	if (set->num_pc > 1)
+	{
+		/* The total may exceed RAND_MAX; use two rand_r() calls. */
+		w_count_t total = pex->cum_count[set->choice_index + set->num_pc - 1];
+		w_count_t r = (w_count_t)rand_r(rand_state) * ((w_count_t)RAND_MAX + 1);
+		r += rand_r(rand_state);
+		m = find_choice(pex, set, r % total);
+	}
 
+	Parse_choice *pc = pex->choice[set->choice_index + m];
 	issue_links_for_choice(lkg, pc, set);
-	list_random_links(lkg, rand_state, pc->set[0]);
-	list_random_links(lkg, rand_state, pc->set[1]);
+	list_random_links(lkg, pex, rand_state, pc->set[0]);
+	list_random_links(lkg, pex, rand_state, pc->set[1]);
 }
 
 /**
@@ -962,15 +1072,178 @@ void extract_links(extractor_t * pex, Linkage lkg)
 		bool repeatable = false;
 		if (0 == pex->rand_state) repeatable = true;
 		if (repeatable) pex->rand_state = index;
-		list_random_links(lkg, &pex->rand_state, pex->parse_set);
+		list_random_links(lkg, pex, &pex->rand_state, pex->parse_set);
 		if (repeatable)
 			pex->rand_state = 0;
 		else
 			lkg->sent->rand_state = pex->rand_state;
 	}
 	else {
-		list_links(lkg, pex->parse_set, index);
+		list_links(lkg, pex, pex->parse_set, index);
+	}
+}
+
+/* ================================================================ */
+
+/* State of build_forest(). The node IDs of the Parse_set elements are
+ * kept in an open-addressing hash table, keyed by the set address. */
+typedef struct
+{
+	const extractor_t *pex;
+	Forest forest;
+	const Parse_set **set_key;
+	unsigned int *set_id;
+	size_t set_table_mask;
+	unsigned int *disjunct_id;         /* By disjunct position in dc_memblock */
+	const Disjunct *dc_memblock;
+	Sentence sent;
+} forest_builder;
+
+static size_t set_slot(const forest_builder *fb, const Parse_set *set)
+{
+	size_t i = (size_t)(((uintptr_t)set >> 3) * 0x9E3779B97F4A7C15ULL);
+	i = (i ^ (i >> 29)) & fb->set_table_mask;
+	while ((NULL != fb->set_key[i]) && (set != fb->set_key[i]))
+		i = (i + 1) & fb->set_table_mask;
+	return i;
+}
+
+static unsigned int forest_disjunct(forest_builder *fb, const Disjunct *d)
+{
+	size_t dpos = d - fb->dc_memblock;
+	assert(dpos < fb->sent->num_disjuncts, "Disjunct not in dc_memblock");
+	if (UINT_MAX != fb->disjunct_id[dpos]) return fb->disjunct_id[dpos];
+
+	Forest forest = fb->forest;
+	Forest_disjunct *fd = &forest->disjunct[forest->num_disjuncts];
+
+	char *str = print_one_disjunct_str(d);
+	size_t len = strlen(str);
+	if ((len > 0) && (' ' == str[len-1])) str[len-1] = '\0';
+	fd->str = string_set_add(str, fb->sent->string_set);
+	free(str);
+
+	if (d->is_category != 0)
+	{
+		fd->word_string = NULL;
+		fd->cost = d->category[0].cost;
+	}
+	else
+	{
+		char *word = strdupa(d->word_string);
+		patch_subscript_mark(word);
+		fd->word_string = string_set_add(word, fb->sent->string_set);
+		fd->cost = d->cost;
 	}
+
+	fb->disjunct_id[dpos] = (unsigned int)forest->num_disjuncts;
+	return (unsigned int)forest->num_disjuncts++;
+}
+
+/**
+ * Add \p set and (first) all the sets reachable from it to the forest.
+ * Return its node ID.
+ */
+static unsigned int forest_node(forest_builder *fb, const Parse_set *set)
+{
+	size_t slot = set_slot(fb, set);
+	if (NULL != fb->set_key[slot]) return fb->set_id[slot];
+
+	const extractor_t *pex = fb->pex;
+	Parse_choice **choice = &pex->choice[set->choice_index];
+
+	for (unsigned int m = 0; m < set->num_pc; m++)
+	{
+		forest_node(fb, choice[m]->set[0]);
+		forest_node(fb, choice[m]->set[1]);
+	}
+
+	Forest forest = fb->forest;
+	lg_forest_node *fn = &forest->node[forest->num_nodes];
+	fn->first_choice = (unsigned int)forest->num_choices;
+	fn->num_choices = set->num_pc;
+	fn->count = set->count;
+	fn->lw = (set->lw == (uint8_t)-1) ? -1 : set->lw;
+	fn->rw = set->rw;
+
+	for (unsigned int m = 0; m < set->num_pc; m++)
+	{
+		Parse_choice *pc = choice[m];
+		lg_forest_choice *fc = &forest->choice[forest->num_choices++];
+
+		fc->child[0] = fb->set_id[set_slot(fb, pc->set[0])];
+		fc->child[1] = fb->set_id[set_slot(fb, pc->set[1])];
+		fc->disjunct = (NULL == pc->md) ?
+			LG_FOREST_NULL_WORD : forest_disjunct(fb, pc->md);
+		fc->word = pc->set[0]->rw;
+
+		/* The same conditions as in issue_link(). */
+		fc->links = 0;
+		if (!is_zero_tracon(set->le) &&
+		    !is_zero_tracon(get_tracon_by_id(pc->md, pc->l_id, 0)))
+			fc->links |= LG_FOREST_LEFT_LINK;
+		if (!is_zero_tracon(get_tracon_by_id(pc->md, pc->r_id, 1)) &&
+		    !is_zero_tracon(set->re))
+			fc->links |= LG_FOREST_RIGHT_LINK;
+	}
+
+	/* do_count() counts the position before the left wall like a null
+	 * word (see do_parse()). The dummy sets of the choices that skip a
+	 * null word or start an island are not given a null count. */
+	if (fn->lw + 1 == fn->rw)
+		fn->null_count = 0;
+	else
+		fn->null_count = set->null_count - ((-1 == fn->lw) ? 1 : 0);
+
+	/* The set's slot may have been taken by a child; look it up again. */
+	slot = set_slot(fb, set);
+	fb->set_key[slot] = set;
+	fb->set_id[slot] = (unsigned int)forest->num_nodes;
+	return (unsigned int)forest->num_nodes++;
+}
+
+/**
+ * Export the parse set as a packed parse forest (see link-includes.h).
+ * The nodes are the Parse_set elements that are reachable from the
+ * top-level one, in post-order, and their choices are the Parse_choice
+ * elements in the order used by list_links().
+ */
+Forest build_forest(extractor_t *pex, Sentence sent)
+{
+	if (NULL == pex->parse_set) return NULL;
+
+	size_t num_sets = pool_num_elements_issued(pex->Pset_bucket_pool);
+	size_t table_size = 1;
+	while (table_size < 2 * num_sets) table_size <<= 1;
+
+	Forest forest = malloc(sizeof(struct Forest_s));
+	forest->node = malloc(num_sets * sizeof(lg_forest_node));
+	forest->choice = malloc(pex->num_choices * sizeof(lg_forest_choice));
+	forest->disjunct = malloc(sent->num_disjuncts * sizeof(Forest_disjunct));
+	forest->num_nodes = 0;
+	forest->num_choices = 0;
+	forest->num_disjuncts = 0;
+
+	forest_builder fb =
+	{
+		.pex = pex,
+		.forest = forest,
+		.set_key = calloc(table_size, sizeof(Parse_set *)),
+		.set_id = malloc(table_size * sizeof(unsigned int)),
+		.set_table_mask = table_size - 1,
+		.disjunct_id = malloc(sent->num_disjuncts * sizeof(unsigned int)),
+		.dc_memblock = sent->dc_memblock,
+		.sent = sent,
+	};
+	memset(fb.disjunct_id, 0xff, sent->num_disjuncts * sizeof(unsigned int));
+
+	forest_node(&fb, pex->parse_set);
+
+	free(fb.set_key);
+	free(fb.set_id);
+	free(fb.disjunct_id);
+
+	return forest;
 }
 
 static void mark_used_disjunct(Parse_set *set, bool *disjunct_used)
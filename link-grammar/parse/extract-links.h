@@ -29,6 +29,8 @@ void extract_links(extractor_t*, Linkage);
 
 void mark_used_disjuncts(extractor_t *, bool *);
 
+Forest build_forest(extractor_t *, Sentence);
+
 // Uncomment to enable graphviz display of parse choice
 // #define PC_DISPLAY
 #ifdef PC_DISPLAY
@@ -53,20 +53,19 @@
 #endif /* ML_COMPAT */
 
 /*
- * Each lookup table entry points to list of disjuncts whose shallow
+ * Each lookup table entry refers to a list of disjuncts whose shallow
  * connector has the same uppercase part. These lists are sorted according
  * to the nearest_word of these connectors. The sorting is done using
  * "bucket sort" in which the number of bins is equal to the different
  * number of values of nearest word so only one sorting round is needed.
+ *
+ * The lists are stored as consecutive Match_nodes in one array, and the
+ * disjuncts are referred by their 32-bit index in the sentence disjunct
+ * memory block (dc_memblock). The Match_node also holds a copy of the
+ * nearest_word and farthest_word of the shallow connector, so scanning
+ * a list in form_match_list() doesn't need to access the disjuncts that
+ * are out of the word range.
  */
-typedef struct sortbin_s sortbin;
-struct sortbin_s
-{
-	Match_node *head;
-#if ML_COMPAT
-	Match_node *tail;
-#endif
-};
 
 /**
  * Push a match-list element into the match-list array.
@@ -94,138 +93,145 @@ void free_fast_matcher(Sentence sent, fast_matcher_t *mchxt)
 	if (NULL == mchxt) return;
 
 	free(mchxt->l_table[0]);
+	free(mchxt->match_node);
 	xfree(mchxt->match_list, mchxt->match_list_size * sizeof(*mchxt->match_list));
 	lgdebug(+6, "Sentence length %zu, match_list_size %zu\n",
 	        mchxt->size, mchxt->match_list_size);
 
 	xfree(mchxt->l_table_size, mchxt->size * sizeof(unsigned int));
-	xfree(mchxt->l_table, mchxt->size * sizeof(Match_node **));
+	xfree(mchxt->l_table, mchxt->size * sizeof(Match_table_entry *));
 	xfree(mchxt, sizeof(fast_matcher_t));
 }
 
-static Match_node *match_list_not_found = NULL;
+static const Match_table_entry match_list_not_found; /* An empty list */
 
-static Match_node **get_match_table_entry(unsigned int size, Match_node **t,
-                                          Connector * c, int dir)
+static const Match_table_entry *
+get_match_table_entry(unsigned int size, const Match_table_entry *t,
+                      unsigned int uc_num)
 {
 	unsigned int h, s;
-	s = h = connector_uc_hash(c) & (size-1);
+	s = h = uc_num & (size-1);
 
-	if (dir == 1) {
-		while (NULL != t[h])
-		{
-			if (connector_uc_eq(t[h]->d->right, c)) break;
-
-			/* Increment and try again. Every hash bucket MUST have
-			 * a unique upper-case part, since later on, we only
-			 * compare the lower-case parts, assuming upper-case
-			 * parts are already equal. So just look for the next
-			 * unused hash bucket.
-			 */
-			h = (h + 1) & (size-1);
-			if (h == s) return &match_list_not_found;
-		}
-	}
-	else
+	while (0 != t[h].count)
 	{
-		while (NULL != t[h])
-		{
-			if (connector_uc_eq(t[h]->d->left, c)) break;
-			h = (h + 1) & (size-1);
-			if (h == s) return &match_list_not_found;
-		}
+		if (t[h].uc_num == uc_num) break;
+
+		/* Increment and try again. Every hash bucket MUST have
+		 * a unique upper-case part, since later on, we only
+		 * compare the lower-case parts, assuming upper-case
+		 * parts are already equal. So just look for the next
+		 * unused hash bucket.
+		 */
+		h = (h + 1) & (size-1);
+		if (h == s) return &match_list_not_found;
 	}
 
 	return &t[h];
 }
 
 /**
- * Add the match nodes at sbin to the table entry of their shallow connector.
- */
-static void add_to_table_entry(unsigned int tsize, Match_node **table,
-                               int dir, sortbin *sbin)
-{
-	Match_node *m_next;
-	for (Match_node *m = sbin->head; NULL != m; m = m_next)
-	{
-		Connector *c = (0 == dir) ? m->d->left : m->d->right;
-		assert(NULL != c, "NULL connector");
-
-		Match_node **xl = get_match_table_entry(tsize, table, c, dir);
-		assert(&match_list_not_found != xl, "get_match_table_entry: Overflow");
-
-		m_next = m->next; /* Remember before overwriting. */
-
-		/* Insert m at head of list */
-		m->next = *xl;
-		*xl = m;
-	}
-}
-
-/**
- * Put the nearest_word-sorted disjuncts at sbin into the given hash table.
- * Since add_to_table_entry() inserts at entry's head, insert in the
- * reverse order than the needed match-list order of nearest_word.
+ * Put the Match_nodes of the disjuncts of word \p w that have a
+ * connector in direction \p dir into the given hash table.
+ *
+ * The Match_nodes are first sorted by their nearest_word (a bucket sort,
+ * using the per-nearest_word counts in \p nwbin), and then distributed,
+ * keeping this order, to consecutive locations per table entry in the
+ * Match_node array, starting at \p mn.
  *
  * @param tsize The hash table size.
  * @param table The hash table.
- * @param w The word to which these disjuncts belong.
- * @param dir 0: Put it into a right table; 1: Put it  into a left table.
- * @param sbin Indexed by the disjuncts' shallow-connector nearest_word.
- * @param sent_length Sentence length, for sbin index upper bound.
+ * @param dir 0: Put it into a left table; 1: Put it into a right table.
+ * @param nwbin Scratch array, indexed by nearest_word.
+ * @param sorted Scratch array for the sorted Match_nodes.
+ * @return The number of Match_nodes.
  */
-static void put_into_match_table(unsigned int tsize, Match_node **table,
-                                 int w, int dir, sortbin *sbin,
-                                 size_t sent_length)
+static size_t put_into_match_table(fast_matcher_t *ctxt, Sentence sent,
+                                   WordIdx w, int dir,
+                                   unsigned int tsize, Match_table_entry *table,
+                                   Match_node *mn,
+                                   unsigned int *nwbin, Match_node *sorted)
 {
-	if (0 == dir)
+	size_t n = 0;
+
+	memset(nwbin, 0, sent->length * sizeof(*nwbin));
+	for (Disjunct *d = sent->word[w].d; NULL != d; d = d->next)
 	{
-		/* Left match-list needed order: Increasing nearest_word. */
-		for (WordIdx sbw = 0; sbw < (WordIdx)w; sbw++)
-		{
-			add_to_table_entry(tsize, table, dir, &sbin[sbw]);
-		}
+		Connector *c = (0 == dir) ? d->left : d->right;
+		if (NULL == c) continue;
+
+		nwbin[c->nearest_word]++;
+		n++;
 	}
-	else
+	if (0 == n) return 0;
+
+	/* Convert the bin counts to bin positions, in the needed match-list
+	 * order of nearest_word.
+	 * Left match-list: Decreasing nearest_word.
+	 * Right match-list: Increasing nearest_word. */
+	size_t pos = 0;
+	for (WordIdx i = 0; i < sent->length; i++)
 	{
-		/* Right match-list needed order: Decreasing nearest_word. */
-		for (WordIdx sbw = sent_length-1; sbw > (WordIdx)w; sbw--)
-		{
-			add_to_table_entry(tsize, table, dir, &sbin[sbw]);
-		}
+		WordIdx nw = (0 == dir) ? sent->length - 1 - i : i;
+		unsigned int bin_size = nwbin[nw];
+
+#if ML_COMPAT
+		pos += bin_size;
+		nwbin[nw] = pos; /* Filled backward. */
+#else
+		nwbin[nw] = pos;
+		pos += bin_size;
+#endif
 	}
-}
 
-static void clean_sortbin(sortbin *sbin, size_t sent_length)
-{
-	for (unsigned int i = 0; i < sent_length; i++)
-				sbin[i].head = NULL;
-}
+	for (Disjunct *d = sent->word[w].d; NULL != d; d = d->next)
+	{
+		Connector *c = (0 == dir) ? d->left : d->right;
+		if (NULL == c) continue;
 
-/**
- * Put the Match_node m into a list according to nearest_word.
- * This is a bucket sort.
- */
-static void sort_by_nearest_word(Match_node *m, sortbin *sbin, int nearest_word)
-{
+#if ML_COMPAT
+		Match_node *m = &sorted[--nwbin[c->nearest_word]];
+#else
+		Match_node *m = &sorted[nwbin[c->nearest_word]++];
+#endif
+		m->d = (uint32_t)(d - ctxt->dblock_base);
+		m->nearest_word = c->nearest_word;
+		m->farthest_word = c->farthest_word;
+	}
 
-	sbin = &sbin[nearest_word]; /* Bucket selection. */
+	/* Count the Match_nodes per table entry. */
+	for (size_t i = 0; i < n; i++)
+	{
+		Connector *c = (0 == dir) ? ctxt->dblock_base[sorted[i].d].left :
+		                            ctxt->dblock_base[sorted[i].d].right;
+		Match_table_entry *e = (Match_table_entry *)
+			get_match_table_entry(tsize, table, connector_uc_num(c));
+		assert(&match_list_not_found != e, "get_match_table_entry: Overflow");
+
+		e->uc_num = connector_uc_num(c);
+		e->count++;
+	}
 
-#if ML_COMPAT
-	if (NULL == sbin->head)
+	/* Assign the table entries their Match_node array ranges. The "first"
+	 * field initially points past the end of the range, because the
+	 * Match_nodes are then inserted backward. */
+	size_t mn_pos = (size_t)(mn - ctxt->match_node);
+	for (unsigned int h = 0; h < tsize; h++)
 	{
-		sbin->head = m;
+		mn_pos += table[h].count;
+		table[h].first = (uint32_t)mn_pos;
 	}
-	else
+
+	for (size_t i = n; i-- > 0; )
 	{
-		sbin->tail->next = m;
+		Connector *c = (0 == dir) ? ctxt->dblock_base[sorted[i].d].left :
+		                            ctxt->dblock_base[sorted[i].d].right;
+		Match_table_entry *e = (Match_table_entry *)
+			get_match_table_entry(tsize, table, connector_uc_num(c));
+
+		ctxt->match_node[--e->first] = sorted[i];
 	}
-	sbin->tail = m;
-	m->next = NULL;
-#else
-	m->next = sbin->head;
-	sbin->head = m;
-#endif
+
+	return n;
 }
 
 fast_matcher_t* alloc_fast_matcher(const Sentence sent, unsigned int *ncu[])
@@ -238,35 +244,35 @@ fast_matcher_t* alloc_fast_matcher(const Sentence sent, unsigned int *ncu[])
 	ctxt->size = sent->length;
 	ctxt->l_table_size = xalloc(2 * sent->length * sizeof(unsigned int));
 	ctxt->r_table_size = ctxt->l_table_size + sent->length;
-	ctxt->l_table = xalloc(2 * sent->length * sizeof(Match_node **));
+	ctxt->l_table = xalloc(2 * sent->length * sizeof(Match_table_entry *));
 	ctxt->r_table = ctxt->l_table + sent->length;
-	memset(ctxt->l_table, 0, 2 * sent->length * sizeof(Match_node **));
+	memset(ctxt->l_table, 0, 2 * sent->length * sizeof(Match_table_entry *));
 
 	ctxt->match_list_size = MATCH_LIST_SIZE_INIT;
 	ctxt->match_list = xalloc(ctxt->match_list_size * sizeof(*ctxt->match_list));
 	ctxt->match_list_end = 0;
 
-	if (NULL != sent->Match_node_pool)
-	{
-		pool_reuse(sent->Match_node_pool);
-	}
-	else
-	{
-		sent->Match_node_pool =
-			pool_new(__func__, "Match_node",
-			         /*num_elements*/2048, sizeof(Match_node),
-			         /*zero_out*/false, /*align*/true, /*exact*/false);
-	}
-
-	sortbin *sbin = alloca(sent->length * sizeof(sortbin));
+	/* The disjuncts are packed in dc_memblock (see pack_sentence()). */
+	ctxt->dblock_base = sent->dc_memblock;
 
-	/* Calculate the sizes of the hash tables. */
+	/* Calculate the sizes of the hash tables, and the number of
+	 * Match_nodes (needed for each connector-side of each disjunct). */
 	unsigned int num_headers = 0;
-	Match_node **memblock_headers;
-	Match_node **hash_table_header;
+	size_t num_match_nodes = 0;
+	size_t max_word_match_nodes = 0;
+	Match_table_entry *memblock_headers;
+	Match_table_entry *hash_table_header;
 
 	for (WordIdx w = 0; w < sent->length; w++)
 	{
+		size_t word_match_nodes[2] = { 0 };
+
+		for (Disjunct *d = sent->word[w].d; NULL != d; d = d->next)
+		{
+			word_match_nodes[0] += (d->left != NULL);
+			word_match_nodes[1] += (d->right != NULL);
+		}
+
 		for (int dir = 0; dir < 2; dir++)
 		{
 			unsigned int tsize;
@@ -283,48 +289,33 @@ fast_matcher_t* alloc_fast_matcher(const Sentence sent, unsigned int *ncu[])
 
 			ncu[dir][w] = tsize;
 			num_headers += tsize;
+
+			num_match_nodes += word_match_nodes[dir];
+			if (word_match_nodes[dir] > max_word_match_nodes)
+				max_word_match_nodes = word_match_nodes[dir];
 		}
 	}
 
-	memblock_headers = malloc(num_headers * sizeof(Match_node *));
-	memset(memblock_headers, 0, num_headers * sizeof(Match_node *));
+	memblock_headers = malloc(num_headers * sizeof(Match_table_entry));
+	memset(memblock_headers, 0, num_headers * sizeof(Match_table_entry));
 	hash_table_header = memblock_headers;
 
+	ctxt->match_node = malloc(num_match_nodes * sizeof(Match_node));
+	Match_node *mn = ctxt->match_node;
+
+	unsigned int *nwbin = alloca(sent->length * sizeof(*nwbin));
+	Match_node *sorted = malloc(max_word_match_nodes * sizeof(Match_node));
+
 	for (WordIdx w = 0; w < sent->length; w++)
 	{
-		clean_sortbin(sbin, sent->length);
-
-		/* Sort the disjuncts of each word according to the nearest word
-		 * that their left and right shallow connectors can connect to.
-		 * For performance of the parsing stage, the loop over
-		 * the disjuncts is done separately for the left and right
-		 * connectors, so the Match_node memory of consequent disjuncts in
-		 * the match lists will be adjacent in memory (a noticeable
-		 * speedup due to a better use of the CPU cache). */
-		for (Disjunct *d = sent->word[w].d; NULL != d; d = d->next)
-		{
-			if (d->left != NULL)
-			{
-				Match_node *m = pool_alloc(sent->Match_node_pool);
-				m->d = d;
-				sort_by_nearest_word(m, sbin, d->left->nearest_word);
-			}
-		}
-		for (Disjunct *d = sent->word[w].d; NULL != d; d = d->next)
-		{
-			if (d->right != NULL)
-			{
-				Match_node *m = pool_alloc(sent->Match_node_pool);
-				m->d = d;
-				sort_by_nearest_word(m, sbin, d->right->nearest_word);
-			}
-		}
-
-		/* Build the hash tables. */
+		/* Build the hash tables.
+		 * For performance of the parsing stage, this is done separately
+		 * for the left and right connectors, so the Match_nodes of each
+		 * match list are adjacent in memory. */
 		for (int dir = 0; dir < 2; dir++)
 		{
 			unsigned int tsize = ncu[dir][w];
-			Match_node **t = hash_table_header;
+			Match_table_entry *t = hash_table_header;
 
 			hash_table_header += tsize;
 
@@ -339,12 +330,17 @@ fast_matcher_t* alloc_fast_matcher(const Sentence sent, unsigned int *ncu[])
 				ctxt->r_table_size[w] = tsize;
 			}
 
-			put_into_match_table(tsize, t, w, dir, sbin, sent->length);
+			mn += put_into_match_table(ctxt, sent, w, dir, tsize, t, mn,
+			                           nwbin, sorted);
 		}
 	}
 
+	free(sorted);
+
 	assert(memblock_headers + num_headers == hash_table_header,
 	   "Mismatch header sizes");
+	assert(ctxt->match_node + num_match_nodes == mn,
+	   "Mismatch number of match nodes");
 	return ctxt;
 }
 
@@ -356,8 +352,6 @@ fast_matcher_t* alloc_fast_matcher(const Sentence sent, unsigned int *ncu[])
  */
 static void match_stats(Connector *c1, Connector *c2)
 {
-	if (NULL == c1) printf("match_stats: cache\n");
-	if (NULL == c2) return;
 	if ((1 == c1->uc_start) && (1 == c2->uc_start) &&
 	    (c1->string[0] == c2->string[0]))
 	{
@@ -438,9 +432,7 @@ typedef struct
  */
 static bool do_match_with_cache(Connector *a, Connector *b, match_cache *c_con)
 {
-	/* The following uses a string-set compare - string_set_cmp() cannot
-	 * be used here because c_con->string may be NULL. */
-	match_stats(c_con->string == a->string ? NULL : a, NULL);
+	match_stats(a, b);
 	UNREACHABLE(connector_desc(a) == NULL); // clang static analyzer suppression.
 	if (c_con->desc == connector_desc(a))
 	{
@@ -516,6 +508,29 @@ static bool alt_connection_possible(Connector *c1, Connector *c2,
 	return same_alternative;
 }
 
+/**
+ * Return the list of the Match_nodes of the table entry of connector
+ * \p c, or NULL if there is none. Its end is returned in \p end.
+ */
+static const Match_node *get_match_table_list(fast_matcher_t *ctxt,
+                                              unsigned int size,
+                                              const Match_table_entry *t,
+                                              Connector *c,
+                                              const Match_node **end)
+{
+	const Match_table_entry *e =
+		get_match_table_entry(size, t, connector_uc_num(c));
+
+	if (0 == e->count) return NULL;
+	*end = &ctxt->match_node[e->first + e->count];
+	return &ctxt->match_node[e->first];
+}
+
+static inline Disjunct *get_disjunct(fast_matcher_t *ctxt, const Match_node *m)
+{
+	return &ctxt->dblock_base[m->d];
+}
+
 /**
  * Add match-list termination element (NULL).
  * Optionally print it (for debug).
@@ -562,9 +577,10 @@ form_match_list(fast_matcher_t *ctxt, int w,
                 Connector *rc, int rw,
                 match_list_cache *mlcl, match_list_cache *mlcr)
 {
-	Match_node *mx, *mr_end;
+	const Match_node *mx;
 	size_t front = get_match_list_position(ctxt);
-	Match_node *ml = NULL, *mr = NULL; /* Initialize in case of NULL lc or rc. */
+	/* Initialize in case of NULL lc or rc. */
+	const Match_node *ml = NULL, *ml_end = NULL, *mr = NULL, *mr_end = NULL;
 	match_list_cache *cmx;
 	match_cache mc;
 	gword_cache gc = { .same_alternative = false };
@@ -578,7 +594,8 @@ form_match_list(fast_matcher_t *ctxt, int w,
 		 * callers and is left here for documentation. */
 		if ((lc != NULL) /* && (w <= lc->farthest_word) */)
 		{
-			ml = *get_match_table_entry(ctxt->l_table_size[w], ctxt->l_table[w], lc, 0);
+			ml = get_match_table_list(ctxt, ctxt->l_table_size[w], ctxt->l_table[w],
+			                          lc, &ml_end);
 		}
 		if ((lc != NULL) && (ml == NULL)) /* lc optimization */
 			return terminate_match_list(ctxt, -1, front, w, lc, lw, rc, rw, mlcl, mlcr);
@@ -588,7 +605,8 @@ form_match_list(fast_matcher_t *ctxt, int w,
 	{
 		if ((rc != NULL) && (w >= rc->farthest_word))
 		{
-			mr = *get_match_table_entry(ctxt->r_table_size[w], ctxt->r_table[w], rc, 1);
+			mr = get_match_table_list(ctxt, ctxt->r_table_size[w], ctxt->r_table[w],
+			                          rc, &mr_end);
 		}
 		if ((ml == NULL) && (mlcl == NULL) && (mr == NULL))
 			return terminate_match_list(ctxt, -2, front, w, lc, lw, rc, rw, mlcl, mlcr);
@@ -606,10 +624,10 @@ form_match_list(fast_matcher_t *ctxt, int w,
 
 	if (mlcr == NULL)
 	{
-		for (mx = mr; mx != NULL; mx = mx->next)
+		for (mx = mr; mx != mr_end; mx++)
 		{
-			if (mx->d->right->nearest_word > rw) break;
-			mx->d->match_left = false;
+			if (mx->nearest_word > rw) break;
+			get_disjunct(ctxt, mx)->match_left = false;
 		}
 		mr_end = mx;
 	}
@@ -619,7 +637,6 @@ form_match_list(fast_matcher_t *ctxt, int w,
 		{
 			cmx->d->match_left = false;
 		}
-		mr_end = NULL; /* Prevent a gcc "may be uninitialized" warning */
 	}
 
 	/* Construct the list of things that could match the left. */
@@ -628,17 +645,18 @@ form_match_list(fast_matcher_t *ctxt, int w,
 		mc.desc = NULL;
 		gc.gword = NULL;
 
-		for (mx = ml; mx != NULL; mx = mx->next)
+		for (mx = ml; mx != ml_end; mx++)
 		{
-			if (mx->d->left->nearest_word < lw) break;
-			if (lw < mx->d->left->farthest_word) continue;
+			if (mx->nearest_word < lw) break;
+			if (lw < mx->farthest_word) continue;
 
-			mx->d->match_left = do_match_with_cache(mx->d->left, lc, &mc) &&
-			                    alt_connection_possible(mx->d->left, lc, &gc);
-			if (!mx->d->match_left) continue;
-			mx->d->match_right = false;
+			Disjunct *d = get_disjunct(ctxt, mx);
+			d->match_left = do_match_with_cache(d->left, lc, &mc) &&
+			                alt_connection_possible(d->left, lc, &gc);
+			if (!d->match_left) continue;
+			d->match_right = false;
 
-			push_match_list_element(ctxt, lid, mx->d);
+			push_match_list_element(ctxt, lid, d);
 		}
 
 		if ((lc != NULL) && is_no_match_list(ctxt, front)) /* lc optimization */
@@ -663,16 +681,17 @@ form_match_list(fast_matcher_t *ctxt, int w,
 	{
 		mc.desc = NULL;
 		gc.gword = NULL;
-		for (mx = mr; mx != mr_end; mx = mx->next)
+		for (mx = mr; mx != mr_end; mx++)
 		{
-			if (rw > mx->d->right->farthest_word) continue;
+			if (rw > mx->farthest_word) continue;
 
-			if ((lc != NULL) && !mx->d->match_left) continue; /* lc optimization */
-			mx->d->match_right = do_match_with_cache(mx->d->right, rc, &mc) &&
-			                     alt_connection_possible(mx->d->right, rc, &gc);
-			if (!mx->d->match_right || mx->d->match_left) continue;
+			Disjunct *d = get_disjunct(ctxt, mx);
+			if ((lc != NULL) && !d->match_left) continue; /* lc optimization */
+			d->match_right = do_match_with_cache(d->right, rc, &mc) &&
+			                 alt_connection_possible(d->right, rc, &gc);
+			if (!d->match_right || d->match_left) continue;
 
-			push_match_list_element(ctxt, lid, mx->d);
+			push_match_list_element(ctxt, lid, d);
 		}
 	}
 	else
@@ -26,12 +26,23 @@ typedef struct
 	Count_bin count;             /* the counts for that linkage */
 } match_list_cache;
 
-typedef struct Match_node_struct Match_node;
-struct Match_node_struct
+/* A match-list element. The disjunct is referred to by its index in the
+ * sentence disjunct memory block, and the word range of its shallow
+ * connector is copied here for a faster match-list scanning. */
+typedef struct
 {
-	Match_node * next;
-	Disjunct * d;
-};
+	uint32_t d;                  /* Disjunct index in dc_memblock */
+	uint8_t nearest_word;        /* Of the shallow connector */
+	uint8_t farthest_word;       /* Of the shallow connector */
+} Match_node;
+
+/* A match-table entry: A match-list in the Match_node array. */
+typedef struct
+{
+	uint32_t uc_num;             /* Of the shallow connectors */
+	uint32_t first;              /* Index of the first Match_node */
+	uint32_t count;              /* Number of Match_nodes (0: unused entry) */
+} Match_table_entry;
 
 typedef struct fast_matcher_s fast_matcher_t;
 struct fast_matcher_s
@@ -41,8 +52,11 @@ struct fast_matcher_s
 	unsigned int *r_table_size;
 
 	/* the beginnings of the hash tables */
-	Match_node *** l_table;
-	Match_node *** r_table;
+	Match_table_entry ** l_table;
+	Match_table_entry ** r_table;
+
+	Match_node *match_node;      /* The match-lists of all the tables */
+	Disjunct *dblock_base;       /* For Match_node disjunct index */
 
 	/* I'll pedantically maintain my own array of these cells */
 	Disjunct ** match_list;      /* match-list stack */
@@ -0,0 +1,91 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include "api-structures.h"
+#include "forest.h"
+
+/**
+ * The packed parse forest is built from the parse set by build_forest()
+ * (in extract-links.c), when the "keep_forest" parse option is set.
+ * It is owned by the sentence, and stays valid until the sentence is
+ * parsed again or deleted.
+ */
+
+void free_forest(Forest forest)
+{
+	if (NULL == forest) return;
+
+	free(forest->node);
+	free(forest->choice);
+	free(forest->disjunct);
+	free(forest);
+}
+
+/**
+ * Return the packed parse forest of the last parse of \p sent, or NULL
+ * if it was not kept (see parse_options_set_keep_forest()) or the
+ * sentence has no linkages. It encodes the linkages found at
+ * sentence_null_count(), including the ones with P.P. violations.
+ */
+Forest sentence_get_forest(Sentence sent)
+{
+	if ((NULL == sent) || (sent->num_linkages_found <= 0)) return NULL;
+	return sent->forest;
+}
+
+size_t forest_num_nodes(Forest forest)
+{
+	return forest->num_nodes;
+}
+
+const lg_forest_node * forest_get_nodes(Forest forest)
+{
+	return forest->node;
+}
+
+size_t forest_num_choices(Forest forest)
+{
+	return forest->num_choices;
+}
+
+const lg_forest_choice * forest_get_choices(Forest forest)
+{
+	return forest->choice;
+}
+
+size_t forest_num_disjuncts(Forest forest)
+{
+	return forest->num_disjuncts;
+}
+
+/**
+ * Return the connectors of the disjunct, e.g. "Wd- Ss+ @MX+".
+ */
+const char * forest_get_disjunct_str(Forest forest, size_t index)
+{
+	if (forest->num_disjuncts <= index) return NULL;
+	return forest->disjunct[index].str;
+}
+
+/**
+ * Return the subscripted dictionary word of the disjunct, e.g. "dog.n".
+ */
+const char * forest_get_disjunct_word(Forest forest, size_t index)
+{
+	if (forest->num_disjuncts <= index) return NULL;
+	return forest->disjunct[index].word_string;
+}
+
+float forest_get_disjunct_cost(Forest forest, size_t index)
+{
+	if (forest->num_disjuncts <= index) return 0.0f;
+	return forest->disjunct[index].cost;
+}
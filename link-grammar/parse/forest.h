@@ -0,0 +1,35 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _FOREST_H
+#define _FOREST_H
+
+#include "link-includes.h"
+
+typedef struct
+{
+	const char *str;          /* Its connectors, in the sentence string-set */
+	const char *word_string;  /* Subscripted dictionary word, or NULL */
+	float cost;
+} Forest_disjunct;
+
+struct Forest_s
+{
+	lg_forest_node *node;
+	size_t num_nodes;
+	lg_forest_choice *choice;
+	size_t num_choices;
+	Forest_disjunct *disjunct;
+	size_t num_disjuncts;
+};
+
+void free_forest(Forest);
+#endif /* _FOREST_H */
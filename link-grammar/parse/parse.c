@@ -18,13 +18,16 @@
 #include "disjunct-utils.h"
 #include "extract-links.h"
 #include "fast-match.h"
+#include "forest.h"
 #include "linkage/analyze-linkage.h"
 #include "linkage/linkage.h"
 #include "linkage/sane.h"
 #include "parse.h"
 #include "post-process/post-process.h"
 #include "preparation.h"
+#include "prepare/reuse-disjuncts.h"   // keep_disjunct_pools
 #include "prune.h"
+#include "prune-cache.h"
 #include "resources.h"
 #include "tokenize/word-structures.h"  // For Word_struct
 
@@ -209,6 +212,8 @@ static void process_linkages(Sentence sent, extractor_t* pex,
 	bool need_init = true;
 	for (itry=0; itry<maxtries; itry++)
 	{
+		if (resources_poll(opts->resources, itry+1, 256)) break;
+
 		Linkage lkg = &sent->lnkages[in];
 		Linkage_info * lifo = &lkg->lifo;
 
@@ -543,6 +548,174 @@ static void notify_no_complete_linkages(unsigned int null_count,
 			prt_error("No complete linkages found.\n");
 }
 
+/**
+ * Return true if the pruning null count optimization of classic_parse()
+ * can be done for \p sent.
+ */
+static bool null_count_pruning(Sentence sent, Parse_Options opts)
+{
+	/* Null-count optimization not implemented for islands_ok==true. */
+	if (opts->islands_ok) return false;
+
+	/* Pruning per null-count and one-step-parse are costly for sentences
+	 * whose parsing takes tens of milliseconds or so. Disable them for
+	 * short-enough sentences. */
+	if (sent->length < sent->min_len_multi_pruning) return false;
+
+	return true;
+}
+
+/**
+ * Return true if classic_parse() prunes the disjuncts of \p sent only
+ * once, so the same pruned disjuncts are used for all the null counts.
+ */
+bool prune_once(Sentence sent, Parse_Options opts)
+{
+	unsigned int max_null_count = opts->max_null_count;
+	max_null_count = (unsigned int)MIN(max_null_count, sent->length);
+
+	if ((unsigned int)opts->min_null_count == max_null_count) return true;
+	return !null_count_pruning(sent, opts) && (opts->min_null_count != 0);
+}
+
+/**
+ * Restore the disjuncts of \p sent as they were before pruning, discard
+ * those whose cost is above \p cost_cutoff, prune them for \p prune_level
+ * nulls and count the linkages at the current null count. The parsing
+ * encoding, fast matcher and count context are replaced accordingly.
+ * @return The number of linkages (0 if the pruning shows there is none
+ * or the resources got exhausted while pruning).
+ */
+static int count_with_cost_cutoff(Sentence sent, Parse_Options opts,
+                                  float cost_cutoff,
+                                  Tracon_sharing *ts_pruning,
+                                  void *saved_memblock, int prune_level,
+                                  unsigned int *ncu[2],
+                                  Tracon_sharing **ts_parsing,
+                                  fast_matcher_t **mchxt,
+                                  count_context_t **ctxt)
+{
+	restore_disjuncts(sent, saved_memblock, ts_pruning);
+	cost_prune(sent, cost_cutoff);
+
+	unsigned int expected_null_count =
+		pp_and_power_prune(sent, ts_pruning, prune_level, opts, ncu);
+	if (resources_exhausted(opts->resources)) return 0;
+	if (expected_null_count > sent->null_count) return 0;
+
+	free_count_context(*ctxt, sent);
+	free_fast_matcher(sent, *mchxt);
+	free_tracon_sharing(*ts_parsing);
+
+	*ts_parsing = pack_sentence_for_parsing(sent);
+	gword_record_in_connector(sent);
+	*mchxt = alloc_fast_matcher(sent, ncu);
+	*ctxt = alloc_count_context(sent, *ts_parsing);
+
+	int num_linkages = do_parse(sent, *mchxt, *ctxt, opts);
+	print_time(opts, "Counted parses (%d w/cost cutoff %.2f)",
+	           num_linkages, cost_cutoff);
+
+	return num_linkages;
+}
+
+static int cost_cmp(const void *a, const void *b)
+{
+	float c1 = *(const float *)a;
+	float c2 = *(const float *)b;
+
+	return (c1 > c2) - (c1 < c2);
+}
+
+/**
+ * Find the highest disjunct cost cutoff for which the linkage count of
+ * \p sent doesn't overflow, and leave the sentence ready for extracting
+ * its linkages with that cutoff. The linkage count can only decrease
+ * with the cutoff, so a binary search over the costs of the current
+ * (pruned) disjuncts is done. If the count drops from an overflow
+ * directly to 0, the lowest cutoff for which there are linkages is
+ * used. The cutoff is recorded in sent->disjunct_cost.
+ *
+ * The counting is cheap relative to the extraction and post-processing
+ * of the linkages of an overflowing count, which are done only once,
+ * with the chosen cutoff.
+ * @return The linkage count for the chosen cutoff.
+ */
+static int lower_cost_cutoff(Sentence sent, Parse_Options opts,
+                             Tracon_sharing *ts_pruning,
+                             void *saved_memblock, int prune_level,
+                             unsigned int *ncu[2],
+                             Tracon_sharing **ts_parsing,
+                             fast_matcher_t **mchxt,
+                             count_context_t **ctxt)
+{
+	int num_linkages = sent->num_linkages_found;
+
+	size_t num_costs = 0;
+	for (WordIdx w = 0; w < sent->length; w++)
+		for (Disjunct *d = sent->word[w].d; d != NULL; d = d->next)
+			num_costs++;
+	if (0 == num_costs) return num_linkages;
+
+	float *cost = malloc(num_costs * sizeof(*cost));
+	num_costs = 0;
+	for (WordIdx w = 0; w < sent->length; w++)
+		for (Disjunct *d = sent->word[w].d; d != NULL; d = d->next)
+			cost[num_costs++] = d->cost;
+
+	qsort(cost, num_costs, sizeof(*cost), cost_cmp);
+	size_t num_levels = 1;
+	for (size_t i = 1; i < num_costs; i++)
+	{
+		if (cost[i] != cost[num_levels-1])
+			cost[num_levels++] = cost[i];
+	}
+
+	/* cost[hi] overflows, and cost[lo] (if lo >= 0) doesn't. */
+	int hi = (int)num_levels - 1;
+	int lo = -1;
+	int lo_num_linkages = 0;
+	int last = hi; /* The cutoff for which the sentence is ready */
+
+	while (hi - lo > 1)
+	{
+		int mid = (lo + hi) / 2;
+		num_linkages =
+			count_with_cost_cutoff(sent, opts, cost[mid], ts_pruning,
+			                       saved_memblock, prune_level, ncu,
+			                       ts_parsing, mchxt, ctxt);
+		last = mid;
+		if (resources_exhausted(opts->resources)) goto cutoff_done;
+
+		if (PARSE_NUM_OVERFLOW < num_linkages)
+		{
+			hi = mid;
+		}
+		else
+		{
+			lo = mid;
+			lo_num_linkages = num_linkages;
+		}
+	}
+
+	int chosen = ((0 <= lo) && (0 < lo_num_linkages)) ? lo : hi;
+	if (chosen != last)
+	{
+		num_linkages =
+			count_with_cost_cutoff(sent, opts, cost[chosen], ts_pruning,
+			                       saved_memblock, prune_level, ncu,
+			                       ts_parsing, mchxt, ctxt);
+		last = chosen;
+	}
+
+cutoff_done:
+	if (last != (int)num_levels - 1)
+		sent->disjunct_cost = cost[last];
+	free(cost);
+
+	return num_linkages;
+}
+
 /**
  * classic_parse() -- parse the given sentence.
  * Perform parsing, using the original link-grammar parsing algorithm
@@ -573,37 +746,36 @@ static void notify_no_complete_linkages(unsigned int null_count,
  * disjuncts which are not appropriate to continue do_parse() tries with
  * a greater null_count. To solve that, we need to restore the original
  * disjuncts of the sentence and call pp_and_power_prune() once again.
+ *
+ * The same is done when opts->adaptive_cost is set and the linkage count
+ * overflows: the disjuncts are restored and pruned again with a lower
+ * cost cutoff (see lower_cost_cutoff()).
  */
 void classic_parse(Sentence sent, Parse_Options opts)
 {
 	fast_matcher_t * mchxt = NULL;
 	count_context_t * ctxt = NULL;
+	Tracon_sharing *ts_pruning = NULL;
 	Tracon_sharing *ts_parsing = NULL;
+	Tracon_sharing *ts_cached = NULL; /* Loaded from the prune cache */
 	void *saved_memblock = NULL;
+	unsigned int expected_null_count = 0;
 	int current_prune_level = -1; /* -1: No pruning has been done yet. */
 	int needed_prune_level = opts->min_null_count;
 	bool more_pruning_possible = false;
+	bool pack_needed = false; /* Pruned but not yet encoded for parsing */
 
 	unsigned int max_null_count = opts->max_null_count;
 	max_null_count = (unsigned int)MIN(max_null_count, sent->length);
 	bool one_step_parse = (unsigned int)opts->min_null_count != max_null_count;
 	int max_prune_level = (int)max_null_count;
-	bool optimize_pruning = true; /* Perform pruning null count optimization. */
+	/* Perform pruning null count optimization? */
+	bool optimize_pruning = null_count_pruning(sent, opts);
 
 	unsigned int *ncu[2];
 	ncu[0] = alloca(sent->length * sizeof(*ncu[0]));
 	ncu[1] = alloca(sent->length * sizeof(*ncu[1]));
 
-	/* Null-count optimization not implemented for islands_ok==true. */
-	if (opts->islands_ok)
-		optimize_pruning = false;
-
-	/* Pruning per null-count and one-step-parse are costly for sentences
-	 * whose parsing takes tens of milliseconds or so. Disable them for
-	 * short-enough sentences. */
-	if (sent->length < sent->min_len_multi_pruning)
-		optimize_pruning = false;
-
 	if (!optimize_pruning)
 	{
 		/* Turn-off null-count optimization. */
@@ -616,22 +788,34 @@ void classic_parse(Sentence sent, Parse_Options opts)
 		}
 	}
 
-	/* Build lists of disjuncts */
-	prepare_to_parse(sent, opts);
-	if (resources_exhausted(opts->resources)) return; /* Nothing to free yet. */
-
-	Tracon_sharing *ts_pruning = pack_sentence_for_pruning(sent);
-	free_sentence_disjuncts(sent, /*category_too*/false);
-
-	if (one_step_parse)
+	if (prune_cache_load(sent, &ts_cached, ncu, &expected_null_count))
 	{
-		/* Save the disjuncts for possible parse w/ an increased null count. */
-		saved_memblock = save_disjuncts(sent, ts_pruning);
+		/* The disjuncts have already been pruned and packed for parsing
+		 * (if they are to be parsed at all). */
+		print_time(opts, "Loaded from the prune cache%s",
+		           (NULL == ts_cached) ? " (no parsing)" : "");
 	}
+	else
+	{
+		/* Build lists of disjuncts */
+		prepare_to_parse(sent, opts);
+		if (resources_exhausted(opts->resources)) return; /* Nothing to free yet. */
 
-	print_time(opts, "Encoded for pruning%s%s",
-	           (NULL == ts_pruning->tracon_list) ? " (skipped)" : "",
-	           (one_step_parse) ? " (one-step)" : "");
+		ts_pruning = pack_sentence_for_pruning(sent);
+		keep_disjunct_pools(sent); /* For sentence_reparse() */
+		free_sentence_disjuncts(sent, /*category_too*/false);
+
+		if (one_step_parse || opts->adaptive_cost)
+		{
+			/* Save the disjuncts for possible parse w/ an increased null count,
+			 * or with a lower cost cutoff. */
+			saved_memblock = save_disjuncts(sent, ts_pruning);
+		}
+
+		print_time(opts, "Encoded for pruning%s%s",
+		           (NULL == ts_pruning->tracon_list) ? " (skipped)" : "",
+		           (one_step_parse) ? " (one-step)" : "");
+	}
 
 	for (unsigned int nl = opts->min_null_count; nl <= max_null_count; nl++)
 	{
@@ -655,14 +839,24 @@ void classic_parse(Sentence sent, Parse_Options opts)
 				needed_prune_level = MAX_SENTENCE;
 
 			if (more_pruning_possible)
+			{
 				restore_disjuncts(sent, saved_memblock, ts_pruning);
+				if (sent->disjunct_cost < opts->disjunct_cost)
+					cost_prune(sent, sent->disjunct_cost);
+			}
 
 			more_pruning_possible =
 				one_step_parse && (current_prune_level != MAX_SENTENCE);
 
-			unsigned int expected_null_count =
-				pp_and_power_prune(sent, ts_pruning, current_prune_level, opts,
-				                   ncu);
+			if (NULL != ts_pruning) /* Else loaded from the prune cache. */
+			{
+				expected_null_count =
+					pp_and_power_prune(sent, ts_pruning, current_prune_level, opts,
+					                   ncu);
+				/* The pruning may have stopped in the middle. */
+				if (resources_exhausted(opts->resources)) goto parse_end_cleanup;
+				pack_needed = true;
+			}
 			if (expected_null_count > nl)
 			{
 				if (opts->verbosity >= D_USER_TIMES)
@@ -682,20 +876,32 @@ void classic_parse(Sentence sent, Parse_Options opts)
 			}
 		}
 
-		if (NULL != ts_pruning)
+		if (pack_needed || (NULL != ts_cached))
 		{
-			free_tracon_sharing(ts_parsing);
-			ts_parsing = pack_sentence_for_parsing(sent);
-			print_time(opts, "Encoded for parsing");
-
-			if (!more_pruning_possible)
+			if (NULL != ts_cached)
+			{
+				ts_parsing = ts_cached;
+				ts_cached = NULL;
+			}
+			else
 			{
-				/* At this point no further pruning will be done. Free the
-				 * pruning tracon stuff here instead of at the end. */
-				free_tracon_memblock(ts_pruning);
-				ts_pruning = NULL;
-				if (NULL != saved_memblock)
-					free_saved_memblock(saved_memblock);
+				free_tracon_sharing(ts_parsing);
+				ts_parsing = pack_sentence_for_parsing(sent);
+				pack_needed = false;
+				print_time(opts, "Encoded for parsing");
+
+				/* Before the fast matcher changes ncu. */
+				prune_cache_store(sent, ts_parsing, expected_null_count, ncu);
+
+				if (!more_pruning_possible && !opts->adaptive_cost)
+				{
+					/* At this point no further pruning will be done. Free the
+					 * pruning tracon stuff here instead of at the end. */
+					free_tracon_memblock(ts_pruning);
+					ts_pruning = NULL;
+					if (NULL != saved_memblock)
+						free_saved_memblock(saved_memblock);
+				}
 			}
 
 			gword_record_in_connector(sent);
@@ -704,12 +910,22 @@ void classic_parse(Sentence sent, Parse_Options opts)
 			mchxt = alloc_fast_matcher(sent, ncu);
 			print_time(opts, "Initialized fast matcher");
 			if (resources_exhausted(opts->resources)) goto parse_end_cleanup;
+
+			/* The counts are keyed by the tracon IDs of the disjuncts. */
+			free_count_context(ctxt, sent);
+			ctxt = NULL;
 		}
 
 		free_linkages(sent);
+		free_forest(sent->forest);
+		sent->forest = NULL;
 
-		free_count_context(ctxt, sent);
-		ctxt = alloc_count_context(sent, ts_parsing);
+		/* The count table entries are keyed by the null count too, so
+		 * when the disjuncts have not changed since the previous null
+		 * count, its count context is reused, and only the counts for
+		 * the new null counts get computed. */
+		if (NULL == ctxt)
+			ctxt = alloc_count_context(sent, ts_parsing);
 
 		sent->num_linkages_found = do_parse(sent, mchxt, ctxt, opts);
 
@@ -717,10 +933,32 @@ void classic_parse(Sentence sent, Parse_Options opts)
 		           sent->num_linkages_found, sent->null_count,
 		           (sent->null_count != 1) ? "s" : "");
 
+		/* On a combinatorial explosion, the linkages are a random sample
+		 * of an astronomical number of them. Before extracting them, find
+		 * a lower cost cutoff that avoids that, if asked to. */
+		if (opts->adaptive_cost && (NULL != ts_pruning) &&
+		    (PARSE_NUM_OVERFLOW < sent->num_linkages_found) &&
+		    !IS_GENERATION(sent->dict) &&
+		    !resources_exhausted(opts->resources))
+		{
+			sent->num_linkages_found =
+				lower_cost_cutoff(sent, opts, ts_pruning, saved_memblock,
+				                  current_prune_level, ncu,
+				                  &ts_parsing, &mchxt, &ctxt);
+		}
+
 		/* In case of a timeout, the linkage is partial and may be
 		 * inconsistent. It is also usually different on each run.
-		 * So in that case, pretend that the linkage count is 0. */
-		if (resources_exhausted(opts->resources))
+		 * So in that case, pretend that the linkage count is 0.
+		 *
+		 * In "anytime" mode, keep the partial count instead. do_count()
+		 * stops counting once the timer expires, but each table entry it
+		 * has stored so far accounts only for sub-linkages that are also
+		 * in the table. Hence the linkage extraction, which consults only
+		 * the table, yields exactly the linkages that have been counted,
+		 * and a bounded-time parse gives an answer instead of none. */
+		if (resources_exhausted(opts->resources) &&
+		    (!opts->anytime || (sent->num_linkages_found <= 0)))
 		{
 			sent->num_linkages_found = 0;
 			goto parse_end_cleanup;
@@ -731,6 +969,8 @@ void classic_parse(Sentence sent, Parse_Options opts)
 			extractor_t * pex = extractor_new(sent);
 			setup_linkages(sent, pex, mchxt, ctxt, opts);
 			process_linkages(sent, pex, opts);
+			if (opts->keep_forest)
+				sent->forest = build_forest(pex, sent);
 			if (IS_GENERATION(sent->dict))
 			    find_unused_disjuncts(sent, pex);
 #ifdef PC_DISPLAY
@@ -741,6 +981,11 @@ void classic_parse(Sentence sent, Parse_Options opts)
 			post_process_lkgs(sent, opts);
 			if (resources_exhausted(opts->resources))
 			{
+				/* In anytime mode, report what has been found, even if it
+				 * has only P.P. violations. There is no time left for
+				 * trying a higher null count. */
+				if (opts->anytime) break;
+
 				sent->num_linkages_found = 0;
 				sent->num_valid_linkages = 0;
 				sent->num_linkages_post_processed = 0;
@@ -767,6 +1012,10 @@ void classic_parse(Sentence sent, Parse_Options opts)
 
 		notify_no_complete_linkages(nl, max_null_count);
 	}
+
+	/* If no parsing has been done, just the pruning result is cached. */
+	prune_cache_store(sent, NULL, expected_null_count, NULL);
+
 	if ((sent->num_linkages_found == 0) && IS_GENERATION(sent->dict))
 		find_unused_disjuncts(sent, NULL);
 
@@ -782,4 +1031,14 @@ parse_end_cleanup:
 	free_tracon_sharing(ts_parsing);
 	free_count_context(ctxt, sent);
 	free_fast_matcher(sent, mchxt);
+
+	if (resources_memory_exhausted(opts->resources))
+	{
+		/* Don't keep the count memory for reuse, so that a retry (e.g.
+		 * with a lower cost cutoff) starts within the budget. */
+		pool_delete(sent->Table_tracon_pool);
+		sent->Table_tracon_pool = NULL;
+		pool_delete(sent->wordvec_pool);
+		sent->wordvec_pool = NULL;
+	}
 }
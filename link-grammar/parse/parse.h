@@ -1,4 +1,5 @@
 
 
 void classic_parse(Sentence, Parse_Options);
+bool prune_once(Sentence, Parse_Options);
 int VDAL_compare_linkages(Linkage, Linkage);
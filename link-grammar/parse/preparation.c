@@ -12,6 +12,7 @@
 
 #include "api-structures.h"
 #include "prepare/build-disjuncts.h"
+#include "prepare/reuse-disjuncts.h"
 #include "connectors.h"
 #include "dict-common/dict-common.h"    // Dictionary_s
 #include "disjunct-utils.h"
@@ -101,22 +102,36 @@ static void build_sentence_disjuncts(Sentence sent, float cost_cutoff,
 	sent->Connector_pool = pool_new(__func__, "Connector",
 	                   /*num_elements*/8192, sizeof(Connector),
 	                   /*zero_out*/true, /*align*/false, /*exact*/false);
+	pool_set_account(sent->Disjunct_pool, &sent->space_in_use);
+	pool_set_account(sent->Connector_pool, &sent->space_in_use);
 
 #ifdef DEBUG
 	size_t num_con_alloced = pool_num_elements_issued(sent->Connector_pool);
 #endif
 
+	start_disjunct_record(sent, cost_cutoff, opts);
+	size_t num_reused = 0;
 	for (size_t w = 0; w < sent->length; w++)
 	{
 		Disjunct * d = NULL;
+		if (reuse_word_disjuncts(sent, w, &d))
+		{
+			sent->word[w].d = d;
+			num_reused++;
+			continue;
+		}
+		unsigned int x_index = 0;
 		for (X_node * x = sent->word[w].x; x != NULL; x = x->next)
 		{
 			Disjunct *dx = build_disjuncts_for_exp(sent, x->exp, x->string,
 				&x->word->gword_set_head, cost_cutoff, opts);
+			record_disjuncts(sent, w, x_index++, dx);
 			d = catenate_disjuncts(dx, d);
 		}
 		sent->word[w].d = d;
 	}
+	if (NULL != sent->reparse_prev)
+		lgdebug(+D_PREP, "Reused the disjuncts of %zu words\n", num_reused);
 
 #ifdef DEBUG
 	unsigned int dcnt, ccnt;
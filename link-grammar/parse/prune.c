@@ -425,6 +425,7 @@ static void power_table_init(Sentence sent, Tracon_sharing *ts, power_table *pt)
 				{
 					Connector *c = get_tracon(ts, dir, id);
 					if (!!shallow != c->shallow) continue;
+					if (0 == c->refcount) continue; /* See cost_prune() */
 
 					int w = get_tracon_word_number(c, dir);
 
@@ -1062,6 +1063,9 @@ static bool pruning_pass_end(prune_context *pc, const char *pass_dir,
  *  ones are detected on the first pass). When the number of the null
  *  words indicates there will be no parse with the given pc->null_links,
  *  return -1. Else return the number of discarded disjuncts.
+ *
+ *  Also return -1 if the resources got exhausted. The pruning is then
+ *  incomplete, and the caller is expected to abort the parse.
  */
 static int power_prune(Sentence sent, prune_context *pc, Parse_Options opts)
 {
@@ -1109,6 +1113,7 @@ static int power_prune(Sentence sent, prune_context *pc, Parse_Options opts)
 		}
 
 		if (pruning_pass_end(pc, "l->r", &total_deleted)) break;
+		if (resources_exhausted(opts->resources)) return -1;
 
 		/* Right-to-left pass. */
 		for (WordIdx w = sent->length-1; w != (WordIdx) -1; w--)
@@ -1144,6 +1149,7 @@ static int power_prune(Sentence sent, prune_context *pc, Parse_Options opts)
 		}
 
 		if (pruning_pass_end(pc, "r->l", &total_deleted)) break;
+		if (resources_exhausted(opts->resources)) return -1;
 
 		/* The above debug printouts revealed that the xlink counter doesn't
 		 * get increased after the first 2 passes. So neutralize the mlink table
@@ -2158,6 +2164,42 @@ static unsigned int cross_mlink_prune(Sentence sent, mlink_table *ml)
 	return N_deleted[0] + N_deleted[1];
 }
 
+/**
+ * Discard the disjuncts whose cost is above \p cost_cutoff, as if they
+ * have not been built. This is used for lowering the cost cutoff of a
+ * sentence whose disjuncts have already been encoded for pruning (see
+ * classic_parse()). The connectors of the discarded disjuncts are
+ * dereferenced, so that pp_and_power_prune() can then discard also the
+ * disjuncts that could connect only to them.
+ * @return The number of discarded disjuncts.
+ */
+unsigned int cost_prune(Sentence sent, float cost_cutoff)
+{
+	unsigned int N_deleted = 0;
+
+	for (WordIdx w = 0; w < sent->length; w++)
+	{
+		for (Disjunct **dd = &sent->word[w].d; *dd != NULL; /* See: NEXT */)
+		{
+			Disjunct *d = *dd;
+			if (d->cost <= cost_cutoff)
+			{
+				dd = &d->next; /* NEXT */
+				continue;
+			}
+
+			mark_jet_for_dequeue(d->left, false);
+			mark_jet_for_dequeue(d->right, false);
+			*dd = d->next; /* NEXT */
+			N_deleted++;
+		}
+	}
+
+	lgdebug(+D_PRUNE, "Debug: Cost cutoff %.3f: deleted %u\n",
+	        cost_cutoff, N_deleted);
+	return N_deleted;
+}
+
 /**
  * Prune useless disjuncts.
  * @param null_count Optimize for parsing with this null count.
@@ -19,5 +19,6 @@
 unsigned int pp_and_power_prune(Sentence, Tracon_sharing *,  unsigned int,
                               Parse_Options, unsigned int *[2]);
 bool optional_gap_collapse(Sentence, int, int);
+unsigned int cost_prune(Sentence, float);
 
 #endif /* _PRUNE_H */
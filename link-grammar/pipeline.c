@@ -0,0 +1,327 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <string.h>
+#if HAVE_THREADS_H
+#include <threads.h>
+#endif
+
+#include "api-structures.h"
+#include "connectors.h"                 // set_connector_farthest_word
+#include "prepare/exprune.h"
+#include "resources.h"
+#include "tokenize/word-structures.h"   // Word_struct
+
+/**
+ * Pipelined parsing of a sequence of sentences.
+ *
+ * The sentences are submitted by pipeline_submit() and taken out in
+ * the same order by pipeline_next(), which parses them in the caller's
+ * thread. In the meanwhile, helper threads tokenize the next sentences
+ * and prune their expressions, so these stages overlap the parsing of
+ * the current sentence. The number of sentences in flight is bounded
+ * by the pipeline depth.
+ *
+ * Each helper thread uses its own copy of the parse options, made at
+ * the pipeline creation. If the options that affect the preparation
+ * are changed afterward, pipeline_next() prepares the sentence again.
+ *
+ * Without C11 threads (or with num_threads == 0) everything is done
+ * by pipeline_next().
+ */
+
+typedef struct
+{
+	Sentence sent;
+	void *user_data;
+	int rc;                /* Result of the preparation */
+	bool ready;            /* Prepared */
+} Pipeline_slot;
+
+struct Pipeline_s
+{
+	Dictionary dict;
+	Parse_Options opts;    /* For parsing (the caller's) */
+	Parse_Options *helper_opts;
+	int num_threads;
+
+	/* A ring buffer of sentences, indexed by the submission number. */
+	Pipeline_slot *slot;
+	size_t depth;
+	size_t submitted;      /* Number of sentences submitted */
+	size_t taken;          /* ... taken for preparation */
+	size_t done;           /* ... returned by pipeline_next() */
+	bool stop;
+
+	lg_error_handler error_handler;
+	void *error_data;
+
+#if HAVE_THREADS_H
+	mtx_t mutex;
+	cnd_t work;            /* There is a sentence to prepare, or stop */
+	cnd_t ready;           /* A sentence got prepared */
+	thrd_t *thread;
+#endif
+};
+
+static void pl_lock(Pipeline p)
+{
+#if HAVE_THREADS_H
+	if (0 < p->num_threads) mtx_lock(&p->mutex);
+#endif
+}
+
+static void pl_unlock(Pipeline p)
+{
+#if HAVE_THREADS_H
+	if (0 < p->num_threads) mtx_unlock(&p->mutex);
+#endif
+}
+
+/**
+ * Return true if sentences prepared with \p a are good for parsing
+ * with \p b.
+ */
+static bool same_prepare_options(Parse_Options a, Parse_Options b)
+{
+	return (a->short_length == b->short_length) &&
+	       (a->all_short == b->all_short) &&
+	       (a->use_spell_guess == b->use_spell_guess) &&
+	       (0 == strcmp(a->dialect.conf, b->dialect.conf));
+}
+
+/**
+ * Tokenize the sentence and prune its expressions, so that
+ * sentence_parse() can skip these steps.
+ */
+static int sentence_prepare(Sentence sent, Parse_Options opts)
+{
+	int rc = sentence_split(sent, opts);
+	if (0 != rc) return rc;
+	if (MAX_SENTENCE <= sent->length) return 0; /* Let sentence_parse() fail */
+
+	resources_reset(opts->resources);
+	for (WordIdx w = 0; w < sent->length; w++)
+	{
+		for (X_node *x = sent->word[w].x; x != NULL; x = x->next)
+			set_connector_farthest_word(x->exp, (int)w, (int)sent->length, opts);
+	}
+	expression_prune(sent, opts);
+	sent->exp_pruned = true;
+
+	return 0;
+}
+
+#if HAVE_THREADS_H
+typedef struct
+{
+	Pipeline p;
+	Parse_Options opts;
+} helper_arg;
+
+static int helper_thread(void *arg)
+{
+	Pipeline p = ((helper_arg *)arg)->p;
+	Parse_Options opts = ((helper_arg *)arg)->opts;
+	free(arg);
+
+	/* The error handler is thread-local. */
+	lg_error_set_handler(p->error_handler, p->error_data);
+
+	mtx_lock(&p->mutex);
+	for (;;)
+	{
+		while (!p->stop && (p->taken == p->submitted))
+			cnd_wait(&p->work, &p->mutex);
+		if (p->stop) break;
+
+		Pipeline_slot *s = &p->slot[p->taken++ % p->depth];
+		mtx_unlock(&p->mutex);
+
+		int rc = sentence_prepare(s->sent, opts);
+
+		mtx_lock(&p->mutex);
+		s->rc = rc;
+		s->ready = true;
+		cnd_broadcast(&p->ready);
+	}
+	mtx_unlock(&p->mutex);
+
+	return 0;
+}
+#endif /* HAVE_THREADS_H */
+
+/**
+ * Create a pipeline for parsing sentences of \p dict.
+ * \p opts is used for parsing the sentences and must remain valid
+ * until the pipeline is deleted. \p num_threads helper threads prepare
+ * up to \p depth sentences ahead. The error handler of the calling
+ * thread is used by the helper threads too, so it must be thread-safe.
+ */
+Pipeline pipeline_create(Dictionary dict, Parse_Options opts,
+                         int num_threads, int depth)
+{
+	Pipeline p = calloc(1, sizeof(struct Pipeline_s));
+
+	p->dict = dict;
+	p->opts = opts;
+	p->depth = (depth < 1) ? 1 : (size_t)depth;
+	p->slot = calloc(p->depth, sizeof(*p->slot));
+
+	p->error_data = (void *)lg_error_set_handler_data(NULL);
+	p->error_handler = lg_error_set_handler(NULL, NULL);
+	lg_error_set_handler(p->error_handler, p->error_data);
+
+#if HAVE_THREADS_H
+	if (num_threads < 0) num_threads = 0;
+	p->helper_opts = calloc(num_threads + 1, sizeof(Parse_Options));
+	p->thread = calloc(num_threads + 1, sizeof(thrd_t));
+	mtx_init(&p->mutex, mtx_plain);
+	cnd_init(&p->work);
+	cnd_init(&p->ready);
+
+	for (int i = 0; i < num_threads; i++)
+	{
+		Parse_Options hopts = parse_options_copy(opts);
+		helper_arg *arg = malloc(sizeof(helper_arg));
+		*arg = (helper_arg){ .p = p, .opts = hopts };
+		if (thrd_success != thrd_create(&p->thread[i], helper_thread, arg))
+		{
+			prt_error("Warning: pipeline_create(): Cannot create thread %d; "
+			          "using %d.\n", i, i);
+			parse_options_delete(hopts);
+			free(arg);
+			break;
+		}
+		p->helper_opts[p->num_threads++] = hopts;
+	}
+#else
+	if (0 < num_threads)
+		lgdebug(D_USER_INFO, "Info: pipeline_create(): No thread support; "
+		        "the sentences are prepared on demand.\n");
+#endif /* HAVE_THREADS_H */
+
+	return p;
+}
+
+/**
+ * Stop the helper threads and free the pipeline, including the
+ * sentences that have not been taken out by pipeline_next().
+ */
+void pipeline_delete(Pipeline p)
+{
+	if (NULL == p) return;
+
+#if HAVE_THREADS_H
+	if (0 < p->num_threads)
+	{
+		mtx_lock(&p->mutex);
+		p->stop = true;
+		for (int i = 0; i < p->num_threads; i++)
+			resources_cancel(p->helper_opts[i]->resources);
+		cnd_broadcast(&p->work);
+		mtx_unlock(&p->mutex);
+
+		for (int i = 0; i < p->num_threads; i++)
+		{
+			thrd_join(p->thread[i], NULL);
+			parse_options_delete(p->helper_opts[i]);
+		}
+	}
+	cnd_destroy(&p->ready);
+	cnd_destroy(&p->work);
+	mtx_destroy(&p->mutex);
+	free(p->thread);
+#endif /* HAVE_THREADS_H */
+	free(p->helper_opts);
+
+	for (size_t n = p->done; n < p->submitted; n++)
+		sentence_delete(p->slot[n % p->depth].sent);
+	free(p->slot);
+	free(p);
+}
+
+/**
+ * Submit a sentence for parsing. \p user_data is returned along with
+ * it by pipeline_next().
+ * Return false if the pipeline is full; then pipeline_next() should be
+ * called first.
+ */
+bool pipeline_submit(Pipeline p, const char *input, void *user_data)
+{
+	pl_lock(p);
+	bool full = (p->submitted - p->done == p->depth);
+	pl_unlock(p);
+	if (full) return false;
+
+	Pipeline_slot *s = &p->slot[p->submitted % p->depth];
+	*s = (Pipeline_slot){ .sent = sentence_create(input, p->dict),
+	                      .user_data = user_data };
+
+	pl_lock(p);
+	p->submitted++;
+#if HAVE_THREADS_H
+	if (0 < p->num_threads) cnd_signal(&p->work);
+#endif
+	pl_unlock(p);
+
+	return true;
+}
+
+/**
+ * Parse the next submitted sentence, in the order of submission.
+ * Return it (to be deleted by sentence_delete()), or NULL if there is
+ * none. \p num_linkages is set to the sentence_parse() result, and
+ * \p user_data (if not NULL) to the one given on its submission.
+ */
+Sentence pipeline_next(Pipeline p, int *num_linkages, void **user_data)
+{
+	pl_lock(p);
+	if (p->done == p->submitted)
+	{
+		pl_unlock(p);
+		return NULL;
+	}
+
+	Pipeline_slot *s = &p->slot[p->done % p->depth];
+	bool prepare = (p->taken == p->done);
+	if (prepare)
+	{
+		p->taken++;
+	}
+	else
+	{
+#if HAVE_THREADS_H
+		while (!s->ready) cnd_wait(&p->ready, &p->mutex);
+#endif
+	}
+	Pipeline_slot slot = *s;
+	p->done++;
+	pl_unlock(p);
+
+	Sentence sent = slot.sent;
+	if (!prepare && (0 == slot.rc) &&
+	    !same_prepare_options(p->helper_opts[0], p->opts))
+	{
+		/* Prepared with stale options. Start over. */
+		Sentence fresh = sentence_create(sent->orig_sentence, p->dict);
+		sentence_delete(sent);
+		sent = fresh;
+	}
+
+	/* A sentence that is not prepared is split and pruned by
+	 * sentence_parse(). A failed preparation has already been
+	 * reported. */
+	*num_linkages = (0 == slot.rc) ? sentence_parse(sent, p->opts) : -1;
+	if (NULL != user_data) *user_data = slot.user_data;
+
+	return sent;
+}
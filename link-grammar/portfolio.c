@@ -0,0 +1,309 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <string.h>
+#if HAVE_THREADS_H
+#include <threads.h>
+#include <time.h>
+#endif
+
+#include "api-structures.h"
+#include "dict-common/dict-common.h"    // IS_GENERATION
+#include "linkage/linkage.h"
+#include "parse/forest.h"               // free_forest
+#include "parse/parse.h"                // classic_parse
+#include "portfolio.h"
+#include "resources.h"
+#include "result-cache.h"               // result_cache_adopt
+
+/**
+ * Portfolio parsing: race the classic parser against the SAT parser.
+ *
+ * Which of the two parsers is faster depends on the sentence: the SAT
+ * parser is often much faster on long sentences that have a complete
+ * linkage, while the classic parser is faster on most of the others,
+ * and it is the only one that can parse with null links. Since this
+ * cannot be told in advance, portfolio_parse() runs both of them
+ * concurrently, each in its own thread, and uses the result of the
+ * first one that finds a valid linkage. The other one is cancelled.
+ * The result of the classic parser is also final when it finds that
+ * there is no valid linkage (the SAT parser can then find none either),
+ * so the SAT parser wins only when the classic parser is slower or
+ * runs out of the resources.
+ *
+ * The classic parser parses the given sentence, which has already been
+ * tokenized and pruned by sentence_parse(). The SAT parser keeps its
+ * state in the sentence, so it parses a copy of it. If it wins, the
+ * linkages it has produced are copied to the given sentence, the same
+ * way as parse results are copied to the result cache. The SAT parser
+ * produces its linkages on demand, and only those up to the first
+ * valid one have been produced by then, so these are the only ones
+ * that are available.
+ *
+ * Each parser has its own copy of the parse options, with the same
+ * limits (max_parse_time is the CPU time of each thread) and the same
+ * wall-clock deadline. The calling thread waits for them, and forwards
+ * to both a cancellation of the caller's options. The loser is joined
+ * (the sentence copy it parses refers to the dictionary, which the
+ * caller may delete right after), so it has to stop promptly when it is
+ * cancelled: the SAT parser checks for it in each step of the encoding
+ * and between short slices of solving.
+ */
+
+/* Interval for checking the caller's options for a cancellation. */
+#define PORTFOLIO_POLL_MSEC 10
+
+#if USE_SAT_SOLVER && HAVE_THREADS_H
+typedef struct Race_s Race;
+
+typedef struct
+{
+	Race *race;
+	Sentence sent;
+	Parse_Options opts;
+	bool done;                   /* The parser has returned */
+} Racer;
+
+struct Race_s
+{
+	mtx_t mutex;
+	cnd_t finished;              /* A racer is done */
+	lg_error_handler error_handler;
+	void *error_data;
+	Racer classic;
+	Racer sat;
+};
+
+static void racer_done(Racer *r)
+{
+	Race *race = r->race;
+
+	mtx_lock(&race->mutex);
+	r->done = true;
+	cnd_signal(&race->finished);
+	mtx_unlock(&race->mutex);
+}
+
+static int classic_racer(void *arg)
+{
+	Racer *r = arg;
+	Resources res = r->opts->resources;
+
+	/* The error handler is thread-local. */
+	lg_error_set_handler(r->race->error_handler, r->race->error_data);
+
+	/* The CPU time is per thread, so it is reset here. */
+	resources_reset(res);
+	resources_track_space(res, &r->sent->space_in_use);
+	classic_parse(r->sent, r->opts);
+	resources_track_space(res, NULL);
+
+	racer_done(r);
+	return 0;
+}
+
+static int sat_racer(void *arg)
+{
+	Racer *r = arg;
+
+	lg_error_set_handler(r->race->error_handler, r->race->error_data);
+	sentence_parse(r->sent, r->opts);
+
+	racer_done(r);
+	return 0;
+}
+
+static Parse_Options racer_options(Parse_Options opts)
+{
+	Parse_Options ropts = parse_options_copy(opts);
+
+	ropts->resources->wall_deadline = opts->resources->wall_deadline;
+	ropts->portfolio = false;
+
+	return ropts;
+}
+
+/* Called with the race mutex held (or after the racer has been joined). */
+static bool has_valid_linkage(const Racer *r)
+{
+	return r->done && (0 < r->sent->num_valid_linkages);
+}
+
+/**
+ * Return true if the classic parser has finished, and the SAT parser
+ * cannot do better: it has found a valid linkage, or it has found
+ * that there is none, i.e. it has not been stopped by the resources.
+ */
+static bool classic_is_final(const Racer *r)
+{
+	Resources res = r->opts->resources;
+
+	if (!r->done) return false;
+	return has_valid_linkage(r) || !(res->timer_expired || res->memory_exhausted);
+}
+
+/**
+ * Give \p sent the linkages that the SAT parser has produced for its
+ * copy, i.e. up to (and including) the first valid one.
+ */
+static void adopt_sat_result(Sentence sent, Racer *sat)
+{
+	Sentence ssent = sat->sent;
+
+	/* The SAT parser reports linkage_limit linkages (see sat_parse()),
+	 * but only those up to the first valid one have been produced. */
+	LinkageIdx n = 0;
+	while (0 != ssent->lnkages[n++].lifo.N_violations)
+		;
+	ssent->num_linkages_found = (int)n;
+	ssent->num_linkages_post_processed = n;
+	ssent->num_valid_linkages = 1;
+
+	free_forest(sent->forest);
+	sent->forest = NULL;
+	result_cache_adopt(sent, ssent, sat->opts);
+
+	/* Put the valid linkage first, as the classic parser does. */
+	struct Linkage_s valid = sent->lnkages[n-1];
+	memmove(&sent->lnkages[1], &sent->lnkages[0],
+	        (n-1) * sizeof(struct Linkage_s));
+	sent->lnkages[0] = valid;
+}
+
+static void race(Sentence sent, Parse_Options opts)
+{
+	Race race;
+	memset(&race, 0, sizeof(race));
+
+	race.error_data = (void *)lg_error_set_handler_data(NULL);
+	race.error_handler = lg_error_set_handler(NULL, NULL);
+	lg_error_set_handler(race.error_handler, race.error_data);
+
+	Racer *classic = &race.classic;
+	Racer *sat = &race.sat;
+	*classic = (Racer){ .race = &race, .sent = sent,
+	                    .opts = racer_options(opts) };
+	*sat = (Racer){ .race = &race,
+	                .sent = sentence_create(sent->orig_sentence, sent->dict),
+	                .opts = racer_options(opts) };
+	sat->opts->use_sat_solver = true;
+	sat->opts->max_null_count = 0; /* Not supported by the SAT parser */
+
+	mtx_init(&race.mutex, mtx_plain);
+	cnd_init(&race.finished);
+
+	thrd_t classic_thread, sat_thread;
+	bool sat_started =
+		(thrd_success == thrd_create(&sat_thread, sat_racer, sat));
+	bool started = sat_started &&
+		(thrd_success == thrd_create(&classic_thread, classic_racer, classic));
+
+	Racer *winner = NULL;
+	if (started)
+	{
+		bool interrupted = false;
+
+		mtx_lock(&race.mutex);
+		while (!classic->done || !sat->done)
+		{
+			if (NULL == winner)
+			{
+				if (classic_is_final(classic))
+					winner = classic;
+				else if (has_valid_linkage(sat))
+					winner = sat;
+
+				if (NULL != winner)
+				{
+					Racer *loser = (winner == classic) ? sat : classic;
+					resources_cancel(loser->opts->resources);
+					continue;
+				}
+			}
+
+			if (!interrupted && resources_interrupted(opts->resources))
+			{
+				interrupted = true;
+				resources_cancel(classic->opts->resources);
+				resources_cancel(sat->opts->resources);
+			}
+
+			struct timespec ts;
+			timespec_get(&ts, TIME_UTC);
+			ts.tv_nsec += PORTFOLIO_POLL_MSEC * 1000000L;
+			if (ts.tv_nsec >= 1000000000L)
+			{
+				ts.tv_sec++;
+				ts.tv_nsec -= 1000000000L;
+			}
+			cnd_timedwait(&race.finished, &race.mutex, &ts);
+		}
+		mtx_unlock(&race.mutex);
+
+		thrd_join(classic_thread, NULL);
+		thrd_join(sat_thread, NULL);
+
+		/* Both may have finished before either has been checked. */
+		if (NULL == winner)
+			winner = (!classic_is_final(classic) && has_valid_linkage(sat)) ?
+			         sat : classic;
+
+		if (winner == sat) adopt_sat_result(sent, sat);
+
+		Resources res = winner->opts->resources;
+		opts->resources->timer_expired = res->timer_expired;
+		opts->resources->memory_exhausted = res->memory_exhausted;
+
+		if (verbosity_level(D_USER_TIMES))
+		{
+			prt_error("#### Portfolio: Using the %s parser result\n",
+			          (winner == sat) ? "SAT" : "classic");
+		}
+	}
+	else
+	{
+		prt_error("Warning: Cannot create the portfolio parsing threads; "
+		          "using the classic parser.\n");
+		if (sat_started)
+		{
+			resources_cancel(sat->opts->resources);
+			thrd_join(sat_thread, NULL);
+		}
+		classic_parse(sent, opts);
+	}
+
+	cnd_destroy(&race.finished);
+	mtx_destroy(&race.mutex);
+	sentence_delete(sat->sent);
+	parse_options_delete(sat->opts);
+	parse_options_delete(classic->opts);
+}
+#endif /* USE_SAT_SOLVER && HAVE_THREADS_H */
+
+/**
+ * Parse \p sent with the classic parser and the SAT parser concurrently,
+ * and keep the result of the first one that finds a valid linkage.
+ * Without thread support, or when the SAT parser cannot be used, this
+ * is just classic_parse().
+ */
+void portfolio_parse(Sentence sent, Parse_Options opts)
+{
+#if USE_SAT_SOLVER && HAVE_THREADS_H
+	/* The SAT parser cannot parse with null links only, nor generate. */
+	if ((0 == opts->min_null_count) && !IS_GENERATION(sent->dict))
+	{
+		race(sent, opts);
+		return;
+	}
+#endif /* USE_SAT_SOLVER && HAVE_THREADS_H */
+
+	classic_parse(sent, opts);
+}
@@ -0,0 +1,19 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _PORTFOLIO_H
+#define _PORTFOLIO_H
+
+#include "api-structures.h"
+
+void portfolio_parse(Sentence, Parse_Options);
+
+#endif /* _PORTFOLIO_H */
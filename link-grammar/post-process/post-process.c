@@ -1168,7 +1168,7 @@ void post_process_lkgs(Sentence sent, Parse_Options opts)
 
 			post_process_scan_linkage(pp, lkg);
 
-			if (((TCD-1) == in%TCD) && resources_exhausted(opts->resources)) break;
+			if (resources_poll(opts->resources, in+1, TCD)) break;
 		}
 	}
 
@@ -1195,7 +1195,7 @@ void post_process_lkgs(Sentence sent, Parse_Options opts)
 		N_linkages_post_processed++;
 
 		linkage_score(lkg, opts);
-		if (((TCD-1) == in%TCD) && resources_exhausted(opts->resources)) break;
+		if (resources_poll(opts->resources, in+1, TCD)) break;
 	}
 
 	/* If the timer expired, then we never finished post-processing.
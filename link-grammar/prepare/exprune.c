@@ -12,11 +12,13 @@
 /*************************************************************************/
 
 #include <inttypes.h>                    // format macros
+#include <limits.h>                      // INT_MIN
 
 #include "api-structures.h"              // for Sentence_s
 #include "connectors.h"
 #include "dict-common/dict-structures.h" // expression_stringify
 #include "dict-common/dict-utils.h"      // size_of_expression
+#include "resources.h"
 #include "print/print-util.h"            // dyn_str functions
 #include "string-set.h"
 #include "tokenize/word-structures.h"    // for Word_struct
@@ -45,6 +47,11 @@
  * to right.
  * Alternate passes are made until no connector is deleted.
  *
+ * The passes after the first two are incremental: a word is purged
+ * again only if its set S has changed since the previous pass in the
+ * same direction, and S is rebuilt only from the first word whose
+ * connectors have changed since then.
+ *
  * FIXME: Mark shallow connectors on dictionary read and enhance the
  * pruning accordingly.
  */
@@ -77,8 +84,14 @@ struct connector_table_s
 	condesc_t *condesc;
 	connector_table *next;
 	int farthest_word;
+	int shadowed_farthest_word; /* See insert_connector() */
+	unsigned int seq;           /* Pass position of the inserting word */
 };
 
+/* A farthest_word value that never matches (see matches_S()). It also
+ * marks elements which don't shadow an older one. */
+#define CT_NO_WORD INT_MIN
+
 #define CT_BLKSIZE 512
 /* The connector table elements are allocated in a kind of an unrolled
  * linked list with fixed blocks, when the first block is pre-allocated
@@ -103,51 +116,104 @@ struct connector_table_s
 //                           ...
 //                           block connecting element
 
+/**
+ * The allocation state of a connector table, along with a signature of
+ * the connector set it holds. Since connectors are only deleted, the set
+ * S before a given word can only shrink from pass to pass, so it is
+ * unchanged iff both its number of different connectors and the sum of
+ * their farthest_word are unchanged.
+ */
+typedef struct
+{
+	connector_table *current_element;
+	connector_table *end_current_block;
+	size_t num_condesc;
+	int64_t farthest_word_sum;
+} ct_state;
+
+/**
+ * Each pass direction has its own connector table, which is kept across
+ * passes. On each pass it is rewound to the first word that has changed
+ * since the previous pass in the same direction, and rebuilt only from
+ * there. The state before the insertion of each word is kept in mark[],
+ * indexed by the pass position of the word.
+ */
+typedef struct
+{
+	connector_table **ct;
+	ct_state st;
+	ct_state *mark;
+	connector_table connector_table_element[CT_BLKSIZE];
+} pass_table;
+
 typedef struct exprune_context_s exprune_context;
 struct exprune_context_s
 {
-	connector_table **ct;
+	pass_table pt[2];      /* [0]: left-to-right; [1]: right-to-left */
+	pass_table *t;         /* The table of the current pass */
 	size_t ct_size;
 	Parse_Options opts;
-	connector_table *current_element;
-	connector_table *end_current_block;
-	connector_table connector_table_element[CT_BLKSIZE];
 	int N_deleted;
 };
 
-static connector_table *ct_element_new(exprune_context *ctxt)
+static connector_table *ct_element_new(pass_table *t)
 {
-	if (ctxt->current_element == ctxt->end_current_block)
+	if (t->st.current_element == t->st.end_current_block)
 	{
-		if (ctxt->end_current_block->next == NULL)
+		if (t->st.end_current_block->next == NULL)
 		{
 			connector_table *newblock =
-				malloc(CT_BLKSIZE * sizeof(*ctxt->current_element));
+				malloc(CT_BLKSIZE * sizeof(*t->st.current_element));
 			newblock[CT_BLKSIZE-1].next = NULL;
-			ctxt->end_current_block->next = newblock;
+			t->st.end_current_block->next = newblock;
 		} /* else - reuse next block. */
 
-		ctxt->current_element = ctxt->end_current_block->next;
-		ctxt->end_current_block = &ctxt->current_element[CT_BLKSIZE-1];
+		t->st.current_element = t->st.end_current_block->next;
+		t->st.end_current_block = &t->st.current_element[CT_BLKSIZE-1];
 	}
 
-	return ctxt->current_element++;
+	return t->st.current_element++;
 }
 
-static void free_connector_table(exprune_context *ctxt)
+static void init_connector_table(exprune_context *ctxt, size_t sent_length)
 {
-	connector_table *x;
-	connector_table *t = ctxt->connector_table_element[CT_BLKSIZE-1].next;
+	for (int dir = 0; dir < 2; dir++)
+	{
+		pass_table *t = &ctxt->pt[dir];
+
+		t->ct = calloc(ctxt->ct_size, sizeof(*t->ct));
+		t->mark = malloc((sent_length + 1) * sizeof(*t->mark));
+
+		t->st.current_element = t->connector_table_element;
+		t->st.end_current_block = &t->connector_table_element[CT_BLKSIZE-1];
+		t->st.end_current_block->next = NULL;
+		t->st.num_condesc = 0;
+		t->st.farthest_word_sum = 0;
+		t->mark[0] = t->st;
+	}
+}
 
-	while (t != NULL)
+static void free_connector_table(exprune_context *ctxt)
+{
+	for (int dir = 0; dir < 2; dir++)
 	{
-			 x = t[CT_BLKSIZE-1].next;
-			 free(t);
-			 t = x;
+		pass_table *pt = &ctxt->pt[dir];
+		connector_table *x;
+		connector_table *t = pt->connector_table_element[CT_BLKSIZE-1].next;
+
+		while (t != NULL)
+		{
+				 x = t[CT_BLKSIZE-1].next;
+				 free(t);
+				 t = x;
+		}
+
+		free(pt->ct);
+		pt->ct = NULL;
+		free(pt->mark);
+		pt->mark = NULL;
 	}
 
-	free(ctxt->ct);
-	ctxt->ct = NULL;
 	ctxt->ct_size = 0;
 }
 
@@ -173,7 +239,8 @@ static inline bool matches_S(connector_table **ct, int w, condesc_t * c)
 	for (e = ct[hash_S(c)]; e != NULL; e = e->next)
 	{
 		if (w > e->farthest_word) continue;
-		if (easy_match_desc(e->condesc, c)) return true;
+		/* All the connectors in this list have the same uc part. */
+		if (lc_easy_match(e->condesc, c)) return true;
 	}
 	return false;
 }
@@ -288,7 +355,7 @@ static Exp* purge_Exp(exprune_context *ctxt, int w, Exp *e, char dir)
 	{
 		if (e->dir == dir)
 		{
-			if (!matches_S(ctxt->ct, (dir == '-') ? w : -w, e->condesc))
+			if (!matches_S(ctxt->t->ct, (dir == '-') ? w : -w, e->condesc))
 			{
 				ctxt->N_deleted++;
 				return NULL;
@@ -319,46 +386,94 @@ static Exp* purge_Exp(exprune_context *ctxt, int w, Exp *e, char dir)
 	return e;
 }
 
-static void zero_connector_table(exprune_context *ctxt)
+/**
+ * Remove from the connector table all the connectors that have been
+ * inserted by words at pass position \p seq or later, and restore its
+ * state to that before inserting the word at \p seq.
+ *
+ * Elements are prepended, so those to remove are at the head of their
+ * lists. An element that shadows an older one with the same condesc
+ * restores its farthest_word.
+ */
+static void rewind_connector_table(exprune_context *ctxt, unsigned int seq)
 {
-	memset(ctxt->ct, 0, sizeof(*ctxt->ct) * ctxt->ct_size);
-	ctxt->current_element = ctxt->connector_table_element;
-	ctxt->end_current_block = &ctxt->connector_table_element[CT_BLKSIZE-1];
+	pass_table *t = ctxt->t;
+
+	for (size_t h = 0; h < ctxt->ct_size; h++)
+	{
+		while ((t->ct[h] != NULL) && (t->ct[h]->seq >= seq))
+		{
+			connector_table *e = t->ct[h];
+
+			t->ct[h] = e->next;
+			if (e->shadowed_farthest_word == CT_NO_WORD) continue;
+
+			connector_table *s;
+			for (s = e->next; s->condesc != e->condesc; s = s->next)
+				;
+			s->farthest_word = e->shadowed_farthest_word;
+		}
+	}
+
+	t->st = t->mark[seq];
 }
 
 /**
  * This function puts connector c into the connector table
  * if one like it isn't already there.
+ *
+ * If it is already there with a lower farthest_word that has been
+ * inserted by a previous word, a new element shadows it, so the table
+ * can be rewound to any word.
  */
-static void insert_connector(exprune_context *ctxt, int farthest_word,
-                             condesc_t *c)
+static void insert_connector(exprune_context *ctxt, unsigned int seq,
+                             int farthest_word, condesc_t *c)
 {
+	pass_table *t = ctxt->t;
 	unsigned int h;
 	connector_table *e;
+	int shadowed_farthest_word = CT_NO_WORD;
 
 	h = hash_S(c);
 
-	for (e = ctxt->ct[h]; e != NULL; e = e->next)
+	for (e = t->ct[h]; e != NULL; e = e->next)
 	{
 		if (c == e->condesc)
 		{
-			if (e->farthest_word < farthest_word) e->farthest_word = farthest_word;
-			return;
+			if (e->farthest_word >= farthest_word) return;
+
+			t->st.farthest_word_sum += farthest_word - e->farthest_word;
+			if (e->seq == seq)
+			{
+				e->farthest_word = farthest_word;
+				return;
+			}
+
+			shadowed_farthest_word = e->farthest_word;
+			e->farthest_word = CT_NO_WORD;
+			break;
 		}
 	}
 
-	e = ct_element_new(ctxt);
+	if (e == NULL)
+	{
+		t->st.num_condesc++;
+		t->st.farthest_word_sum += farthest_word;
+	}
+
+	e = ct_element_new(t);
 	e->condesc = c;
 	e->farthest_word = farthest_word;
-	e->next = ctxt->ct[h];
-	ctxt->ct[h] = e;
+	e->shadowed_farthest_word = shadowed_farthest_word;
+	e->seq = seq;
+	e->next = t->ct[h];
+	t->ct[h] = e;
 }
 /**
  * Put into the set S all of the dir-pointing connectors still in e.
- * Return a list of allocated dummy connectors; these will need to be
- * freed.
  */
-static void insert_connectors(exprune_context *ctxt, int w, Exp * e, int dir)
+static void insert_connectors(exprune_context *ctxt, unsigned int seq,
+                              Exp * e, int dir)
 {
 	if (e->type == CONNECTOR_type)
 	{
@@ -366,14 +481,14 @@ static void insert_connectors(exprune_context *ctxt, int w, Exp * e, int dir)
 		{
 			assert(NULL != e->condesc, "NULL connector");
 			int farthest_word = (dir == '-') ? -e->farthest_word : e->farthest_word;
-			insert_connector(ctxt, farthest_word, e->condesc);
+			insert_connector(ctxt, seq, farthest_word, e->condesc);
 		}
 	}
 	else
 	{
 		for (Exp *opd = e->operand_first; opd != NULL; opd = opd->operand_next)
 		{
-			insert_connectors(ctxt, w, opd, dir);
+			insert_connectors(ctxt, seq, opd, dir);
 		}
 	}
 }
@@ -415,16 +530,13 @@ static void print_expression_disjunct_count(Sentence sent)
 
 void expression_prune(Sentence sent, Parse_Options opts)
 {
-	size_t w;
 	exprune_context ctxt;
+	/* The last pass in which each word got connectors deleted. */
+	int *changed = calloc(sent->length, sizeof(*changed));
 
 	ctxt.opts = opts;
 	ctxt.ct_size = sent->dict->contable.num_uc;
-	ctxt.ct = malloc(ctxt.ct_size * sizeof(*ctxt.ct));
-	zero_connector_table(&ctxt);
-	ctxt.end_current_block->next = NULL;
-
-	ctxt.N_deleted = 1;  /* a lie to make it always do at least 2 passes */
+	init_connector_table(&ctxt, sent->length);
 
 	DBG_EXPSIZES("Initial expression sizes\n%s", e);
 
@@ -434,83 +546,87 @@ void expression_prune(Sentence sent, Parse_Options opts)
 		print_expression_disjunct_count(sent);
 	}
 
+	/* Even passes are left-to-right, odd ones are right-to-left. */
 	for (int pass = 0; ; pass++)
 	{
-		/* Left-to-right pass */
-		/* For every word */
-		for (w = 0; w < sent->length; w++)
+		const int rl = pass & 1;
+		const char purge_dir = rl ? '+' : '-';
+		const char insert_dir = rl ? '-' : '+';
+#define WORD(seq) (rl ? sent->length - 1 - (seq) : (seq))
+
+		/* The words before the first one that changed since the previous
+		 * pass in this direction, still have the same connectors in the
+		 * table. Rebuild it only from that word on. */
+		unsigned int start = 0;
+		if (pass >= 2)
 		{
-			/* For every expression in word */
-			for (X_node **xp = &sent->word[w].x; *xp != NULL; /* See: NEXT */)
-			{
-				X_node *x = *xp;
-
-				DBG(pass, w, "l->r pass before purging");
-				//if (pass == 0 && w == 0) {printf("Exp: ");prt_exp_mem(x->exp, 0);}
-				x->exp = purge_Exp(&ctxt, w, x->exp, '-');
-				DBG(pass, w, "l->r pass after purging");
-
-				/* Get rid of X_nodes with NULL exp */
-				if (x->exp == NULL)
-				{
-					*xp = x->next; /* NEXT - set current X_node to the next one */
-				}
-				else
-				{
-					xp = &x->next; /* NEXT */
-				}
-			}
-
-			for (X_node *x = sent->word[w].x; x != NULL; x = x->next)
-			{
-				insert_connectors(&ctxt, w, x->exp, '+');
-			}
+			while ((start + 1 < sent->length) && (changed[WORD(start)] < pass - 1))
+				start++;
 		}
 
-		DBG_EXPSIZES("l->r pass removed %d\n%s", ctxt.N_deleted, e);
-
-		if (ctxt.N_deleted == 0) break;
-		zero_connector_table(&ctxt);
-
-		/* Right-to-left pass */
+		ctxt.t = &ctxt.pt[rl];
+		rewind_connector_table(&ctxt, start);
 		ctxt.N_deleted = 0;
 
-		for (w = sent->length-1; w != (size_t) -1; w--)
+		for (unsigned int seq = start; seq < sent->length; seq++)
 		{
-			/* For every expression in word */
-			for (X_node **xp = &sent->word[w].x; *xp != NULL; /* See: NEXT */)
+			size_t w = WORD(seq);
+			pass_table *t = ctxt.t;
+
+			/* There is nothing to purge if the set S of this word is the
+			 * same as in the previous pass in this direction. */
+			if ((pass < 2) ||
+			    (t->st.num_condesc != t->mark[seq].num_condesc) ||
+			    (t->st.farthest_word_sum != t->mark[seq].farthest_word_sum))
 			{
-				X_node *x = *xp;
-
-				DBG(pass, w, "r->l pass before purging");
-				x->exp = purge_Exp(&ctxt, w, x->exp, '+');
-				DBG(pass, w, "r->l pass after purging");
+				int N_deleted = ctxt.N_deleted;
 
-				/* Get rid of X_nodes with NULL exp */
-				if (x->exp == NULL)
-				{
-					*xp = x->next; /* NEXT - set current X_node to the next one */
-				}
-				else
+				/* For every expression in word */
+				for (X_node **xp = &sent->word[w].x; *xp != NULL; /* See: NEXT */)
 				{
-					xp = &x->next; /* NEXT */
+					X_node *x = *xp;
+
+					DBG(pass, w, "before purging");
+					//if (pass == 0 && w == 0) {printf("Exp: ");prt_exp_mem(x->exp, 0);}
+					x->exp = purge_Exp(&ctxt, w, x->exp, purge_dir);
+					DBG(pass, w, "after purging");
+
+					/* Get rid of X_nodes with NULL exp */
+					if (x->exp == NULL)
+					{
+						*xp = x->next; /* NEXT - set current X_node to the next one */
+					}
+					else
+					{
+						xp = &x->next; /* NEXT */
+					}
 				}
+
+				if (ctxt.N_deleted != N_deleted) changed[w] = pass;
 			}
 
+			t->mark[seq] = t->st;
+			if (seq == sent->length - 1) break; /* No words to match */
+
 			for (X_node *x = sent->word[w].x; x != NULL; x = x->next)
 			{
-				insert_connectors(&ctxt, w, x->exp, '-');
+				insert_connectors(&ctxt, seq, x->exp, insert_dir);
 			}
 		}
+#undef WORD
 
-		DBG_EXPSIZES("r->l pass removed %d\n%s", ctxt.N_deleted, e);
+		DBG_EXPSIZES("%s pass removed %d\n%s", rl ? "r->l" : "l->r",
+		             ctxt.N_deleted, e);
 
-		if (ctxt.N_deleted == 0) break;
-		zero_connector_table(&ctxt);
-		ctxt.N_deleted = 0;
+		/* Always do at least 2 passes. */
+		if ((pass > 0) && (ctxt.N_deleted == 0)) break;
+
+		/* Stopping early is safe - it just leaves more to prune later. */
+		if (resources_exhausted(opts->resources)) break;
 	}
 
 	free_connector_table(&ctxt);
+	free(changed);
 
 	if (verbosity_level(D_PRINT_NUM_DISJUNCTS))
 	{
@@ -0,0 +1,446 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include "api-structures.h"
+#include "connectors.h"
+#include "dict-common/dict-structures.h"  // Exp_struct
+#include "dict-common/dict-common.h"      // IS_GENERATION
+#include "disjunct-utils.h"
+#include "memory-pool.h"
+#include "reuse-disjuncts.h"
+#include "tokenize/tok-structures.h"      // Gword_struct
+#include "tokenize/word-structures.h"     // Word_struct, X_node
+#include "utilities.h"                    // alloca
+
+/**
+ * Reuse of disjuncts between consecutive versions of an edited sentence.
+ *
+ * When a sentence is parsed by sentence_reparse(), the memory pools of
+ * its disjuncts are kept after they are packed for pruning, along with
+ * a record of the disjuncts that have been built for each word (in their
+ * original order, with their original cost and originating X_node).
+ *
+ * When the next version of the sentence is parsed by sentence_reparse()
+ * with that sentence as the previous one, it takes over these pools.
+ * A word that has the same dictionary words and the same pruned
+ * expressions as a word of the previous sentence then gets the recorded
+ * disjuncts of that word instead of building them. They are restored to
+ * their state just after being built (the later steps change their
+ * list links, costs and gword sets), and their originating gwords and
+ * word strings are set to those of the new word.
+ *
+ * The disjuncts of a word are determined by the structure of its pruned
+ * expressions and the cost cutoff, so the result is the same as that of
+ * sentence_parse(). Only the farthest_word values of the connectors
+ * depend on the word position and the sentence length; if needed, they
+ * are set from the expressions of the new word, according to the
+ * position of the originating connector in the expression (exp_pos,
+ * which is assigned in build_clause() by a depth-first traversal).
+ *
+ * The pools of each sentence version are a generation. Disjuncts are
+ * reused only from the last RECORD_GENERATIONS generations, and the
+ * older ones are freed. This bounds the memory held by a sequence of
+ * versions (in which unchanged words would otherwise never be rebuilt).
+ *
+ * Disjuncts are not reused for the SAT parser, in generation mode, and
+ * when max_disjuncts is set (because then disjuncts are discarded at
+ * random).
+ */
+
+#define D_REUSE 5 // Debug level for this module.
+#define RECORD_GENERATIONS 4
+
+typedef struct
+{
+	Disjunct *d;
+	float cost;           /* Its cost as built */
+	uint32_t x_index;     /* The originating X_node, by its list position */
+} Disjunct_ref;
+
+typedef struct
+{
+	const X_node *x;      /* The X_node list of the word */
+	size_t num_x;
+	size_t first, num;    /* Disjunct_ref range */
+	unsigned int gen;     /* Generation of the pools of the disjuncts */
+} Word_record;
+
+typedef struct
+{
+	Pool_desc *Disjunct_pool;
+	Pool_desc *Connector_pool;
+	unsigned int gen;
+} Pool_gen;
+
+struct Disjunct_record_s
+{
+	size_t length;        /* Sentence length */
+	float cost_cutoff;
+	unsigned int gen;     /* Generation of the sentence own pools */
+	bool complete;        /* The pools are kept (keep_disjunct_pools()) */
+	Word_record *word;
+	Disjunct_ref *ref;
+	size_t num_refs, refs_alloced;
+	Pool_gen pool[RECORD_GENERATIONS];
+	unsigned int num_pools;
+
+	/* While building the disjuncts. */
+	const Disjunct_record *prev; /* Of the previous sentence, if usable */
+	bool *taken;                 /* Previous sentence words already reused */
+};
+
+static bool disjunct_reuse_enabled(Sentence sent, Parse_Options opts)
+{
+	if (IS_GENERATION(sent->dict)) return false;
+	if (0 != opts->max_disjuncts) return false;
+#if USE_SAT_SOLVER
+	if (opts->use_sat_solver) return false;
+#endif /* USE_SAT_SOLVER */
+
+	return true;
+}
+
+static void reserve_refs(Disjunct_record *rec, size_t n)
+{
+	if (rec->num_refs + n <= rec->refs_alloced) return;
+
+	while (rec->num_refs + n > rec->refs_alloced)
+		rec->refs_alloced *= 2;
+	rec->ref = realloc(rec->ref, rec->refs_alloced * sizeof(*rec->ref));
+}
+
+/**
+ * Start recording the disjuncts of \p sent, for the use of the next
+ * sentence_reparse() that gets \p sent as the previous sentence.
+ * If \p sent is being reparsed, take over the pools of the previous
+ * sentence. To be called before the disjuncts are built.
+ */
+void start_disjunct_record(Sentence sent, float cost_cutoff,
+                           Parse_Options opts)
+{
+	free_disjunct_record(sent->disjunct_record);
+	sent->disjunct_record = NULL;
+	if (!sent->record_disjuncts || !disjunct_reuse_enabled(sent, opts))
+		return;
+
+	Disjunct_record *rec = malloc(sizeof(Disjunct_record));
+	*rec = (Disjunct_record)
+	{
+		.length = sent->length,
+		.cost_cutoff = cost_cutoff,
+		.word = calloc(sent->length, sizeof(*rec->word)),
+		.refs_alloced = 1024,
+	};
+	rec->ref = malloc(rec->refs_alloced * sizeof(*rec->ref));
+
+	for (WordIdx w = 0; w < sent->length; w++)
+	{
+		Word_record *wr = &rec->word[w];
+		wr->x = sent->word[w].x;
+		for (const X_node *x = wr->x; x != NULL; x = x->next) wr->num_x++;
+	}
+
+	Disjunct_record *prev_rec =
+		(NULL == sent->reparse_prev) ? NULL : sent->reparse_prev->disjunct_record;
+	if ((NULL != prev_rec) && prev_rec->complete &&
+	    (prev_rec->cost_cutoff == cost_cutoff))
+	{
+		rec->gen = prev_rec->gen + 1;
+		for (unsigned int i = 0; i < prev_rec->num_pools; i++)
+		{
+			Pool_gen *pg = &prev_rec->pool[i];
+			if (pg->gen + RECORD_GENERATIONS > rec->gen)
+			{
+				rec->pool[rec->num_pools++] = *pg;
+			}
+			else
+			{
+				pool_delete(pg->Disjunct_pool);
+				pool_delete(pg->Connector_pool);
+			}
+		}
+		prev_rec->num_pools = 0;
+		prev_rec->complete = false; /* Its disjuncts are taken */
+
+		rec->prev = prev_rec;
+		rec->taken = calloc(prev_rec->length, sizeof(bool));
+	}
+
+	sent->disjunct_record = rec;
+}
+
+/**
+ * Record the disjuncts \p d that have just been built for the
+ * \p x_index'th X_node of word \p w. The X_nodes of a word are to be
+ * recorded in their list order.
+ */
+void record_disjuncts(Sentence sent, WordIdx w, unsigned int x_index,
+                      Disjunct *d)
+{
+	Disjunct_record *rec = sent->disjunct_record;
+	if (NULL == rec) return;
+
+	Word_record *wr = &rec->word[w];
+	if (0 == x_index)
+	{
+		wr->first = rec->num_refs;
+		wr->gen = rec->gen;
+	}
+
+	for (; d != NULL; d = d->next)
+	{
+		reserve_refs(rec, 1);
+		rec->ref[rec->num_refs++] =
+			(Disjunct_ref){ .d = d, .cost = d->cost, .x_index = x_index };
+	}
+
+	wr->num = rec->num_refs - wr->first;
+}
+
+/**
+ * Keep the disjunct memory pools of \p sent (if it is being recorded)
+ * for the next sentence_reparse(). To be called when the disjuncts are
+ * not needed any more for parsing \p sent.
+ */
+void keep_disjunct_pools(Sentence sent)
+{
+	Disjunct_record *rec = sent->disjunct_record;
+	if ((NULL == rec) || (NULL == sent->Disjunct_pool)) return;
+
+	/* No longer charged to this sentence. */
+	pool_set_account(sent->Disjunct_pool, NULL);
+	pool_set_account(sent->Connector_pool, NULL);
+
+	rec->pool[rec->num_pools++] = (Pool_gen)
+	{
+		.Disjunct_pool = sent->Disjunct_pool,
+		.Connector_pool = sent->Connector_pool,
+		.gen = rec->gen,
+	};
+	sent->Disjunct_pool = NULL;
+	sent->Connector_pool = NULL;
+
+	rec->complete = true;
+	rec->prev = NULL;
+	free(rec->taken);
+	rec->taken = NULL;
+}
+
+void free_disjunct_record(Disjunct_record *rec)
+{
+	if (NULL == rec) return;
+
+	for (unsigned int i = 0; i < rec->num_pools; i++)
+	{
+		pool_delete(rec->pool[i].Disjunct_pool);
+		pool_delete(rec->pool[i].Connector_pool);
+	}
+	free(rec->taken);
+	free(rec->ref);
+	free(rec->word);
+	free(rec);
+}
+
+/**
+ * Return true if the expressions \p e1 and \p e2 generate the same
+ * disjuncts, up to the farthest_word of the connectors. The operands
+ * are compared in order. \p num_con is incremented by the number of
+ * connectors.
+ */
+static bool exp_equal(const Exp *e1, const Exp *e2, size_t *num_con)
+{
+	if (e1->type != e2->type) return false;
+	if (e1->cost != e2->cost) return false;
+
+	if (CONNECTOR_type == e1->type)
+	{
+		(*num_con)++;
+		return (e1->condesc == e2->condesc) &&
+		       (e1->dir == e2->dir) &&
+		       (e1->multi == e2->multi);
+	}
+
+	const Exp *o1 = e1->operand_first;
+	const Exp *o2 = e2->operand_first;
+	for (; (o1 != NULL) && (o2 != NULL); o1 = o1->operand_next, o2 = o2->operand_next)
+	{
+		if (!exp_equal(o1, o2, num_con)) return false;
+	}
+
+	return (o1 == NULL) && (o2 == NULL);
+}
+
+static bool word_equal(const X_node *x1, const X_node *x2, size_t *num_con)
+{
+	for (; (x1 != NULL) && (x2 != NULL); x1 = x1->next, x2 = x2->next)
+	{
+		if (0 != strcmp(x1->string, x2->string)) return false;
+		if (!exp_equal(x1->exp, x2->exp, num_con)) return false;
+	}
+
+	return (x1 == NULL) && (x2 == NULL);
+}
+
+/**
+ * Fill \p far with the farthest_word of the connectors of \p e, in the
+ * build_clause() traversal order (which defines exp_pos).
+ */
+static uint8_t *get_farthest_words(const Exp *e, uint8_t *far)
+{
+	if (CONNECTOR_type == e->type)
+	{
+		*far = e->farthest_word;
+		return far + 1;
+	}
+
+	for (const Exp *opd = e->operand_first; opd != NULL; opd = opd->operand_next)
+		far = get_farthest_words(opd, far);
+
+	return far;
+}
+
+/**
+ * Fill \p far with the farthest_word of the connectors of the X_node
+ * list \p x. If \p xfar is not NULL, set \p xfar[i] to the start of the
+ * i'th X_node in \p far.
+ */
+static void get_word_farthest_words(const X_node *x, uint8_t *far,
+                                    uint8_t **xfar)
+{
+	for (; x != NULL; x = x->next)
+	{
+		if (NULL != xfar) *xfar++ = far;
+		far = get_farthest_words(x->exp, far);
+	}
+}
+
+static void set_farthest_word(Connector *c, const uint8_t *far)
+{
+	for (; c != NULL; c = c->next)
+		c->farthest_word = far[c->exp_pos];
+}
+
+/**
+ * Restore the recorded disjuncts of word record \p wr to their state
+ * just after being built, as disjuncts of the X_node list \p x.
+ * If \p xfar is not NULL, also set the farthest_word of their
+ * connectors from it (\p xfar[i] is the table of the i'th X_node).
+ * Return the disjunct list, in the order of build_sentence_disjuncts().
+ */
+static Disjunct *restore_word_disjuncts(const Disjunct_record *rec,
+                                   const Word_record *wr, const X_node *x,
+                                   uint8_t **xfar)
+{
+	const X_node **xn = alloca(wr->num_x * sizeof(*xn));
+	Disjunct **xhead = alloca(wr->num_x * sizeof(*xhead));
+	Disjunct ***xtail = alloca(wr->num_x * sizeof(*xtail));
+	for (size_t i = 0; i < wr->num_x; i++, x = x->next)
+	{
+		xn[i] = x;
+		xhead[i] = NULL;
+		xtail[i] = &xhead[i];
+	}
+
+	const Disjunct_ref *ref = &rec->ref[wr->first];
+	for (size_t n = 0; n < wr->num; n++)
+	{
+		Disjunct *d = ref[n].d;
+		uint32_t xi = ref[n].x_index;
+
+		d->cost = ref[n].cost;
+		d->is_category = 0;
+		d->word_string = xn[xi]->string;
+		d->originating_gword = (gword_set *)&xn[xi]->word->gword_set_head;
+
+		if (NULL != xfar)
+		{
+			set_farthest_word(d->left, xfar[xi]);
+			set_farthest_word(d->right, xfar[xi]);
+		}
+
+		*xtail[xi] = d;
+		xtail[xi] = &d->next;
+	}
+
+	/* Like in build_sentence_disjuncts(), the disjuncts of the last
+	 * X_node come first. */
+	Disjunct *head = NULL;
+	for (size_t i = 0; i < wr->num_x; i++)
+	{
+		*xtail[i] = head;
+		head = xhead[i];
+	}
+
+	return head;
+}
+
+/**
+ * Find a word of the previous sentence that generates the same
+ * disjuncts as word \p w of \p sent, and take its disjuncts into \p dp.
+ * Try first the word at the same position, and then (for words after
+ * an insertion or a deletion) the one at the same distance from the
+ * sentence end.
+ * Return true on success.
+ */
+bool reuse_word_disjuncts(Sentence sent, WordIdx w, Disjunct **dp)
+{
+	Disjunct_record *rec = sent->disjunct_record;
+	if ((NULL == rec) || (NULL == rec->prev)) return false;
+	const Disjunct_record *prev_rec = rec->prev;
+
+	const X_node *x = sent->word[w].x;
+	if (NULL == x) return false;
+
+	int shift = (int)sent->length - (int)prev_rec->length;
+	int pw[] = { (int)w, (int)w - shift };
+
+	for (size_t i = 0; i < ((0 == shift) ? 1 : 2); i++)
+	{
+		if ((pw[i] < 0) || (pw[i] >= (int)prev_rec->length)) continue;
+		if (rec->taken[pw[i]]) continue;
+
+		const Word_record *pwr = &prev_rec->word[pw[i]];
+		if (pwr->gen + RECORD_GENERATIONS <= rec->gen) continue; /* Freed */
+
+		size_t num_con = 0;
+		if (!word_equal(pwr->x, x, &num_con)) continue;
+		if (num_con > UINT16_MAX) return false; /* exp_pos is 16 bits */
+
+		/* The farthest_word of the connectors needs to be set only if
+		 * it is different in the new word. */
+		uint8_t **xfar = malloc(pwr->num_x * sizeof(*xfar) + 2 * num_con);
+		uint8_t *far = (uint8_t *)(xfar + pwr->num_x);
+		uint8_t *prev_far = far + num_con;
+		get_word_farthest_words(x, far, xfar);
+		get_word_farthest_words(pwr->x, prev_far, NULL);
+		bool same_far = (0 == memcmp(far, prev_far, num_con));
+
+		*dp = restore_word_disjuncts(prev_rec, pwr, x, same_far ? NULL : xfar);
+		free(xfar);
+		rec->taken[pw[i]] = true;
+
+		/* Record the word. */
+		Word_record *wr = &rec->word[w];
+		wr->first = rec->num_refs;
+		wr->num = pwr->num;
+		wr->gen = pwr->gen;
+		reserve_refs(rec, pwr->num);
+		memcpy(&rec->ref[wr->first], &prev_rec->ref[pwr->first],
+		       pwr->num * sizeof(*rec->ref));
+		rec->num_refs += pwr->num;
+
+		lgdebug(+D_REUSE, "Word %zu: Reused word %d (%zu disjuncts)\n",
+		        w, pw[i], pwr->num);
+		return true;
+	}
+
+	return false;
+}
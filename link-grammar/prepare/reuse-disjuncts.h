@@ -0,0 +1,23 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _REUSE_DISJUNCTS_H
+#define _REUSE_DISJUNCTS_H
+
+#include "api-types.h"
+#include "link-includes.h"
+
+void start_disjunct_record(Sentence, float cost_cutoff, Parse_Options);
+void record_disjuncts(Sentence, WordIdx, unsigned int x_index, Disjunct *);
+bool reuse_word_disjuncts(Sentence, WordIdx, Disjunct **);
+void keep_disjunct_pools(Sentence);
+void free_disjunct_record(Disjunct_record *);
+#endif /* _REUSE_DISJUNCTS_H */
@@ -0,0 +1,1004 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#if HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef _WIN32
+#include <process.h>                    // _getpid
+#define getpid _getpid
+#else
+#include <unistd.h>                     // getpid
+#endif
+#if HAVE_THREADS_H
+#include <threads.h>                    // mtx_t
+#endif
+
+#include "api-structures.h"
+#include "connectors.h"
+#include "dict-common/dict-common.h"
+#include "dict-common/file-utils.h"     // join_path
+#include "disjunct-utils.h"
+#include "parse/parse.h"                // prune_once
+#include "prune-cache.h"
+#include "string-set.h"
+#include "tokenize/tok-structures.h"    // Gword, gword_set
+#include "tokenize/word-structures.h"   // Word_struct
+#include "utilities.h"
+
+/**
+ * A persistent on-disk cache of the pruned disjuncts of sentences.
+ *
+ * When a corpus is parsed again and again, e.g. with different linkage
+ * extraction or post-processing settings, the disjuncts that are left
+ * for parsing each sentence are the same each time. When this cache is
+ * enabled (see dictionary_set_prune_cache()), classic_parse() saves
+ * them in a file in the cache directory just after they are packed for
+ * parsing, and when the same sentence is parsed again it loads them
+ * from there instead of pruning the expressions and building, pruning
+ * and packing the disjuncts. When the pruning finds that the sentence
+ * cannot be parsed with the allowed null count, just that is saved.
+ *
+ * The file name is a hash of the cache key, which consists of the
+ * library version, the dictionary name and version, a fingerprint of
+ * its files and one of its connector table, the parse options that
+ * affect the disjuncts and their pruning, and the input string. The
+ * file also contains the full key, which is checked on lookup.
+ *
+ * The packed disjuncts and connectors point to connector descriptors
+ * and word strings of the dictionary, and to gword sets of the
+ * sentence wordgraph. In the file, these pointers are replaced by table
+ * indices: connector descriptors by their con_num, word strings by a
+ * string table index, and gword sets by an index into a table of sets
+ * of wordgraph word node numbers. The order of the disjuncts and
+ * connectors, the tracon sharing and the tracon IDs are kept as is.
+ * Hence the packed disjunct and connector memory block is rebuilt by
+ * a single pass over the (memory-mapped) file, and it goes directly to
+ * the fast matcher and do_parse().
+ *
+ * The sentence is still tokenized, since its wordgraph is needed for
+ * the linkages; the tokenization is checked against a signature in the
+ * file. The cache is used only when classic_parse() prunes the
+ * disjuncts once (see prune_once()), and not for the SAT parser, in
+ * generation mode, with dynamic dictionaries, when max_disjuncts or
+ * adaptive_cost is set, or with random morphology that is not
+ * repeatable.
+ *
+ * The fingerprint of the dictionary files is a hash of their content
+ * (see dictopen_fingerprint()), so an edited dictionary misses the
+ * entries of its previous content. They are not removed; the cache
+ * directory may be emptied at any time.
+ *
+ * Since the files may be damaged or stale, a file is used only if its
+ * checksum is right, and everything that the parser uses as an index
+ * (disjunct and connector links, tracon IDs, word numbers and table
+ * indices) is in range.
+ */
+
+#define D_PC 6 /* Debug level for this file. */
+
+#define PC_MAGIC "LGpc"
+#define PC_FORMAT 2
+#define PC_FILE_EXT ".lgpc"
+#define PC_ALIGN 8
+
+struct Prune_cache_s
+{
+	char *dir;                     /* Cache directory */
+	const condesc_t **desc;        /* Connector descriptors by con_num */
+	size_t num_con;
+	uint64_t con_fingerprint;      /* Of the connector table */
+	size_t hits;
+	size_t misses;
+#if HAVE_THREADS_H
+	mtx_t mutex;
+#endif
+};
+
+/* Cache file header. It is followed by the sections of pc_layout. */
+typedef struct
+{
+	char magic[4];
+	uint32_t format;
+	uint32_t key_size;             /* Including the terminating NUL */
+	uint32_t length;               /* Sentence length */
+	uint32_t num_gwords;           /* Wordgraph words (gword_node_num) */
+	uint32_t expected_null_count;  /* As returned by pp_and_power_prune() */
+	uint32_t parsed;               /* 0: No disjuncts (not to be parsed) */
+	uint32_t num_disjuncts;
+	uint32_t num_connectors;
+	int32_t next_id[2];            /* Of the tracon IDs */
+	uint32_t num_gword_sets;
+	uint32_t num_gword_set_elements;
+	uint32_t num_strings;
+	uint32_t strings_size;
+	uint32_t unused;
+	uint64_t wordgraph_signature;
+	uint64_t checksum;             /* Of the file, with this field as 0 */
+} pc_header;
+
+/* Disjunct and connector pointers are stored as index+1 (0 for NULL). */
+typedef struct
+{
+	uint32_t next;
+	uint32_t left, right;
+	uint32_t gword_set;            /* Gword set table index */
+	uint32_t word_string;          /* String table index */
+	float cost;
+} pc_disjunct;
+
+typedef struct
+{
+	uint8_t farthest_word;
+	uint8_t nearest_word;
+	uint8_t prune_pass;
+	uint8_t multi;
+	int32_t tracon_id;
+	uint32_t con_num;
+	uint32_t next;
+} pc_connector;
+
+/* Section offsets in the cache file. */
+typedef struct
+{
+	uint64_t key;                  /* char[key_size] */
+	uint64_t ncu;                  /* uint32_t[2][length] */
+	uint64_t word;                 /* First disjunct, uint32_t[length] */
+	uint64_t disjunct;             /* pc_disjunct[num_disjuncts] */
+	uint64_t connector;            /* pc_connector[num_connectors] */
+	uint64_t gword_set;            /* Start, uint32_t[num_gword_sets+1] */
+	uint64_t gword_set_element;    /* Node number, uint32_t[] */
+	uint64_t string;               /* Start, uint32_t[num_strings] */
+	uint64_t strings;              /* char[strings_size] */
+	uint64_t end;                  /* File size */
+} pc_layout;
+
+struct Prune_cache_entry_s
+{
+	char *key;
+	char *path;                    /* Of the cache file */
+	const char *data;              /* The cache file, if found */
+	size_t size;
+};
+
+static void pc_lock(Prune_cache *pc)
+{
+#if HAVE_THREADS_H
+	mtx_lock(&pc->mutex);
+#endif
+}
+
+static void pc_unlock(Prune_cache *pc)
+{
+#if HAVE_THREADS_H
+	mtx_unlock(&pc->mutex);
+#endif
+}
+
+/* ======================================================================== */
+/* Utilities. */
+
+#define FNV_OFFSET_BASIS UINT64_C(14695981039346656037)
+#define FNV_PRIME UINT64_C(1099511628211)
+
+static uint64_t fnv_hash(uint64_t h, const char *s, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		h ^= (unsigned char)s[i];
+		h *= FNV_PRIME;
+	}
+	return h;
+}
+
+/**
+ * The checksum of a cache file of \p size bytes (a multiple of
+ * PC_ALIGN). The checksum field of its header is taken as 0.
+ */
+static uint64_t file_checksum(const char *data, uint64_t size)
+{
+	pc_header h;
+	memcpy(&h, data, sizeof(h));
+	h.checksum = 0;
+
+	uint64_t c = fnv_hash(FNV_OFFSET_BASIS, (const char *)&h, sizeof(h));
+	/* A word at a time, as the files may be large. */
+	for (uint64_t i = ALIGN(sizeof(h), PC_ALIGN); i < size; i += PC_ALIGN)
+	{
+		uint64_t w;
+		memcpy(&w, data + i, sizeof(w));
+		c = (c ^ w) * FNV_PRIME;
+	}
+
+	return c;
+}
+
+static void get_layout(const pc_header *h, pc_layout *l)
+{
+	uint64_t off = ALIGN(sizeof(pc_header), PC_ALIGN);
+
+#define SECTION(name, size) \
+	l->name = off; off = ALIGN(off + (uint64_t)(size), PC_ALIGN);
+
+	SECTION(key, h->key_size);
+	SECTION(ncu, 2 * (uint64_t)h->length * sizeof(uint32_t));
+	SECTION(word, (uint64_t)h->length * sizeof(uint32_t));
+	SECTION(disjunct, (uint64_t)h->num_disjuncts * sizeof(pc_disjunct));
+	SECTION(connector, (uint64_t)h->num_connectors * sizeof(pc_connector));
+	SECTION(gword_set, ((uint64_t)h->num_gword_sets + 1) * sizeof(uint32_t));
+	SECTION(gword_set_element,
+	        (uint64_t)h->num_gword_set_elements * sizeof(uint32_t));
+	SECTION(string, (uint64_t)h->num_strings * sizeof(uint32_t));
+	SECTION(strings, h->strings_size);
+#undef SECTION
+
+	l->end = off;
+}
+
+/** A signature of the tokenization, for validating the cached data. */
+static uint64_t wordgraph_signature(Sentence sent)
+{
+	uint64_t h = FNV_OFFSET_BASIS;
+
+	for (Gword *w = sent->wordgraph; NULL != w; w = w->chain_next)
+		h = fnv_hash(h, w->subword, strlen(w->subword) + 1);
+
+	return h;
+}
+
+/** The gwords of the sentence, indexed by their node_num. */
+static Gword **gwords_by_node_num(Sentence sent)
+{
+	Gword **gw = calloc(sent->gword_node_num, sizeof(Gword *));
+
+	for (Gword *w = sent->wordgraph; NULL != w; w = w->chain_next)
+	{
+		if (w->node_num < sent->gword_node_num) gw[w->node_num] = w;
+	}
+
+	return gw;
+}
+
+/* Pointer to index mapping, for building the string and gword set tables. */
+typedef struct
+{
+	const void **key;              /* In the order of their index */
+	uint32_t *slot;                /* Hash table of index+1 (0: empty) */
+	size_t slot_size;              /* A power of 2 */
+	size_t count;
+} ptr_index;
+
+static size_t ptr_hash(const void *p, size_t size)
+{
+	return (size_t)(((uintptr_t)p >> 3) * FIBONACCI_MULT) & (size - 1);
+}
+
+static uint32_t ptr_index_get(ptr_index *pi, const void *key)
+{
+	if (2 * (pi->count + 1) > pi->slot_size)
+	{
+		free(pi->slot);
+		pi->slot_size = (0 == pi->slot_size) ? 256 : 2 * pi->slot_size;
+		pi->slot = calloc(pi->slot_size, sizeof(*pi->slot));
+		pi->key = realloc(pi->key, pi->slot_size * sizeof(*pi->key));
+		for (size_t i = 0; i < pi->count; i++)
+		{
+			size_t h = ptr_hash(pi->key[i], pi->slot_size);
+			while (0 != pi->slot[h]) h = (h + 1) & (pi->slot_size - 1);
+			pi->slot[h] = (uint32_t)i + 1;
+		}
+	}
+
+	size_t h = ptr_hash(key, pi->slot_size);
+	while (0 != pi->slot[h])
+	{
+		if (pi->key[pi->slot[h] - 1] == key) return pi->slot[h] - 1;
+		h = (h + 1) & (pi->slot_size - 1);
+	}
+
+	pi->key[pi->count] = key;
+	pi->slot[h] = (uint32_t)++pi->count;
+	return pi->slot[h] - 1;
+}
+
+static void ptr_index_free(ptr_index *pi)
+{
+	free(pi->key);
+	free(pi->slot);
+}
+
+/* ======================================================================== */
+/* Cache files. */
+
+static const char *map_file(const char *path, size_t *size)
+{
+#if HAVE_SYS_MMAN_H
+	int fd = open(path, O_RDONLY);
+	if (-1 == fd) return NULL;
+
+	struct stat st;
+	void *data = MAP_FAILED;
+	if ((0 == fstat(fd, &st)) && (st.st_size >= (off_t)sizeof(pc_header)))
+	{
+		*size = (size_t)st.st_size;
+		data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	close(fd);
+
+	return (MAP_FAILED == data) ? NULL : data;
+#else
+	FILE *f = fopen(path, "rb");
+	if (NULL == f) return NULL;
+
+	char *data = NULL;
+	long fsize;
+	if ((0 == fseek(f, 0, SEEK_END)) && (0 <= (fsize = ftell(f))) &&
+	    ((size_t)fsize >= sizeof(pc_header)) && (0 == fseek(f, 0, SEEK_SET)))
+	{
+		*size = (size_t)fsize;
+		data = malloc(*size);
+		if (fread(data, 1, *size, f) != *size)
+		{
+			free(data);
+			data = NULL;
+		}
+	}
+	fclose(f);
+
+	return data;
+#endif
+}
+
+static void unmap_file(const char *data, size_t size)
+{
+	if (NULL == data) return;
+#if HAVE_SYS_MMAN_H
+	munmap((void *)data, size);
+#else
+	free((void *)data);
+#endif
+}
+
+/**
+ * Write the file atomically, so a concurrent reader sees either the
+ * whole file or none.
+ */
+static void write_file(const char *path, const void *data, size_t size)
+{
+	char suffix[64];
+	snprintf(suffix, sizeof(suffix), ".%d-%p.tmp", (int)getpid(), data);
+	dyn_str *tmp = dyn_str_new();
+	dyn_strcat(tmp, path);
+	dyn_strcat(tmp, suffix);
+	char *tmp_path = dyn_str_take(tmp);
+
+	FILE *f = fopen(tmp_path, "wb");
+	if (NULL == f)
+	{
+		lgdebug(+D_PC, "Cannot create %s\n", tmp_path);
+		free(tmp_path);
+		return;
+	}
+
+	bool ok = (fwrite(data, 1, size, f) == size);
+	ok = (0 == fclose(f)) && ok;
+	if (!ok || (0 != rename(tmp_path, path)))
+	{
+		lgdebug(+D_PC, "Cannot write %s\n", path);
+		remove(tmp_path);
+	}
+	free(tmp_path);
+}
+
+/**
+ * Check the connector list that starts at \p ci (index+1, 0 for none),
+ * in direction \p dir: its length (so a damaged file cannot make it
+ * circular), and the tracon IDs and word numbers of its connectors,
+ * which the parser uses as table indices.
+ */
+static bool validate_connectors(Sentence sent, const pc_header *h,
+                                const pc_connector *pc, uint32_t ci, int dir)
+{
+	for (size_t n = 0; 0 != ci; ci = pc[ci-1].next)
+	{
+		const pc_connector *c = &pc[ci-1];
+
+		if (++n > h->num_connectors) return false;
+		if ((c->tracon_id < NULL_TRACON_BLOCK) ||
+		    (c->tracon_id >= h->next_id[dir]) ||
+		    (c->nearest_word >= sent->length) ||
+		    (c->farthest_word >= sent->length))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Check that the cache file of \p pce is for \p sent, and that all its
+ * indices are in range.
+ */
+static bool validate(Sentence sent, const Prune_cache_entry *pce)
+{
+	const pc_header *h = (const pc_header *)pce->data;
+	pc_layout l;
+
+	if ((0 != memcmp(h->magic, PC_MAGIC, sizeof(h->magic))) ||
+	    (PC_FORMAT != h->format))
+		return false;
+	get_layout(h, &l);
+	if (l.end != pce->size) return false;
+	if (h->checksum != file_checksum(pce->data, l.end)) return false;
+
+	if ((strlen(pce->key) + 1 != h->key_size) ||
+	    (0 != memcmp(pce->data + l.key, pce->key, h->key_size)))
+		return false; /* A hash collision */
+
+	if ((h->length != sent->length) ||
+	    (h->num_gwords != sent->gword_node_num) ||
+	    (h->wordgraph_signature != wordgraph_signature(sent)))
+		return false;
+
+	if (!h->parsed) return true;
+
+	const uint32_t *word = (const uint32_t *)(pce->data + l.word);
+	for (size_t w = 0; w < h->length; w++)
+		if (word[w] > h->num_disjuncts) return false;
+
+	const pc_disjunct *pd = (const pc_disjunct *)(pce->data + l.disjunct);
+	for (size_t i = 0; i < h->num_disjuncts; i++)
+	{
+		if ((pd[i].next > h->num_disjuncts) ||
+		    (pd[i].left > h->num_connectors) ||
+		    (pd[i].right > h->num_connectors) ||
+		    (pd[i].gword_set >= h->num_gword_sets) ||
+		    (pd[i].word_string >= h->num_strings))
+			return false;
+	}
+
+	const pc_connector *pc = (const pc_connector *)(pce->data + l.connector);
+	size_t num_con = sent->dict->prune_cache->num_con;
+	for (size_t i = 0; i < h->num_connectors; i++)
+	{
+		if ((pc[i].next > h->num_connectors) || (pc[i].con_num >= num_con))
+			return false;
+	}
+
+	/* The tracon IDs are numbered per direction from NULL_TRACON_BLOCK
+	 * (see prune_cache_load()). */
+	for (int dir = 0; dir < 2; dir++)
+	{
+		if ((h->next_id[dir] < NULL_TRACON_BLOCK) ||
+		    ((uint32_t)(h->next_id[dir] - NULL_TRACON_BLOCK) > h->num_connectors))
+			return false;
+	}
+	for (size_t w = 0; w < h->length; w++)
+	{
+		size_t n = 0;
+		for (uint32_t di = word[w]; 0 != di; di = pd[di-1].next)
+		{
+			if (++n > h->num_disjuncts) return false; /* Circular */
+			if (!validate_connectors(sent, h, pc, pd[di-1].left, 0) ||
+			    !validate_connectors(sent, h, pc, pd[di-1].right, 1))
+				return false;
+		}
+	}
+
+	const uint32_t *gset = (const uint32_t *)(pce->data + l.gword_set);
+	const uint32_t *gnum = (const uint32_t *)(pce->data + l.gword_set_element);
+	if ((0 != gset[0]) || (h->num_gword_set_elements != gset[h->num_gword_sets]))
+		return false;
+	for (size_t i = 0; i < h->num_gword_sets; i++)
+	{
+		if (gset[i] >= gset[i+1]) return false; /* Empty or decreasing */
+	}
+	for (size_t i = 0; i < h->num_gword_set_elements; i++)
+	{
+		if (gnum[i] >= h->num_gwords) return false;
+	}
+
+	const uint32_t *string = (const uint32_t *)(pce->data + l.string);
+	const char *strings = pce->data + l.strings;
+	if ((0 == h->strings_size) || ('\0' != strings[h->strings_size - 1]))
+		return false;
+	for (size_t i = 0; i < h->num_strings; i++)
+	{
+		if (string[i] >= h->strings_size) return false;
+	}
+
+	return true;
+}
+
+/* ======================================================================== */
+/* The interface to sentence_parse() and classic_parse(). */
+
+static bool prune_cache_enabled(Sentence sent, Parse_Options opts)
+{
+	Dictionary dict = sent->dict;
+
+	if (NULL == dict->prune_cache) return false;
+	if (IS_GENERATION(dict) || IS_DYNAMIC_DICT(dict)) return false;
+	if (0 != opts->max_disjuncts) return false;
+	/* The disjuncts may need to be pruned again with a lower cost cutoff. */
+	if (opts->adaptive_cost) return false;
+#if USE_SAT_SOLVER
+	if (opts->use_sat_solver) return false;
+#endif
+	if (!opts->repeatable_rand && (NULL != dict->affix_table) &&
+	    (NULL != dict->affix_table->anysplit))
+		return false;
+	/* The connectors are stored by their con_num. */
+	if (dict->contable.num_con != dict->prune_cache->num_con) return false;
+
+	return prune_once(sent, opts);
+}
+
+/**
+ * Return the cache key of the sentence.
+ * It consists of the dictionary and parse options that may affect the
+ * pruned disjuncts, and the input string.
+ */
+static char *prune_cache_key(Sentence sent, Parse_Options opts)
+{
+	Dictionary dict = sent->dict;
+	char buf[256];
+	dyn_str *key = dyn_str_new();
+
+	snprintf(buf, sizeof(buf),
+	         "%s %zu %zu %016" PRIx64 " %016" PRIx64
+	         " %a %d %d %d %zu %d %d %d %d",
+	         LINK_VERSION_STRING, sizeof(Disjunct), sizeof(Connector),
+	         dict->file_fingerprint, dict->prune_cache->con_fingerprint,
+	         opts->disjunct_cost, opts->min_null_count, opts->max_null_count,
+	         opts->islands_ok, opts->short_length, opts->all_short,
+	         opts->repeatable_rand, opts->perform_pp_prune,
+	         opts->use_spell_guess);
+	dyn_strcat(key, buf);
+	dyn_strcat(key, "\x1f");
+	dyn_strcat(key, dict->name);
+	dyn_strcat(key, "\x1f");
+	if (NULL != dict->version) dyn_strcat(key, dict->version);
+	dyn_strcat(key, "\x1f");
+	if (NULL != opts->dialect.conf) dyn_strcat(key, opts->dialect.conf);
+	dyn_strcat(key, "\x1f");
+	dyn_strcat(key, opts->test);
+	dyn_strcat(key, "\x1f");
+	dyn_strcat(key, sent->orig_sentence);
+
+	return dyn_str_take(key);
+}
+
+/**
+ * Look up the pruned disjuncts of the sentence in the cache, if it is
+ * enabled. If they are found, classic_parse() loads them (see
+ * prune_cache_load()), else it stores them (see prune_cache_store()).
+ * Either way, the lookup result is kept in the sentence until then.
+ */
+void prune_cache_lookup(Sentence sent, Parse_Options opts)
+{
+	/* From a previous parse that has not got to use it. */
+	prune_cache_entry_delete(sent->prune_cache_entry);
+	sent->prune_cache_entry = NULL;
+
+	if (!prune_cache_enabled(sent, opts)) return;
+
+	Prune_cache *pc = sent->dict->prune_cache;
+	Prune_cache_entry *pce = malloc(sizeof(Prune_cache_entry));
+	memset(pce, 0, sizeof(Prune_cache_entry));
+
+	pce->key = prune_cache_key(sent, opts);
+	uint64_t h = fnv_hash(FNV_OFFSET_BASIS, pce->key, strlen(pce->key));
+
+	char name[32];
+	snprintf(name, sizeof(name), "%016" PRIx64 PC_FILE_EXT, h);
+	pce->path = join_path(pc->dir, name);
+
+	pce->data = map_file(pce->path, &pce->size);
+	if ((NULL != pce->data) && !validate(sent, pce))
+	{
+		lgdebug(+D_PC, "Invalid or stale %s\n", pce->path);
+		unmap_file(pce->data, pce->size);
+		pce->data = NULL;
+	}
+
+	pc_lock(pc);
+	if (NULL != pce->data)
+		pc->hits++;
+	else
+		pc->misses++;
+	pc_unlock(pc);
+
+	lgdebug(+D_PC, "%s: %s\n", (NULL != pce->data) ? "Hit" : "Miss", pce->path);
+
+	sent->prune_cache_entry = pce;
+}
+
+/** Return true if prune_cache_lookup() has found the sentence. */
+bool prune_cache_found(Sentence sent)
+{
+	Prune_cache_entry *pce = sent->prune_cache_entry;
+	return (NULL != pce) && (NULL != pce->data);
+}
+
+/**
+ * If the pruned disjuncts of the sentence have been found in the cache,
+ * make them the sentence disjuncts. Also get the power pruning results.
+ *
+ * @param ts Set to the tracon sharing descriptor of the disjuncts, like
+ * the one returned by pack_sentence_for_parsing(), or to NULL if the
+ * sentence is not to be parsed.
+ * @param ncu Set to the number of connectors per word, as set by
+ * pp_and_power_prune().
+ * @param expected_null_count Set to the return value of
+ * pp_and_power_prune().
+ * @return True if found.
+ */
+bool prune_cache_load(Sentence sent, Tracon_sharing **ts,
+                      unsigned int *ncu[2], unsigned int *expected_null_count)
+{
+	if (!prune_cache_found(sent)) return false;
+	Prune_cache_entry *pce = sent->prune_cache_entry;
+
+	const pc_header *h = (const pc_header *)pce->data;
+	pc_layout l;
+	get_layout(h, &l);
+
+	*expected_null_count = h->expected_null_count;
+	*ts = NULL;
+
+	if (h->parsed)
+	{
+		const uint32_t *cncu = (const uint32_t *)(pce->data + l.ncu);
+		for (size_t w = 0; w < sent->length; w++)
+		{
+			ncu[0][w] = cncu[w];
+			ncu[1][w] = cncu[sent->length + w];
+		}
+
+		/* Gword sets. */
+		Gword **gw = gwords_by_node_num(sent);
+		const uint32_t *gset = (const uint32_t *)(pce->data + l.gword_set);
+		const uint32_t *gnum =
+			(const uint32_t *)(pce->data + l.gword_set_element);
+		gword_set **gword_sets = malloc(h->num_gword_sets * sizeof(gword_set *));
+		Gword **set_gw = malloc(sent->gword_node_num * sizeof(Gword *));
+		for (size_t i = 0; i < h->num_gword_sets; i++)
+		{
+			size_t n = 0;
+			for (uint32_t e = gset[i]; e < gset[i+1]; e++)
+				set_gw[n++] = gw[gnum[e]];
+			gword_sets[i] = gword_set_new(set_gw, n);
+		}
+		free(set_gw);
+		free(gw);
+
+		/* Word strings. */
+		const uint32_t *string = (const uint32_t *)(pce->data + l.string);
+		const char *strings = pce->data + l.strings;
+		const char **word_string = malloc(h->num_strings * sizeof(char *));
+		for (size_t i = 0; i < h->num_strings; i++)
+			word_string[i] = string_set_add(strings + string[i], sent->string_set);
+
+		/* The disjunct and connector memory block, as allocated by
+		 * pack_sentence_init(). */
+		size_t dsize = h->num_disjuncts * sizeof(Disjunct);
+		if (sizeof(Disjunct) != 64)
+			dsize = ALIGN(dsize, sizeof(Connector));
+		size_t memblock_sz = dsize + h->num_connectors * sizeof(Connector);
+		Disjunct *dblock = malloc(memblock_sz);
+		Connector *cblock = (Connector *)((char *)dblock + dsize);
+
+		const condesc_t **desc = sent->dict->prune_cache->desc;
+		const pc_connector *pcon =
+			(const pc_connector *)(pce->data + l.connector);
+		for (size_t i = 0; i < h->num_connectors; i++)
+		{
+			cblock[i] = (Connector)
+			{
+				.farthest_word = pcon[i].farthest_word,
+				.nearest_word = pcon[i].nearest_word,
+				.prune_pass = pcon[i].prune_pass,
+				.multi = pcon[i].multi,
+				.tracon_id = pcon[i].tracon_id,
+				.desc = desc[pcon[i].con_num],
+				.next = (0 == pcon[i].next) ? NULL : &cblock[pcon[i].next - 1],
+			};
+		}
+
+		const pc_disjunct *pd = (const pc_disjunct *)(pce->data + l.disjunct);
+		for (size_t i = 0; i < h->num_disjuncts; i++)
+		{
+			dblock[i] = (Disjunct)
+			{
+				.next = (0 == pd[i].next) ? NULL : &dblock[pd[i].next - 1],
+				.left = (0 == pd[i].left) ? NULL : &cblock[pd[i].left - 1],
+				.right = (0 == pd[i].right) ? NULL : &cblock[pd[i].right - 1],
+				.originating_gword = gword_sets[pd[i].gword_set],
+				.cost = pd[i].cost,
+				.word_string = word_string[pd[i].word_string],
+			};
+		}
+		free(word_string);
+		free(gword_sets);
+
+		const uint32_t *word = (const uint32_t *)(pce->data + l.word);
+		for (size_t w = 0; w < sent->length; w++)
+		{
+			Disjunct *d = (0 == word[w]) ? NULL : &dblock[word[w] - 1];
+			sent->word[w].d = d;
+			sent->word[w].num_disjuncts = count_disjuncts(d);
+		}
+
+		if (NULL != sent->dc_memblock) free(sent->dc_memblock);
+		sent->dc_memblock = dblock;
+		sent->num_disjuncts = h->num_disjuncts;
+
+		Tracon_sharing *t = malloc(sizeof(Tracon_sharing));
+		memset(t, 0, sizeof(Tracon_sharing));
+		t->memblock = dblock;
+		t->memblock_sz = memblock_sz;
+		t->cblock_base = cblock;
+		t->cblock = cblock + h->num_connectors;
+		t->dblock = dblock + h->num_disjuncts;
+		t->num_disjuncts = h->num_disjuncts;
+		t->num_connectors = h->num_connectors;
+		t->next_id[0] = h->next_id[0];
+		t->next_id[1] = h->next_id[1];
+		t->word_offset = NULL_TRACON_BLOCK;
+		*ts = t;
+	}
+
+	prune_cache_entry_delete(pce);
+	sent->prune_cache_entry = NULL;
+	return true;
+}
+
+/**
+ * Store the pruned disjuncts of the sentence in the cache, if it has
+ * not been found there by prune_cache_lookup().
+ *
+ * @param ts The tracon sharing descriptor returned by
+ * pack_sentence_for_parsing(), or NULL if the sentence is not parsed.
+ * @param expected_null_count As returned by pp_and_power_prune().
+ * @param ncu As set by pp_and_power_prune() (NULL if \p ts is NULL).
+ */
+void prune_cache_store(Sentence sent, Tracon_sharing *ts,
+                       unsigned int expected_null_count, unsigned int *ncu[2])
+{
+	Prune_cache_entry *pce = sent->prune_cache_entry;
+	if (NULL == pce) return;
+	sent->prune_cache_entry = NULL;
+
+	pc_header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, PC_MAGIC, sizeof(h.magic));
+	h.format = PC_FORMAT;
+	h.key_size = (uint32_t)strlen(pce->key) + 1;
+	h.length = (uint32_t)sent->length;
+	h.num_gwords = (uint32_t)sent->gword_node_num;
+	h.expected_null_count = expected_null_count;
+	h.wordgraph_signature = wordgraph_signature(sent);
+
+	Disjunct *dblock = sent->dc_memblock;
+	ptr_index gword_sets = {0}, strings = {0};
+	uint32_t *dgset = NULL, *dstring = NULL;
+
+	if (NULL != ts)
+	{
+		h.parsed = 1;
+		h.num_disjuncts = sent->num_disjuncts;
+		h.num_connectors = (uint32_t)(ts->cblock - ts->cblock_base);
+		h.next_id[0] = ts->next_id[0];
+		h.next_id[1] = ts->next_id[1];
+
+		dgset = malloc(h.num_disjuncts * sizeof(uint32_t));
+		dstring = malloc(h.num_disjuncts * sizeof(uint32_t));
+		for (size_t i = 0; i < h.num_disjuncts; i++)
+		{
+			dgset[i] = ptr_index_get(&gword_sets, dblock[i].originating_gword);
+			dstring[i] = ptr_index_get(&strings, dblock[i].word_string);
+		}
+
+		h.num_gword_sets = (uint32_t)gword_sets.count;
+		for (size_t i = 0; i < gword_sets.count; i++)
+		{
+			for (const gword_set *g = gword_sets.key[i]; NULL != g; g = g->next)
+				h.num_gword_set_elements++;
+		}
+		h.num_strings = (uint32_t)strings.count;
+	}
+	for (size_t i = 0; i < strings.count; i++)
+		h.strings_size += (uint32_t)strlen(strings.key[i]) + 1;
+	if (0 == h.strings_size) h.strings_size = 1;
+
+	pc_layout l;
+	get_layout(&h, &l);
+	char *data = calloc(1, l.end);
+	memcpy(data, &h, sizeof(h));
+	memcpy(data + l.key, pce->key, h.key_size);
+
+	if (NULL != ts)
+	{
+		uint32_t *cncu = (uint32_t *)(data + l.ncu);
+		uint32_t *word = (uint32_t *)(data + l.word);
+		for (size_t w = 0; w < sent->length; w++)
+		{
+			cncu[w] = ncu[0][w];
+			cncu[sent->length + w] = ncu[1][w];
+			Disjunct *d = sent->word[w].d;
+			word[w] = (NULL == d) ? 0 : (uint32_t)(d - dblock) + 1;
+		}
+
+		Connector *cblock = ts->cblock_base;
+		pc_disjunct *pd = (pc_disjunct *)(data + l.disjunct);
+		for (size_t i = 0; i < h.num_disjuncts; i++)
+		{
+			const Disjunct *d = &dblock[i];
+			pd[i] = (pc_disjunct)
+			{
+				.next = (NULL == d->next) ? 0 : (uint32_t)(d->next - dblock) + 1,
+				.left = (NULL == d->left) ? 0 : (uint32_t)(d->left - cblock) + 1,
+				.right = (NULL == d->right) ? 0 : (uint32_t)(d->right - cblock) + 1,
+				.gword_set = dgset[i],
+				.word_string = dstring[i],
+				.cost = d->cost,
+			};
+		}
+
+		pc_connector *pcon = (pc_connector *)(data + l.connector);
+		for (size_t i = 0; i < h.num_connectors; i++)
+		{
+			const Connector *c = &cblock[i];
+			pcon[i] = (pc_connector)
+			{
+				.farthest_word = c->farthest_word,
+				.nearest_word = c->nearest_word,
+				.prune_pass = c->prune_pass,
+				.multi = c->multi,
+				.tracon_id = c->tracon_id,
+				.con_num = c->desc->con_num,
+				.next = (NULL == c->next) ? 0 : (uint32_t)(c->next - cblock) + 1,
+			};
+		}
+
+		uint32_t *gset = (uint32_t *)(data + l.gword_set);
+		uint32_t *gnum = (uint32_t *)(data + l.gword_set_element);
+		uint32_t e = 0;
+		for (size_t i = 0; i < gword_sets.count; i++)
+		{
+			gset[i] = e;
+			for (const gword_set *g = gword_sets.key[i]; NULL != g; g = g->next)
+				gnum[e++] = (uint32_t)g->o_gword->node_num;
+		}
+		gset[gword_sets.count] = e;
+
+		uint32_t *string = (uint32_t *)(data + l.string);
+		uint32_t offset = 0;
+		for (size_t i = 0; i < strings.count; i++)
+		{
+			size_t len = strlen(strings.key[i]) + 1;
+			string[i] = offset;
+			memcpy(data + l.strings + offset, strings.key[i], len);
+			offset += (uint32_t)len;
+		}
+	}
+
+	((pc_header *)data)->checksum = file_checksum(data, l.end);
+	write_file(pce->path, data, l.end);
+	lgdebug(+D_PC, "Stored %s (%" PRIu64 " bytes)\n", pce->path, l.end);
+
+	free(data);
+	free(dgset);
+	free(dstring);
+	ptr_index_free(&gword_sets);
+	ptr_index_free(&strings);
+	prune_cache_entry_delete(pce);
+}
+
+void prune_cache_entry_delete(Prune_cache_entry *pce)
+{
+	if (NULL == pce) return;
+
+	unmap_file(pce->data, pce->size);
+	free(pce->path);
+	free(pce->key);
+	free(pce);
+}
+
+void prune_cache_delete(Dictionary dict)
+{
+	Prune_cache *pc = dict->prune_cache;
+	if (NULL == pc) return;
+
+#if HAVE_THREADS_H
+	mtx_destroy(&pc->mutex);
+#endif
+	free(pc->desc);
+	free(pc->dir);
+	free(pc);
+	dict->prune_cache = NULL;
+}
+
+/* ======================================================================== */
+/* The API. */
+
+/**
+ * Set the directory of the persistent cache of pruned disjuncts of the
+ * sentences parsed with this dictionary. The directory should exist.
+ * A NULL or empty \p dir disables the cache (the files in the directory
+ * are kept). The cache is initially disabled.
+ */
+void dictionary_set_prune_cache(Dictionary dict, const char *dir)
+{
+	if (NULL == dict) return;
+
+	prune_cache_delete(dict);
+	if ((NULL == dir) || ('\0' == dir[0])) return;
+
+	if (IS_DYNAMIC_DICT(dict))
+	{
+		prt_error("Warning: Dictionary %s: "
+		          "The prune cache is not supported for dynamic dictionaries.\n",
+		          dict->name);
+		return;
+	}
+
+	Prune_cache *pc = malloc(sizeof(Prune_cache));
+	memset(pc, 0, sizeof(Prune_cache));
+#if HAVE_THREADS_H
+	mtx_init(&pc->mutex, mtx_plain);
+#endif
+	pc->dir = strdup(dir);
+
+	/* The cache files refer to connector descriptors by their con_num,
+	 * which depends on the dictionary, so they are valid only for a
+	 * connector table with the same fingerprint. */
+	ConTable *ct = &dict->contable;
+	pc->num_con = ct->num_con;
+	pc->desc = malloc(MAX(ct->num_con, 1) * sizeof(condesc_t *));
+	memcpy(pc->desc, ct->desc, ct->num_con * sizeof(condesc_t *));
+
+	uint64_t h = FNV_OFFSET_BASIS;
+	for (size_t n = 0; n < ct->num_con; n++)
+	{
+		const char *s = pc->desc[n]->more->string;
+		h = fnv_hash(h, s, strlen(s) + 1);
+	}
+	pc->con_fingerprint = h;
+
+	dict->prune_cache = pc;
+}
+
+size_t dictionary_get_prune_cache_hits(Dictionary dict)
+{
+	if ((NULL == dict) || (NULL == dict->prune_cache)) return 0;
+
+	pc_lock(dict->prune_cache);
+	size_t hits = dict->prune_cache->hits;
+	pc_unlock(dict->prune_cache);
+	return hits;
+}
+
+size_t dictionary_get_prune_cache_misses(Dictionary dict)
+{
+	if ((NULL == dict) || (NULL == dict->prune_cache)) return 0;
+
+	pc_lock(dict->prune_cache);
+	size_t misses = dict->prune_cache->misses;
+	pc_unlock(dict->prune_cache);
+	return misses;
+}
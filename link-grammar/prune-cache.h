@@ -0,0 +1,26 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _PRUNE_CACHE_H
+#define _PRUNE_CACHE_H
+
+#include "api-structures.h"
+
+void prune_cache_lookup(Sentence, Parse_Options);
+bool prune_cache_found(Sentence);
+bool prune_cache_load(Sentence, Tracon_sharing **, unsigned int *[2],
+                      unsigned int *);
+void prune_cache_store(Sentence, Tracon_sharing *, unsigned int,
+                       unsigned int *[2]);
+void prune_cache_entry_delete(Prune_cache_entry *);
+void prune_cache_delete(Dictionary);
+
+#endif /* _PRUNE_CACHE_H */
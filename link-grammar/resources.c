@@ -57,6 +57,18 @@ static double current_usage_time(void)
 #endif
 }
 
+/** Returns a wall-clock time stamp, in seconds. */
+static double current_wall_time(void)
+{
+	struct timespec ts;
+#if defined CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	timespec_get(&ts, TIME_UTC);
+#endif
+	return (ts.tv_sec + ((double) ts.tv_nsec) / 1000000000.0);
+}
+
 Resources resources_create(void)
 {
 	Resources r;
@@ -69,10 +81,13 @@ Resources resources_create(void)
 	r->when_last_called = now;
 	r->time_when_parse_started = now;
 	r->space_when_parse_started = get_space_in_use();
+	r->space_in_use = NULL;
 	r->max_memory = MAX_MEMORY_UNLIMITED;
 	r->cumulative_time = 0;
+	r->wall_deadline = MAX_PARSE_TIME_UNLIMITED;
 	r->memory_exhausted = false;
 	r->timer_expired = false;
+	r->cancel_requested = false;
 
 	return r;
 }
@@ -102,13 +117,75 @@ void resources_reset_space(Resources r)
 	r->space_when_parse_started = get_space_in_use();
 }
 
+/**
+ * Set a wall-clock deadline \p secs seconds from now. A non-positive
+ * value removes the deadline.
+ */
+void resources_set_deadline(Resources r, double secs)
+{
+	if (secs <= 0)
+		r->wall_deadline = MAX_PARSE_TIME_UNLIMITED;
+	else
+		r->wall_deadline = current_wall_time() + secs;
+}
+
+/**
+ * Return the number of seconds left until the wall-clock deadline
+ * (0 if it has passed), or -1 if there is no deadline.
+ */
+double resources_get_deadline(Resources r)
+{
+	if (r->wall_deadline == MAX_PARSE_TIME_UNLIMITED)
+		return MAX_PARSE_TIME_UNLIMITED;
+
+	double left = r->wall_deadline - current_wall_time();
+	return (left > 0) ? left : 0;
+}
+
+/** Request cancellation of the current parse. Can be called from any thread. */
+void resources_cancel(Resources r)
+{
+	RESOURCES_STORE_FLAG(r->cancel_requested, true);
+}
+
+void resources_clear_cancel(Resources r)
+{
+	RESOURCES_STORE_FLAG(r->cancel_requested, false);
+}
+
+/**
+ * Return true if the parse has been cancelled, or its wall-clock deadline
+ * has passed. Unlike resources_exhausted(), this doesn't depend on the
+ * state left by a previous parse, so it can be used by the tokenizer too.
+ */
+bool resources_interrupted(Resources r)
+{
+	if (resources_cancel_requested(r)) return true;
+	if (r->wall_deadline == MAX_PARSE_TIME_UNLIMITED) return false;
+	return (current_wall_time() >= r->wall_deadline);
+}
+
 bool resources_exhausted(Resources r)
 {
-	if (!r->timer_expired && !resources_timer_expired(r)) return false;
+	if (r->timer_expired || r->memory_exhausted) return true;
+
+	if (resources_memory_exhausted(r))
+	{
+		if (verbosity_level(D_USER_TIMES))
+		{
+			prt_error("#### Memory budget exhausted (%zu bytes)\n",
+			          *r->space_in_use);
+		}
+		r->memory_exhausted = true;
+		return true;
+	}
 
-	if (!r->timer_expired && (verbosity_level(D_USER_TIMES)))
+	if (!resources_interrupted(r) && !resources_timer_expired(r)) return false;
+
+	if (verbosity_level(D_USER_TIMES))
 	{
-		prt_error("#### Timeout (%.2f seconds)\n",
+		prt_error("#### %s (%.2f seconds)\n",
+		          resources_cancel_requested(r) ? "Cancelled" : "Timeout",
 		          current_usage_time() - r->time_when_parse_started);
 	}
 	r->timer_expired = true;
@@ -116,33 +193,39 @@ bool resources_exhausted(Resources r)
 	return true;
 }
 
-#if 0 /* max_memory is not being set any more. */
-bool resources_exhausted(Resources r)
+/**
+ * Charge the memory budget (max_memory) with \p space_in_use, which is
+ * the memory accounting of the sentence being parsed. \c NULL stops it.
+ */
+void resources_track_space(Resources r, const size_t *space_in_use)
 {
-	if (r->timer_expired || r->memory_exhausted)
-		return true;
-
-	if (resources_timer_expired(r))
-		r->timer_expired = true;
-
-	if (resources_memory_exhausted(r))
-		r->memory_exhausted = true;
+	r->space_in_use = space_in_use;
+}
 
-	return (r->timer_expired || r->memory_exhausted);
+/**
+ * Return true if \p bytes more can be allocated within the memory budget.
+ * Used for optional growth, e.g. of hash tables.
+ */
+bool resources_space_available(Resources r, size_t bytes)
+{
+	if ((r->max_memory == MAX_MEMORY_UNLIMITED) || (NULL == r->space_in_use))
+		return true;
+	return (*r->space_in_use + bytes <= r->max_memory);
 }
-#endif
 
 bool resources_timer_expired(Resources r)
 {
+	if (r->timer_expired) return true;
 	if (r->max_parse_time == MAX_PARSE_TIME_UNLIMITED) return false;
-	else return (r->timer_expired ||
-	     (current_usage_time() - r->time_when_parse_started > r->max_parse_time));
+	return (current_usage_time() - r->time_when_parse_started > r->max_parse_time);
 }
 
 bool resources_memory_exhausted(Resources r)
 {
-	if (r->max_memory == MAX_MEMORY_UNLIMITED) return false;
-	else return (r->memory_exhausted || (get_space_in_use() > r->max_memory));
+	if (r->memory_exhausted) return true;
+	if ((r->max_memory == MAX_MEMORY_UNLIMITED) || (NULL == r->space_in_use))
+		return false;
+	return (*r->space_in_use > r->max_memory);
 }
 
 #define RES_COL_WIDTH 52
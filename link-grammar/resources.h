@@ -13,9 +13,20 @@
 #ifndef _RESOURCES_H
 #define _RESOURCES_H
 
-#include "api-types.h"
+#include "api-structures.h"
 #include "link-includes.h"
 
+/* The cancellation flag is written by one thread and polled by another.
+ * Relaxed atomic access is enough, since nothing else is published
+ * through it. Elsewhere, a volatile access is the best we can do. */
+#if defined __GNUC__
+#define RESOURCES_LOAD_FLAG(f) __atomic_load_n(&(f), __ATOMIC_RELAXED)
+#define RESOURCES_STORE_FLAG(f, v) __atomic_store_n(&(f), (v), __ATOMIC_RELAXED)
+#else
+#define RESOURCES_LOAD_FLAG(f) (*(volatile bool *)&(f))
+#define RESOURCES_STORE_FLAG(f, v) (*(volatile bool *)&(f) = (v))
+#endif
+
 void      print_time(Parse_Options opts, const char * s, ...) GNUC_PRINTF(2,3);
 void      print_total_space(Parse_Options opts);
 void      resources_reset(Resources r);
@@ -25,4 +36,30 @@ bool      resources_memory_exhausted(Resources r);
 bool      resources_exhausted(Resources r);
 Resources resources_create(void);
 void      resources_delete(Resources ti);
+void      resources_set_deadline(Resources r, double secs);
+double    resources_get_deadline(Resources r);
+void      resources_cancel(Resources r);
+void      resources_clear_cancel(Resources r);
+bool      resources_interrupted(Resources r);
+void      resources_track_space(Resources r, const size_t *space_in_use);
+bool      resources_space_available(Resources r, size_t bytes);
+
+static inline bool resources_cancel_requested(Resources r)
+{
+	return RESOURCES_LOAD_FLAG(r->cancel_requested);
+}
+
+/**
+ * A cheap version of resources_exhausted(), for polling in long loops.
+ * The cancellation flag is tested on each call, but the clocks are read
+ * only when the loop counter \p n is a multiple of \p interval (which
+ * must be a power of 2).
+ */
+static inline bool resources_poll(Resources r, unsigned int n,
+                                  unsigned int interval)
+{
+	if (!resources_cancel_requested(r) && (0 != (n & (interval-1))))
+		return false;
+	return resources_exhausted(r);
+}
 #endif /* _RESOURCES_H */
@@ -0,0 +1,729 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <stddef.h>                     // max_align_t
+#include <stdint.h>
+
+#include "api-structures.h"
+#include "connectors.h"                 // string_hash, FIBONACCI_MULT
+#include "dict-common/dict-common.h"
+#include "disjunct-utils.h"
+#include "linkage/linkage.h"
+#include "lru-table.h"
+#include "resources.h"
+#include "result-cache.h"
+#include "tokenize/tok-structures.h"    // Gword
+#include "tokenize/tokenize.h"        // free_words
+#include "tokenize/word-structures.h" // Word
+#include "tokenize/wordgraph.h"         // gwordlist_copy
+#include "utilities.h"
+
+/**
+ * A per-dictionary LRU cache of sentence parse results.
+ *
+ * Parsing the same input string twice with the same parse options
+ * gives the same linkages. When this cache is enabled (see
+ * dictionary_set_result_cache()), sentence_parse() first looks up the
+ * input string + the parse options that affect the result, and on a
+ * hit the sentence borrows the cached linkages instead of being
+ * tokenized, pruned and parsed again.
+ *
+ * The cached results are a compact, self-contained and immutable copy
+ * of the finalized linkages (after compute_chosen_words()): the words,
+ * the links, and just the parts of the chosen disjuncts, connectors and
+ * wordgraph words that the linkage API needs. They don't refer to the
+ * sentence from which they have been copied, so that sentence can be
+ * deleted while the results are still in the cache. A sentence that
+ * borrows a result gets its own linkage arrays (the linkage API may
+ * modify them, e.g. when computing domain names), which point to the
+ * shared immutable data. Each entry has a reference count, so an entry
+ * that is evicted while some sentences still use it is freed only when
+ * the last of them releases it.
+ *
+ * The cache is bounded by a maximum number of entries and a maximum
+ * number of bytes. Results that depend on random choices (linkage
+ * sampling, shuffling or random morphology without repeatable-rand),
+ * or that got cut short by the resource limits, are not cached, and
+ * neither are results with more than RC_MAX_LINKAGES linkages, which
+ * would take too long to finalize and copy on each miss.
+ * Nor are the results of dynamic (SQL or Atomese) dictionaries, since
+ * their lookups may add words that change the parse of a sentence.
+ */
+
+#define D_RC 6 /* Debug level for this file. */
+
+#define RC_BLOCK_SIZE 4096
+#define RC_MAX_LINKAGES 1000
+#define RC_ALIGN (sizeof(max_align_t))
+#define RC_HEADER_SIZE ALIGN(sizeof(rc_block), RC_ALIGN)
+
+/* Memory arena for the cached data of one entry. */
+typedef struct rc_block_s rc_block;
+struct rc_block_s
+{
+	rc_block *next;
+	size_t size;                 /* Data size (excluding the header) */
+	size_t used;
+};
+
+struct Result_cache_entry_s
+{
+	Lru_node node;                 /* Must be first */
+	Result_cache *cache;
+	unsigned int refcount;         /* Number of borrowing sentences */
+	bool evicted;                  /* Not in the cache any more */
+	size_t bytes;                  /* Memory used by this entry */
+	rc_block *arena;
+
+	/* Parse results */
+	const char *orig_sentence;
+	size_t length;
+	Word *word;                    /* Only the alternatives, for display */
+	int num_linkages_found;
+	bool overflowed;
+	float disjunct_cost;
+	unsigned int null_count;
+	size_t num_valid_linkages;
+	size_t num_linkages;           /* Number of post-processed linkages */
+	Linkage lnkages;
+};
+
+struct Result_cache_s
+{
+	Lru_table lru;
+	size_t max_entries;            /* 0: The cache is disabled */
+	size_t bytes;
+	size_t max_bytes;              /* 0: Unlimited */
+	size_t hits;
+	size_t misses;
+};
+
+static void rc_lock(Result_cache *rc)
+{
+	lru_table_lock(&rc->lru);
+}
+
+static void rc_unlock(Result_cache *rc)
+{
+	lru_table_unlock(&rc->lru);
+}
+
+/* ======================================================================== */
+/* Entry memory. */
+
+static void *rc_alloc(Result_cache_entry *e, size_t size, size_t align)
+{
+	rc_block *b = e->arena;
+	size_t start = (NULL == b) ? 0 : ALIGN(b->used, align);
+
+	if ((NULL == b) || (start + size > b->size))
+	{
+		size_t bsize = MAX(ALIGN(size, RC_ALIGN), RC_BLOCK_SIZE);
+		b = malloc(RC_HEADER_SIZE + bsize);
+		b->next = e->arena;
+		b->size = bsize;
+		e->arena = b;
+		e->bytes += RC_HEADER_SIZE + bsize;
+		start = 0;
+	}
+
+	b->used = start + size;
+	return (char *)b + RC_HEADER_SIZE + start;
+}
+
+static void entry_delete(Result_cache_entry *e)
+{
+	rc_block *next;
+	for (rc_block *b = e->arena; NULL != b; b = next)
+	{
+		next = b->next;
+		free(b);
+	}
+	free(e);
+}
+
+/* ======================================================================== */
+/* Copying the results of a parsed sentence into a cache entry. */
+
+/* Source address to copy mapping, so shared data is copied once. */
+typedef struct
+{
+	const void *key;
+	void *value;
+} ptr_map_slot;
+
+typedef struct
+{
+	Result_cache_entry *e;
+	const char *orig_sentence;     /* Of the source sentence */
+	size_t orig_sentence_len;
+	ptr_map_slot *map;
+	size_t map_size;               /* A power of 2 */
+	size_t map_count;
+} copy_context;
+
+static size_t ptr_hash(const void *p, size_t size)
+{
+	return (size_t)(((uintptr_t)p >> 3) * FIBONACCI_MULT) & (size - 1);
+}
+
+/**
+ * Return the address of the mapping value of \p key, adding \p key
+ * with a NULL value if it is not in the map yet.
+ */
+static void **ptr_map_find(copy_context *cc, const void *key)
+{
+	if (2 * (cc->map_count + 1) > cc->map_size)
+	{
+		ptr_map_slot *old_map = cc->map;
+		size_t old_size = cc->map_size;
+
+		cc->map_size = (0 == old_size) ? 256 : 2 * old_size;
+		cc->map = calloc(cc->map_size, sizeof(*cc->map));
+		for (size_t i = 0; i < old_size; i++)
+		{
+			if (NULL == old_map[i].key) continue;
+			size_t h = ptr_hash(old_map[i].key, cc->map_size);
+			while (NULL != cc->map[h].key) h = (h + 1) & (cc->map_size - 1);
+			cc->map[h] = old_map[i];
+		}
+		free(old_map);
+	}
+
+	size_t h = ptr_hash(key, cc->map_size);
+	while (NULL != cc->map[h].key)
+	{
+		if (cc->map[h].key == key) return &cc->map[h].value;
+		h = (h + 1) & (cc->map_size - 1);
+	}
+
+	cc->map[h].key = key;
+	cc->map_count++;
+	return &cc->map[h].value;
+}
+
+static const char *copy_string(copy_context *cc, const char *s)
+{
+	if (NULL == s) return NULL;
+
+	void **v = ptr_map_find(cc, s);
+	if (NULL == *v)
+	{
+		size_t len = strlen(s) + 1;
+		*v = memcpy(rc_alloc(cc->e, len, 1), s, len);
+	}
+	return *v;
+}
+
+static Connector *copy_connector(copy_context *cc, const Connector *c)
+{
+	if (NULL == c) return NULL;
+
+	void **v = ptr_map_find(cc, c);
+	if (NULL != *v) return *v;
+
+	Connector *n = rc_alloc(cc->e, sizeof(Connector), RC_ALIGN);
+	*n = *c;
+	n->originating_gword = NULL;
+	*v = n;
+	n->next = copy_connector(cc, c->next); /* Invalidates v */
+
+	return n;
+}
+
+static Disjunct *copy_disjunct(copy_context *cc, const Disjunct *d)
+{
+	if (NULL == d) return NULL;
+
+	void **v = ptr_map_find(cc, d);
+	if (NULL != *v) return *v;
+
+	Disjunct *n = rc_alloc(cc->e, sizeof(Disjunct), RC_ALIGN);
+	memset(n, 0, sizeof(Disjunct));
+	n->cost = d->cost;
+	*v = n;
+	n->word_string = copy_string(cc, d->word_string);
+	n->left = copy_connector(cc, d->left);
+	n->right = copy_connector(cc, d->right);
+
+	return n;
+}
+
+/**
+ * Copy the part of a wordgraph word which is used after the linkage
+ * is created. Its start/end positions are rebased to the cached copy
+ * of the sentence.
+ */
+static Gword *copy_gword(copy_context *cc, const Gword *w)
+{
+	void **v = ptr_map_find(cc, w);
+	if (NULL != *v) return *v;
+
+	Gword *n = rc_alloc(cc->e, sizeof(Gword), RC_ALIGN);
+	memset(n, 0, sizeof(Gword));
+	n->morpheme_type = w->morpheme_type;
+	n->status = w->status;
+	*v = n;
+	n->subword = copy_string(cc, w->subword);
+
+	const char *orig_end = cc->orig_sentence + cc->orig_sentence_len;
+	if ((w->start >= cc->orig_sentence) && (w->end <= orig_end))
+	{
+		n->start = cc->e->orig_sentence + (w->start - cc->orig_sentence);
+		n->end = cc->e->orig_sentence + (w->end - cc->orig_sentence);
+	}
+
+	return n;
+}
+
+static void copy_linkage(copy_context *cc, Linkage dst, const Linkage src)
+{
+	Result_cache_entry *e = cc->e;
+	size_t nwords = src->num_words;
+
+	*dst = *src;
+
+	dst->word = rc_alloc(e, nwords * sizeof(*dst->word), RC_ALIGN);
+	dst->chosen_disjuncts =
+		rc_alloc(e, nwords * sizeof(*dst->chosen_disjuncts), RC_ALIGN);
+	for (WordIdx w = 0; w < nwords; w++)
+	{
+		dst->word[w] = copy_string(cc, src->word[w]);
+		dst->chosen_disjuncts[w] = copy_disjunct(cc, src->chosen_disjuncts[w]);
+	}
+	dst->cdsz = nwords;
+
+	dst->link_array = rc_alloc(e, src->num_links * sizeof(Link), RC_ALIGN);
+	for (LinkIdx j = 0; j < src->num_links; j++)
+	{
+		const Link *sl = &src->link_array[j];
+		Link *dl = &dst->link_array[j];
+
+		dl->lw = sl->lw;
+		dl->rw = sl->rw;
+		dl->lc = copy_connector(cc, sl->lc);
+		dl->rc = copy_connector(cc, sl->rc);
+		dl->link_name = copy_string(cc, sl->link_name);
+	}
+	dst->lasz = src->num_links;
+
+	size_t wg_len = gwordlist_len((const Gword **)src->wg_path_display);
+	dst->wg_path_display = rc_alloc(e, (wg_len + 1) * sizeof(Gword *), RC_ALIGN);
+	for (size_t i = 0; i < wg_len; i++)
+		dst->wg_path_display[i] = copy_gword(cc, src->wg_path_display[i]);
+	dst->wg_path_display[wg_len] = NULL;
+
+	dst->wg_path = NULL;
+	dst->disjunct_list_str = NULL;
+	dst->pp_domains = NULL;
+	dst->sent = NULL;
+}
+
+static Result_cache_entry *entry_new(Sentence sent, const char *key)
+{
+	Result_cache_entry *e = malloc(sizeof(Result_cache_entry));
+	memset(e, 0, sizeof(Result_cache_entry));
+	e->bytes = sizeof(Result_cache_entry);
+
+	copy_context cc = { .e = e };
+
+	size_t len = strlen(key) + 1;
+	e->node.key = memcpy(rc_alloc(e, len, 1), key, len);
+	e->node.hash = string_hash(key);
+
+	cc.orig_sentence = sent->orig_sentence;
+	cc.orig_sentence_len = strlen(sent->orig_sentence);
+	e->orig_sentence = copy_string(&cc, sent->orig_sentence);
+
+	e->length = sent->length;
+	e->word = rc_alloc(e, e->length * sizeof(*e->word), RC_ALIGN);
+	for (WordIdx w = 0; w < e->length; w++)
+	{
+		const Word *sw = &sent->word[w];
+		size_t nalts = altlen(sw->alternatives);
+		const char **alts = rc_alloc(e, (nalts + 1) * sizeof(char *), RC_ALIGN);
+
+		for (size_t a = 0; a < nalts; a++)
+			alts[a] = copy_string(&cc, sw->alternatives[a]);
+		alts[nalts] = NULL;
+
+		e->word[w] = (Word){ .unsplit_word = copy_string(&cc, sw->unsplit_word),
+		                     .optional = sw->optional, .alternatives = alts };
+	}
+
+	e->num_linkages_found = sent->num_linkages_found;
+	e->overflowed = sent->overflowed;
+	e->disjunct_cost = sent->disjunct_cost;
+	e->null_count = sent->null_count;
+	e->num_valid_linkages = sent->num_valid_linkages;
+	e->num_linkages = sent->num_linkages_post_processed;
+
+	if (0 < e->num_linkages)
+	{
+		e->lnkages =
+			rc_alloc(e, e->num_linkages * sizeof(struct Linkage_s), RC_ALIGN);
+		for (LinkageIdx k = 0; k < e->num_linkages; k++)
+			copy_linkage(&cc, &e->lnkages[k], &sent->lnkages[k]);
+	}
+
+	free(cc.map);
+	return e;
+}
+
+/* ======================================================================== */
+/* Cache maintenance. Called with the cache lock held. */
+
+static Result_cache_entry *find_entry(Result_cache *rc, const char *key,
+                                      uint32_t hash)
+{
+	return (Result_cache_entry *)lru_table_find(&rc->lru, key, hash);
+}
+
+static void evict(Result_cache *rc, Result_cache_entry *e)
+{
+	lru_table_remove(&rc->lru, &e->node);
+	rc->bytes -= e->bytes;
+
+	e->evicted = true;
+	if (0 == e->refcount) entry_delete(e);
+}
+
+static void evict_over_bounds(Result_cache *rc)
+{
+	while ((NULL != rc->lru.lru_last) &&
+	       ((rc->lru.num_entries > rc->max_entries) ||
+	        ((0 != rc->max_bytes) && (rc->bytes > rc->max_bytes))))
+	{
+		evict(rc, (Result_cache_entry *)rc->lru.lru_last);
+	}
+}
+
+/* ======================================================================== */
+/* The interface to sentence_parse(). */
+
+bool result_cache_enabled(Dictionary dict, Parse_Options opts)
+{
+	if ((NULL == dict->result_cache) || (0 == dict->result_cache->max_entries))
+		return false;
+	if (IS_GENERATION(dict) || IS_DYNAMIC_DICT(dict)) return false;
+	if (opts->keep_forest) return false;
+#if USE_SAT_SOLVER
+	/* The SAT parser creates its linkages on demand. */
+	if (opts->use_sat_solver) return false;
+	/* The result depends on which parser is faster. */
+	if (opts->portfolio) return false;
+#endif
+
+	return true;
+}
+
+/**
+ * Return the cache key of the sentence.
+ * It consists of the parse options that may affect the parse results,
+ * and the input string itself. The input string is not normalized,
+ * since the linkage API reports word positions in it.
+ */
+char *result_cache_key(Sentence sent, Parse_Options opts)
+{
+	char buf[256];
+	dyn_str *key = dyn_str_new();
+
+	snprintf(buf, sizeof(buf),
+	         "%a %d %d %d %d %d %zu %d %d %d %zu %d %zu %d %d",
+	         opts->disjunct_cost, opts->adaptive_cost, opts->max_disjuncts,
+	         opts->min_null_count, opts->max_null_count, opts->islands_ok,
+	         opts->short_length, opts->all_short, opts->repeatable_rand,
+	         opts->perform_pp_prune, opts->twopass_length,
+	         (int)opts->cost_model.type, opts->linkage_limit,
+	         opts->display_morphology, opts->use_spell_guess);
+	dyn_strcat(key, buf);
+	dyn_strcat(key, "\x1f");
+	if (NULL != opts->dialect.conf) dyn_strcat(key, opts->dialect.conf);
+	dyn_strcat(key, "\x1f");
+	dyn_strcat(key, opts->test);
+	dyn_strcat(key, "\x1f");
+	dyn_strcat(key, sent->orig_sentence);
+
+	return dyn_str_take(key);
+}
+
+/**
+ * Give the sentence its own copy of the linkage arrays of the entry.
+ * The data they point to is shared.
+ */
+static void borrow_results(Sentence sent, Result_cache_entry *e)
+{
+	if (NULL != sent->lnkages) free_linkages(sent);
+
+	sent->result_cache_entry = e;
+	sent->orig_sentence = e->orig_sentence; /* For word positions */
+
+	/* Unless the sentence has already been split, give it the words of
+	 * the cached one, so its length and word alternatives are valid. */
+	if (0 == sent->length)
+	{
+		sent->length = e->length;
+		sent->word = malloc(e->length * sizeof(*sent->word));
+		for (WordIdx w = 0; w < e->length; w++)
+		{
+			size_t nalts = altlen(e->word[w].alternatives);
+
+			sent->word[w] = e->word[w];
+			sent->word[w].alternatives = malloc((nalts + 1) * sizeof(char *));
+			memcpy(sent->word[w].alternatives, e->word[w].alternatives,
+			       (nalts + 1) * sizeof(char *));
+		}
+	}
+
+	sent->num_linkages_found = e->num_linkages_found;
+	sent->overflowed = e->overflowed;
+	sent->disjunct_cost = e->disjunct_cost;
+	sent->null_count = e->null_count;
+	sent->num_valid_linkages = e->num_valid_linkages;
+	sent->num_linkages_post_processed = e->num_linkages;
+	sent->num_linkages_alloced = e->num_linkages;
+	if (0 == e->num_linkages) return;
+
+	sent->lnkages = malloc(e->num_linkages * sizeof(struct Linkage_s));
+	for (LinkageIdx k = 0; k < e->num_linkages; k++)
+	{
+		const Linkage src = &e->lnkages[k];
+		Linkage lkg = &sent->lnkages[k];
+		size_t nwords = src->num_words;
+
+		*lkg = *src;
+		lkg->word = exalloc(nwords * sizeof(*lkg->word));
+		memcpy(lkg->word, src->word, nwords * sizeof(*lkg->word));
+		lkg->chosen_disjuncts = exalloc(nwords * sizeof(Disjunct *));
+		memcpy(lkg->chosen_disjuncts, src->chosen_disjuncts,
+		       nwords * sizeof(Disjunct *));
+		lkg->link_array = malloc(src->num_links * sizeof(Link));
+		memcpy(lkg->link_array, src->link_array, src->num_links * sizeof(Link));
+		lkg->wg_path_display =
+			(Gword **)gwordlist_copy((const Gword **)src->wg_path_display);
+		lkg->sent = sent;
+	}
+}
+
+/**
+ * Look up the sentence in the cache of its dictionary.
+ * On a hit, the sentence borrows the cached results.
+ * @return \c true on a hit, else \c false.
+ */
+bool result_cache_lookup(Sentence sent, const char *key)
+{
+	Result_cache *rc = sent->dict->result_cache;
+	uint32_t hash = string_hash(key);
+
+	rc_lock(rc);
+	Result_cache_entry *e = find_entry(rc, key, hash);
+	if (NULL == e)
+	{
+		rc->misses++;
+		rc_unlock(rc);
+		return false;
+	}
+	rc->hits++;
+	e->refcount++;
+	lru_table_touch(&rc->lru, &e->node);
+	rc_unlock(rc);
+
+	lgdebug(+D_RC, "Hit (%u users): %s\n", e->refcount, sent->orig_sentence);
+	borrow_results(sent, e);
+	return true;
+}
+
+static bool is_cacheable(Sentence sent, Parse_Options opts)
+{
+	Resources r = opts->resources;
+	if (r->timer_expired || r->memory_exhausted) return false;
+
+	/* Each linkage is finalized and copied when it is added, even if
+	 * the caller never asks for it, so a miss would add much to the
+	 * parse time of a sentence with many linkages. */
+	if (sent->num_linkages_post_processed > RC_MAX_LINKAGES) return false;
+
+	if (opts->repeatable_rand) return true;
+
+	/* Else the result may be one of several possible ones. */
+	if (sent->num_linkages_found > (int)opts->linkage_limit) return false;
+	if (sent->dict->shuffle_linkages) return false;
+	if ((NULL != sent->dict->affix_table) &&
+	    (NULL != sent->dict->affix_table->anysplit))
+		return false;
+
+	return true;
+}
+
+/**
+ * Add the results of the just-parsed sentence to the cache.
+ * The linkages of the sentence are finalized here, so the sentence
+ * itself is not affected other than that.
+ */
+void result_cache_insert(Sentence sent, Parse_Options opts, const char *key)
+{
+	Result_cache *rc = sent->dict->result_cache;
+
+	if (!is_cacheable(sent, opts)) return;
+
+	for (LinkageIdx k = 0; k < sent->num_linkages_post_processed; k++)
+		linkage_create(k, sent, opts);
+
+	Result_cache_entry *e = entry_new(sent, key);
+	e->cache = rc;
+
+	rc_lock(rc);
+	if ((NULL != find_entry(rc, e->node.key, e->node.hash)) ||
+	    ((0 != rc->max_bytes) && (e->bytes > rc->max_bytes)))
+	{
+		/* Added by another thread, or too big to be cached. */
+		rc_unlock(rc);
+		entry_delete(e);
+		return;
+	}
+	lru_table_insert(&rc->lru, &e->node);
+	rc->bytes += e->bytes;
+	evict_over_bounds(rc);
+	rc_unlock(rc);
+
+	lgdebug(+D_RC, "Added (%zu bytes): %s\n", e->bytes, sent->orig_sentence);
+}
+
+/**
+ * Give \p dst a copy of the parse results of \p src, which is another
+ * sentence with the same input string, e.g. one parsed by a different
+ * parser. The copy is made as for the cache, but it is not put in the
+ * cache, and it is freed when \p dst releases it.
+ * \p opts are the options \p src has been parsed with.
+ */
+void result_cache_adopt(Sentence dst, Sentence src, Parse_Options opts)
+{
+	for (LinkageIdx k = 0; k < src->num_linkages_post_processed; k++)
+		linkage_create(k, src, opts);
+
+	Result_cache_entry *e = entry_new(src, "");
+	e->evicted = true;
+	e->refcount = 1;
+
+	borrow_results(dst, e);
+}
+
+/**
+ * Release the cached results the sentence borrows, if any.
+ */
+void result_cache_release(Sentence sent)
+{
+	Result_cache_entry *e = sent->result_cache_entry;
+	if (NULL == e) return;
+
+	free_linkages(sent);
+	sent->orig_sentence = string_set_add(e->orig_sentence, sent->string_set);
+	sent->result_cache_entry = NULL;
+
+	if (NULL == sent->wordgraph)
+	{
+		/* The words have been borrowed too; they are not split yet. */
+		free_words(sent);
+		sent->word = NULL;
+		sent->length = 0;
+	}
+
+	Result_cache *rc = e->cache;
+	if (NULL == rc)
+	{
+		entry_delete(e); /* Adopted, not shared */
+		return;
+	}
+
+	rc_lock(rc);
+	e->refcount--;
+	bool unused = e->evicted && (0 == e->refcount);
+	rc_unlock(rc);
+
+	if (unused) entry_delete(e);
+}
+
+/* ======================================================================== */
+/* Dictionary interface. */
+
+void result_cache_clear(Dictionary dict)
+{
+	Result_cache *rc = dict->result_cache;
+	if (NULL == rc) return;
+
+	rc_lock(rc);
+	while (NULL != rc->lru.lru_last)
+		evict(rc, (Result_cache_entry *)rc->lru.lru_last);
+	rc_unlock(rc);
+}
+
+void result_cache_delete(Dictionary dict)
+{
+	Result_cache *rc = dict->result_cache;
+	if (NULL == rc) return;
+
+	result_cache_clear(dict);
+	lru_table_destroy(&rc->lru);
+	free(rc);
+	dict->result_cache = NULL;
+}
+
+/**
+ * Set the maximum number of sentence parse results cached for this
+ * dictionary, and the maximum memory they may use (0 for no memory
+ * limit). Setting \p max_entries to 0 disables the cache and frees
+ * its content. The cache is initially disabled. It is not used for
+ * dynamic dictionaries, whose lookups may add words, nor for sentences
+ * with more than 1000 post-processed linkages.
+ */
+void dictionary_set_result_cache(Dictionary dict, size_t max_entries,
+                                 size_t max_bytes)
+{
+	if (NULL == dict) return;
+
+	Result_cache *rc = dict->result_cache;
+	if (NULL == rc)
+	{
+		if (0 == max_entries) return;
+
+		rc = malloc(sizeof(Result_cache));
+		memset(rc, 0, sizeof(Result_cache));
+		lru_table_init(&rc->lru, max_entries);
+		dict->result_cache = rc;
+	}
+
+	rc_lock(rc);
+	rc->max_entries = max_entries;
+	rc->max_bytes = max_bytes;
+	evict_over_bounds(rc);
+	lru_table_resize(&rc->lru, max_entries);
+	rc_unlock(rc);
+}
+
+size_t dictionary_get_result_cache_hits(Dictionary dict)
+{
+	if ((NULL == dict) || (NULL == dict->result_cache)) return 0;
+
+	rc_lock(dict->result_cache);
+	size_t hits = dict->result_cache->hits;
+	rc_unlock(dict->result_cache);
+	return hits;
+}
+
+size_t dictionary_get_result_cache_misses(Dictionary dict)
+{
+	if ((NULL == dict) || (NULL == dict->result_cache)) return 0;
+
+	rc_lock(dict->result_cache);
+	size_t misses = dict->result_cache->misses;
+	rc_unlock(dict->result_cache);
+	return misses;
+}
@@ -0,0 +1,26 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _RESULT_CACHE_H
+#define _RESULT_CACHE_H
+
+#include "api-structures.h"
+
+bool result_cache_enabled(Dictionary, Parse_Options);
+char *result_cache_key(Sentence, Parse_Options);
+bool result_cache_lookup(Sentence, const char *);
+void result_cache_insert(Sentence, Parse_Options, const char *);
+void result_cache_adopt(Sentence, Sentence, Parse_Options);
+void result_cache_release(Sentence);
+void result_cache_clear(Dictionary);
+void result_cache_delete(Dictionary);
+
+#endif /* _RESULT_CACHE_H */
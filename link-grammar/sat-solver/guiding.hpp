@@ -41,12 +41,12 @@ public:
   /* Abstract functions that calculate params for each type of variable */
 
   /* string variables */
-  virtual void setStringParameters  (int var, const char* str)
+  virtual void setStringParameters  (int var)
   {
     bool isDecision = false;
     setParameters(var, isDecision, 0.0, 0.0);
   }
-  virtual void setStringParameters  (int var, const char* str, double cost) = 0;
+  virtual void setStringParameters  (int var, double cost) = 0;
 
   /* epsilon variables */
   virtual void setEpsilonParameters (int var)
@@ -146,7 +146,7 @@ public:
     : Guiding(sent) {
   }
 
-  virtual void setStringParameters(int var, const char* str, double cost)
+  virtual void setStringParameters(int var, double cost)
   {
     bool isDecision = cost > 0.0;
     double priority = cost2priority(cost);
@@ -211,7 +211,7 @@ public:
     : Guiding(sent) {
   }
 
-  virtual void setStringParameters  (int var, const char* str, double cost)
+  virtual void setStringParameters  (int var, double cost)
   {
     bool isDecision = cost > 0.0;
     double priority = cost2priority(cost);
@@ -22,7 +22,6 @@ extern "C" {
 #include "word-tag.hpp"
 #include "matrix-ut.hpp"
 #include "clock.hpp"
-#include "fast-sprintf.hpp"
 
 extern "C" {
 #include "disjunct-utils.h"
@@ -35,6 +34,7 @@ extern "C" {
 #include "prepare/build-disjuncts.h" // for build_disjuncts_for_exp()
 #include "post-process/post-process.h"
 #include "post-process/pp-structures.h"
+#include "resources.h"
 #include "tokenize/word-structures.h" // for Word_struct
 #include "tokenize/tok-structures.h"  // got Gword internals
 }
@@ -48,6 +48,11 @@ extern "C" {
 
 #define D_SAT 5
 
+// Number of conflicts and of propagations between resources checks,
+// when solving. A slice of 100000 propagations takes tens of ms.
+#define SAT_CONFLICT_BUDGET 2000
+#define SAT_PROPAGATION_BUDGET 100000
+
 // Convert a NULL C string pointer, for printing a possibly NULL string
 #define N(s) ((s) ? (s) : "(null)")
 
@@ -203,14 +208,21 @@ void SATEncoder::generate_equivalence_definition(Lit l1, Lit l2) {
 /*-------------------------------------------------------------------------*
  *                          E N C O D I N G                                *
  *-------------------------------------------------------------------------*/
-void SATEncoder::encode() {
+/**
+ * Create the formula. Return false if the resources got exhausted
+ * (timeout or cancellation) in the middle; the encoding is then
+ * incomplete and cannot be used.
+ */
+bool SATEncoder::encode() {
     Clock clock;
-    generate_satisfaction_conditions();
+    if (!generate_satisfaction_conditions()) return false;
     clock.print_time(verbosity, "Generated satisfaction conditions");
     generate_linked_definitions();
     clock.print_time(verbosity, "Generated linked definitions");
+    if (resources_exhausted(_opts->resources)) return false;
     generate_planarity_conditions();
     clock.print_time(verbosity, "Generated planarity conditions");
+    if (resources_exhausted(_opts->resources)) return false;
 
 #ifdef _CONNECTIVITY_
     generate_connectivity();
@@ -222,10 +234,119 @@ void SATEncoder::encode() {
 
     pp_prune();
     clock.print_time(verbosity, "PP pruned");
+    if (resources_exhausted(_opts->resources)) return false;
     power_prune();
     clock.print_time(verbosity, "Power pruned");
+    if (resources_exhausted(_opts->resources)) return false;
+
+    generate_cost_guards();
 
     _variables->setVariableParameters(_solver);
+    return true;
+}
+
+int SATEncoder::control_variable()
+{
+  int var = _variables->control_variable();
+  while (var >= _solver->nVars())
+    _solver->newVar();
+  _solver->setDecisionVar(var, false);
+  return var;
+}
+
+/**
+ * Disable the nodes whose cost exceeds the cost cutoff.
+ * If _flexible_cost, this is conditioned on a guard variable per cost
+ * value. The guards of the costs that exceed the cutoff of a round are
+ * assumed (see new_round()). The guards are created after all the other
+ * variables, so they don't change the numbering (and hence the search
+ * order) of the encoding.
+ */
+void SATEncoder::generate_cost_guards()
+{
+  for (auto& n : _costly_nodes) {
+    if (!_flexible_cost) {
+      generate_literal(~Lit(n.second));
+      continue;
+    }
+
+    std::map<double, int>::iterator g = _cost_guards.find(n.first);
+    if (g == _cost_guards.end())
+      g = _cost_guards.insert(std::make_pair(n.first, control_variable())).first;
+
+    vec<Lit> clause(2);
+    clause[0] = ~Lit(g->second);
+    clause[1] = ~Lit(n.second);
+    add_clause(clause);
+  }
+  _costly_nodes.clear();
+  _costly_nodes.shrink_to_fit();
+}
+
+/**
+ * Express the connector length limits of the given options, if they
+ * are tighter than the encoded ones, as assumptions that disable the
+ * too-long links.
+ */
+bool SATEncoder::assume_length_limits(Parse_Options opts)
+{
+  if ((opts->short_length == _short_length) && (opts->all_short == _all_short))
+    return true;
+
+  // The farthest word that a connector can reach with these options.
+  auto farthest = [&](const PositionConnector& pc) -> int {
+    int length_limit = get_connector_length_limit(pc.connector.desc, opts);
+    int w = (int)pc.word;
+    if (pc.dir == '-')
+      return std::max(0, w - length_limit);
+    return std::min((int)_sent->length - 1, w + length_limit);
+  };
+
+  for (size_t w = 0; w < _sent->length; w++) {
+    for (const PositionConnector& pc : _word_tags[w].get_left_connectors())
+      if (farthest(pc) < pc.connector.farthest_word) return false;
+    for (const PositionConnector& pc : _word_tags[w].get_right_connectors())
+      if (farthest(pc) > pc.connector.farthest_word) return false;
+  }
+
+  for (int var : _variables->link_variables()) {
+    const Variables::LinkVar* lv = _variables->link_variable(var);
+    const PositionConnector* lpc = _word_tags[lv->left_word].get(lv->left_position);
+    const PositionConnector* rpc = _word_tags[lv->right_word].get(lv->right_position);
+    if ((farthest(*lpc) < lv->right_word) || (farthest(*rpc) > lv->left_word))
+      _assumptions.push(~Lit(var));
+  }
+
+  return true;
+}
+
+bool SATEncoder::new_round(Parse_Options opts)
+{
+  double cost_cutoff = parse_options_get_disjunct_cost(opts);
+  if (_flexible_cost ? (cost_cutoff < _cost_cutoff) : (cost_cutoff != _cost_cutoff))
+    return false;
+  if (opts->perform_pp_prune != _pp_prune)
+    return false;
+
+  _assumptions.clear();
+  if (!assume_length_limits(opts)) return false;
+
+  // Retire the blocking clauses of the previous round.
+  _pending_clauses.clear();
+  if (_round_var != -1)
+    generate_literal(~Lit(_round_var));
+  _round_var = control_variable();
+  _assumptions.push(Lit(_round_var));
+
+  for (auto& g : _cost_guards) {
+    if (g.first > cost_cutoff)
+      _assumptions.push(Lit(g.second));
+  }
+
+  _opts = opts;
+  _next_linkage_index = 0;
+  _exhausted = false;
+  return true;
 }
 
 
@@ -235,13 +356,9 @@ void SATEncoder::encode() {
  *-------------------------------------------------------------------------*/
 void SATEncoder::build_word_tags()
 {
-  char name[MAX_VARIABLE_NAME];
-  name[0] = 'w';
-
   for (size_t w = 0; w < _sent->length; w++) {
-    fast_sprintf(name+1, (int)w);
     // The SAT encoding word variables are set to be equal to the word numbers.
-    Var var = _variables->string(name);
+    Var var = _variables->string(_variables->word_path(w));
     assert((Var)w == var, "Word %zu: var %d", w, var);
   }
 
@@ -261,13 +378,13 @@ void SATEncoder::build_word_tags()
     cout << endl;
 #endif
 
-    fast_sprintf(name+1, (int)w);
     bool leading_right = true;
     bool leading_left = true;
     std::vector<int> eps_right, eps_left;
 
     _word_tags[w].insert_connectors(exp, dfs_position, leading_right,
-         leading_left, eps_right, eps_left, name, true, 0, NULL, _sent->word[w].x);
+         leading_left, eps_right, eps_left, _variables->word_path(w), true, 0,
+         NULL, _sent->word[w].x);
   }
 
   for (size_t wl = 0; wl < _sent->length - 1; wl++) {
@@ -306,11 +423,10 @@ bool SATEncoder::matches_in_interval(int wi, int pi, int l, int r) {
  *                     S A T I S F A C T I O N                             *
  *-------------------------------------------------------------------------*/
 
-void SATEncoder::generate_satisfaction_conditions()
+bool SATEncoder::generate_satisfaction_conditions()
 {
-  char name[MAX_VARIABLE_NAME] = "w";
-
   for (size_t w = 0; w < _sent->length; w++) {
+    if (resources_exhausted(_opts->resources)) return false;
 
 #ifdef SAT_DEBUG
     cout << "Word " << w << ": " << N(_sent->word[w].unsplit_word);
@@ -320,7 +436,7 @@ void SATEncoder::generate_satisfaction_conditions()
     cout << endl;
 #endif
 
-    fast_sprintf(name+1, w);
+    ExpPath name = _variables->word_path(w);
 
     if (_sent->word[w].optional)
       _variables->string(name);
@@ -342,11 +458,12 @@ void SATEncoder::generate_satisfaction_conditions()
     int dfs_position = 0;
     generate_satisfaction_for_expression(w, dfs_position, exp, name, 0);
   }
+  return true;
 }
 
 
 void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position, Exp* e,
-                                                      char* var, double parent_cost)
+                                                      ExpPath var, double parent_cost)
 {
   Exp *opd;
   double total_cost = parent_cost + e->cost;
@@ -357,8 +474,8 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
     generate_satisfaction_for_connector(w, dfs_position, e, var);
 
     if (total_cost > _cost_cutoff) {
-      Lit lhs = Lit(_variables->string_cost(var, e->cost));
-      generate_literal(~lhs);
+      int lhs = _variables->string_cost(var, e->cost);
+      _costly_nodes.push_back(std::make_pair(total_cost, lhs));
     }
   } else {
     if (e->type == AND_type) {
@@ -366,7 +483,8 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
         /* zeroary and */
         _variables->string_cost(var, e->cost);
         if (total_cost > _cost_cutoff) {
-          generate_literal(~Lit(_variables->string_cost(var, e->cost)));
+          int lhs = _variables->string_cost(var, e->cost);
+          _costly_nodes.push_back(std::make_pair(total_cost, lhs));
         }
       } else if (e->operand_first->operand_next == NULL) {
         /* unary and - skip */
@@ -375,21 +493,11 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
         /* n-ary and */
         int i;
 
-        char new_var[MAX_VARIABLE_NAME];
-        char* last_new_var = new_var;
-        char* last_var = var;
-        while((*last_new_var = *last_var)) {
-          last_new_var++;
-          last_var++;
-        }
+        ExpPath first_var = _variables->operand_paths(var, e);
 
         vec<Lit> rhs;
         for (i = 0, opd=e->operand_first; opd!=NULL; opd=opd->operand_next, i++) {
-          // sprintf(new_var, "%sc%d", var, i)
-          char* s = last_new_var;
-          *s++ = 'c';
-          fast_sprintf(s, i);
-          rhs.push(Lit(_variables->string(new_var)));
+          rhs.push(Lit(_variables->string(first_var + i)));
         }
 
         Lit lhs = Lit(_variables->string_cost(var, e->cost));
@@ -435,13 +543,8 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
 
         /* Recurse */
         for (i = 0, opd=e->operand_first; opd!=NULL; opd=opd->operand_next, i++) {
-          // sprintf(new_var, "%sc%d", var, i)
-          char* s = last_new_var;
-          *s++ = 'c';
-          fast_sprintf(s, i);
-
           /* if (i != 0) total_cost = 0; */ // This interferes with the cost cutoff
-          generate_satisfaction_for_expression(w, dfs_position, opd, new_var, total_cost);
+          generate_satisfaction_for_expression(w, dfs_position, opd, first_var + i, total_cost);
         }
       }
     } else if (e->type == OR_type) {
@@ -456,21 +559,11 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
         /* n-ary or */
         int i;
 
-        char new_var[MAX_VARIABLE_NAME];
-        char* last_new_var = new_var;
-        char* last_var = var;
-        while ((*last_new_var = *last_var)) {
-          last_new_var++;
-          last_var++;
-        }
+        ExpPath first_var = _variables->operand_paths(var, e);
 
         vec<Lit> rhs;
         for (i = 0, opd=e->operand_first; opd!=NULL; opd=opd->operand_next, i++) {
-          // sprintf(new_var, "%sc%d", var, i)
-          char* s = last_new_var;
-          *s++ = 'd';
-          fast_sprintf(s, i);
-          rhs.push(Lit(_variables->string(new_var)));
+          rhs.push(Lit(_variables->string(first_var + i)));
         }
 
         Lit lhs = Lit(_variables->string_cost(var, e->cost));
@@ -479,11 +572,7 @@ void SATEncoder::generate_satisfaction_for_expression(int w, int& dfs_position,
 
         /* Recurse */
         for (i = 0, opd=e->operand_first; opd!=NULL; opd=opd->operand_next, i++) {
-          char* s = last_new_var;
-          *s++ = 'd';
-          fast_sprintf(s, i);
-
-          generate_satisfaction_for_expression(w, dfs_position, opd, new_var, total_cost);
+          generate_satisfaction_for_expression(w, dfs_position, opd, first_var + i, total_cost);
         }
       }
     }
@@ -1045,11 +1134,10 @@ void SATEncoder::generate_disconnectivity_prohibiting(std::vector<int> component
           bool conditional_link_var_exists;
 
           CONNECTIVITY_DEBUG(printf("R ")); // "replaced"
-          char name[MAX_VARIABLE_NAME] = "0";
-          sprintf(name+1, "%dw%dw%d", var, optlw_exists?lv->left_word:255,
-                                           optrw_exists?lv->right_word:255);
-          conditional_link_var_exists = _variables->var_exists(name);
-          conditional_link_var = _variables->string(name);
+          conditional_link_var =
+            _variables->conditional_linked(var, optlw_exists?lv->left_word:-1,
+                                                optrw_exists?lv->right_word:-1,
+                                           conditional_link_var_exists);
 
           if (!conditional_link_var_exists) {
             Lit lhs = Lit(conditional_link_var);
@@ -1090,6 +1178,7 @@ void SATEncoder::generate_planarity_conditions()
   vec<Lit> clause(2);
   for (size_t wi1 = 0; wi1 < _sent->length; wi1++) {
     for (size_t wj1 = wi1+1; wj1 < _sent->length; wj1++) {
+      if (resources_exhausted(_opts->resources)) return; // See encode()
       for (size_t wi2 = wj1+1; wi2 < _sent->length; wi2++) {
         if (!_linked_possible(wi1, wi2))
           continue;
@@ -1112,6 +1201,7 @@ void SATEncoder::generate_planarity_conditions()
 void SATEncoder::generate_epsilon_definitions()
 {
   for (size_t w = 0; w < _sent->length; w++) {
+    if (resources_exhausted(_opts->resources)) return; // See encode()
     if (_sent->word[w].x == NULL) {
       continue;
     }
@@ -1119,10 +1209,7 @@ void SATEncoder::generate_epsilon_definitions()
     bool join = _sent->word[w].x->next != NULL;
     Exp* exp = join ? join_alternatives(w) : _sent->word[w].x->exp;
 
-    char name[MAX_VARIABLE_NAME];
-    // sprintf(name, "w%zu", w);
-    name[0] = 'w';
-    fast_sprintf(name+1, w);
+    ExpPath name = _variables->word_path(w);
 
     int dfs_position;
 
@@ -1135,19 +1222,17 @@ void SATEncoder::generate_epsilon_definitions()
 }
 
 bool SATEncoder::generate_epsilon_for_expression(int w, int& dfs_position, Exp* e,
-                                                 char* var, bool root, char dir)
+                                                 ExpPath var, bool root, char dir)
 {
   if (e->type == CONNECTOR_type) {
     dfs_position++;
-    if (var != NULL) {
-      if (e->dir == dir) {
-        // generate_literal(-_variables->epsilon(name, var, e->dir));
-        return false;
-      } else {
-        generate_equivalence_definition(Lit(_variables->epsilon(var, dir)),
-                                        Lit(_variables->string(var)));
-        return true;
-      }
+    if (e->dir == dir) {
+      // generate_literal(-_variables->epsilon(name, var, e->dir));
+      return false;
+    } else {
+      generate_equivalence_definition(Lit(_variables->epsilon(var, dir)),
+                                      Lit(_variables->string(var)));
+      return true;
     }
   } else if (e->type == AND_type) {
     if (e->operand_first == NULL) {
@@ -1165,22 +1250,10 @@ bool SATEncoder::generate_epsilon_for_expression(int w, int& dfs_position, Exp*
         int i;
         bool eps = true;
 
-        char new_var[MAX_VARIABLE_NAME];
-        char* last_new_var = new_var;
-        char* last_var = var;
-        while ((*last_new_var = *last_var)) {
-          last_new_var++;
-          last_var++;
-        }
-
+        ExpPath first_var = _variables->operand_paths(var, e);
 
         for (i = 0, opd = e->operand_first; opd != NULL; opd = opd->operand_next, i++) {
-          // sprintf(new_var, "%sc%d", var, i)
-          char* s = last_new_var;
-          *s++ = 'c';
-          fast_sprintf(s, i);
-
-          if (!generate_epsilon_for_expression(w, dfs_position, opd, new_var, false, dir)) {
+          if (!generate_epsilon_for_expression(w, dfs_position, opd, first_var + i, false, dir)) {
             eps = false;
             break;
           }
@@ -1195,11 +1268,7 @@ bool SATEncoder::generate_epsilon_for_expression(int w, int& dfs_position, Exp*
           Lit lhs = Lit(_variables->epsilon(var, dir));
           vec<Lit> rhs;
         for (i = 0, opd = e->operand_first; opd != NULL; opd = opd->operand_next, i++) {
-            // sprintf(new_var, "%sc%d", var, i)
-            char* s = last_new_var;
-            *s++ = 'c';
-            fast_sprintf(s, i);
-            rhs.push(Lit(_variables->epsilon(new_var, dir)));
+            rhs.push(Lit(_variables->epsilon(first_var + i, dir)));
           }
           generate_classical_and_definition(lhs, rhs);
         }
@@ -1215,23 +1284,12 @@ bool SATEncoder::generate_epsilon_for_expression(int w, int& dfs_position, Exp*
       int i;
       bool eps = false;
 
-      char new_var[MAX_VARIABLE_NAME];
-      char* last_new_var = new_var;
-      char* last_var = var;
-      while ((*last_new_var = *last_var)) {
-        last_new_var++;
-        last_var++;
-      }
+      ExpPath first_var = _variables->operand_paths(var, e);
 
       vec<Lit> rhs;
         for (i = 0, opd = e->operand_first; opd != NULL; opd = opd->operand_next, i++) {
-        // sprintf(new_var, "%sc%d", var, i)
-        char* s = last_new_var;
-        *s++ = 'd';
-        fast_sprintf(s, i);
-
-        if (generate_epsilon_for_expression(w, dfs_position, opd, new_var, false, dir) && !root) {
-          rhs.push(Lit(_variables->epsilon(new_var, dir)));
+        if (generate_epsilon_for_expression(w, dfs_position, opd, first_var + i, false, dir) && !root) {
+          rhs.push(Lit(_variables->epsilon(first_var + i, dir)));
           eps = true;
         }
       }
@@ -1255,6 +1313,7 @@ void SATEncoder::power_prune()
   // if not [both of them are the deepest].
 
   for (size_t wl = 0; wl < _sent->length - 2; wl++) {
+    if (resources_exhausted(_opts->resources)) return; // See encode()
     const std::vector<PositionConnector>& rc = _word_tags[wl].get_right_connectors();
     std::vector<PositionConnector>::const_iterator rci;
     for (rci = rc.begin(); rci != rc.end(); rci++) {
@@ -1402,6 +1461,8 @@ void SATEncoder::pp_prune()
 
   for (size_t i=0; i<knowledge->n_contains_one_rules; i++)
   {
+    if (resources_exhausted(_opts->resources)) return; // See encode()
+
     pp_rule rule = knowledge->contains_one_rules[i];
     // const char * selector = rule.selector;         /* selector string for this rule */
     pp_linkset * link_set = rule.link_set;            /* the set of criterion links */
@@ -1549,17 +1610,51 @@ bool SATEncoder::create_linkage(Linkage linkage)
 
 void SATEncoder::generate_linkage_prohibiting()
 {
-  vec<Lit> clause;
+  std::vector<Lit> clause;
   const std::vector<int>& link_variables = _variables->link_variables();
   for (std::vector<int>::const_iterator i = link_variables.begin(); i != link_variables.end(); i++) {
     int var = *i;
     if (_solver->model[var] == l_True) {
-      clause.push(~Lit(var));
+      clause.push_back(~Lit(var));
     } else if (_solver->model[var] == l_False) {
-      clause.push(Lit(var));
+      clause.push_back(Lit(var));
+    }
+  }
+  clause.push_back(~Lit(_round_var));
+  _pending_clauses.push_back(std::move(clause));
+}
+
+void SATEncoder::add_pending_clauses()
+{
+  vec<Lit> clause;
+  for (const std::vector<Lit>& pc : _pending_clauses) {
+    clause.clear();
+    for (Lit l : pc)
+      clause.push(l);
+    _solver->addClause(clause);
+  }
+  _pending_clauses.clear();
+}
+
+/**
+ * Solve under the assumptions of the current round. This is done in
+ * slices of a conflict and propagation budget, so that the resources
+ * (timeout and cancellation) are checked also while solving a hard
+ * formula. On long sentences, a slice of 2000 conflicts alone may take
+ * seconds.
+ * Return l_Undef if the resources got exhausted.
+ */
+lbool SATEncoder::solve()
+{
+  for (;;) {
+    _solver->setConfBudget(SAT_CONFLICT_BUDGET);
+    _solver->setPropBudget(SAT_PROPAGATION_BUDGET);
+    lbool found = _solver->solveLimited(_assumptions);
+    if ((found != l_Undef) || resources_exhausted(_opts->resources)) {
+      _solver->budgetOff();
+      return found;
     }
   }
-  _solver->addClause(clause);
 }
 
 Linkage SATEncoder::get_next_linkage()
@@ -1575,7 +1670,14 @@ Linkage SATEncoder::get_next_linkage()
    * !test=linkage-disconnected is used (and they are sane) */
   bool linkage_ok;
   do {
-    if (!_solver->solve()) return NULL;
+    if (_exhausted) return NULL;
+    add_pending_clauses();
+    lbool found = solve();
+    if (found == l_Undef) return NULL; // Timeout or cancellation
+    if (found == l_False) {
+      _exhausted = true;
+      return NULL;
+    }
 
     std::vector<int> components;
     connected = connectivity_components(components);
@@ -1675,14 +1777,14 @@ void SATEncoderConjunctionFreeSentences::handle_null_expression(int w) {
   add_clause(clause);
 }
 
-void SATEncoderConjunctionFreeSentences::determine_satisfaction(int w, char* name)
+void SATEncoderConjunctionFreeSentences::determine_satisfaction(int w, ExpPath name)
 {
   // All tags must be satisfied
   generate_literal(Lit(_variables->string(name)));
 }
 
 void SATEncoderConjunctionFreeSentences::generate_satisfaction_for_connector(
-    int wi, int pi, Exp *e, char* var)
+    int wi, int pi, Exp *e, ExpPath var)
 {
   const char* Ci = e->condesc->more->string;
   char dir = e->dir;
@@ -1735,6 +1837,7 @@ void SATEncoderConjunctionFreeSentences::generate_linked_definitions()
 
   DEBUG_print("------- linked definitions");
   for (size_t w1 = 0; w1 < _sent->length; w1++) {
+    if (resources_exhausted(_opts->resources)) return; // See encode()
     vec<Lit> linked;
     for (size_t w2 = w1 + 1; w2 < _sent->length; w2++) {
       DEBUG_print("---------- ." << w1 << ". ." << w2 << ".");
@@ -1935,8 +2038,10 @@ bool SATEncoderConjunctionFreeSentences::sat_extract_links(Linkage lkg)
 
 /**
  * Main entry point into the SAT parser.
+ * When the sentence is parsed again, its encoding (and solver) is
+ * reused if the options allow (see SATEncoder::new_round()).
+ * The encoding and the solving stop on a timeout or cancellation.
  * A note about panic mode:
- * - The MiniSAT support for timeout is not yet used (FIXME).
  * - Parsing with null links is not supported (FIXME).
  * So nothing particularly useful happens in a panic mode, and it is
  * left for the user to disable it.
@@ -1955,15 +2060,42 @@ extern "C" int sat_parse(Sentence sent, Parse_Options  opts)
     return 0;
   }
 
+  /* Reuse the encoding of a previous parse of this sentence if it can
+   * express the current options. Else encode it anew. */
   SATEncoder* encoder = (SATEncoder*) sent->hook;
+  bool reencode = false;
   if (encoder) {
     sat_free_linkages(sent, encoder->_next_linkage_index);
-    delete encoder;
+    if (encoder->new_round(opts)) {
+      lgdebug(+D_SAT, "Reusing the SAT encoding\n");
+    } else {
+      delete encoder;
+      encoder = NULL;
+      reencode = true;
+    }
   }
 
-  encoder = new SATEncoderConjunctionFreeSentences(sent, opts);
-  sent->hook = encoder;
-  encoder->encode();
+  if (!encoder) {
+    /* A sentence whose options have changed is likely to be parsed
+     * again (e.g. in a panic mode), so its new encoding allows a higher
+     * cost cutoff without re-encoding. This is not done on the first
+     * encoding, since the cost guards have some solving overhead. */
+    encoder = new SATEncoderConjunctionFreeSentences(sent, opts, reencode);
+    sent->hook = encoder;
+    if (encoder->encode()) {
+      encoder->new_round(opts);
+    } else {
+      delete encoder;
+      sent->hook = NULL;
+    }
+  }
+
+  if (!sent->hook || resources_exhausted(opts->resources)) {
+    sent->num_valid_linkages = 0;
+    sent->num_linkages_found = 0;
+    sent->num_linkages_post_processed = 0;
+    return 0;
+  }
 
   LinkageIdx linkage_limit = opts->linkage_limit;
   LinkageIdx k;
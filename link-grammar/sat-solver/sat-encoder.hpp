@@ -17,11 +17,17 @@ class SATEncoder
 public:
 
   // Construct the encoder based on given sentence
-  SATEncoder(Sentence sent, Parse_Options  opts)
-    : _variables(new Variables(sent)), _solver(new Solver()),
+  // If flexible_cost is true, a higher cost cutoff can later be used
+  // without re-encoding (see generate_cost_guards()).
+  SATEncoder(Sentence sent, Parse_Options  opts, bool flexible_cost)
+    : _flexible_cost(flexible_cost),
+      _variables(new Variables(sent)), _solver(new Solver()),
       _opts(opts), _sent(sent)
   {
     _cost_cutoff = parse_options_get_disjunct_cost(opts);
+    _short_length = opts->short_length;
+    _all_short = opts->all_short;
+    _pp_prune = opts->perform_pp_prune;
 
     verbosity = opts->verbosity;
     debug = opts->debug;
@@ -37,8 +43,14 @@ public:
     delete _solver;
   }
 
-  // Create the formula from the sentence
-  void encode();
+  // Create the formula from the sentence. False if interrupted.
+  bool encode();
+
+  // Start a new round of linkage enumeration, with the given options.
+  // The options are expressed as assumptions, so the solver (and what
+  // it has learned) is kept. Return false if the encoding cannot
+  // express them; the sentence should then be encoded anew.
+  bool new_round(Parse_Options opts);
 
   // Solve the formula, returning the next linkage.
   Linkage get_next_linkage();
@@ -58,23 +70,23 @@ protected:
    */
 
   // Top-level method that generates satisfaction conditions for every
-  // word in the sentence
-  void generate_satisfaction_conditions();
+  // word in the sentence. False if interrupted.
+  bool generate_satisfaction_conditions();
 
   // Generates satisfaction conditions for the word-tag expression e
-  void generate_satisfaction_for_expression(int w, int& dfs_position, Exp* e, char* var,
+  void generate_satisfaction_for_expression(int w, int& dfs_position, Exp* e, ExpPath var,
                                             double parent_cost);
 
   // Handle the case of NULL expression of a word
   virtual void handle_null_expression(int w) = 0;
 
   // Determine if this word-tag must be satisfied and generate appropriate clauses
-  virtual void determine_satisfaction(int w, char* name) = 0;
+  virtual void determine_satisfaction(int w, ExpPath name) = 0;
 
   // Generates satisfaction condition for the connector (wi, pi)
   virtual void generate_satisfaction_for_connector(int wi, int pi, 
                                                    Exp* e,
-                                                   char* var) = 0;
+                                                   ExpPath var) = 0;
 
   // Definition of link_cw((wi, pi), wj) variables when wj is an ordinary word
   void generate_link_cw_ordinary_definition(size_t wi, int pi,
@@ -179,7 +191,7 @@ protected:
   // Generate definition of epsilon variables that are used for power
   // pruning
   void generate_epsilon_definitions();
-  bool generate_epsilon_for_expression(int w, int& dfs_position, Exp* e, char* var, bool root, char dir);
+  bool generate_epsilon_for_expression(int w, int& dfs_position, Exp* e, ExpPath var, bool root, char dir);
 
 
   // Power pruning
@@ -189,11 +201,52 @@ protected:
   virtual void add_additional_power_pruning_conditions(vec<Lit>& clause, int wl, int wr)
   {}
 
-  // Cost cutoff threshold value. Nodes of the expression tree are
-  // pruned if their cost exceeds this value. Cost cutoff is performed
-  // during satisfaction condition generating.
+  // Cost cutoff threshold value at encoding time. Nodes of the
+  // expression tree whose cost exceeds it are disabled.
   double _cost_cutoff;
 
+  // Disable the costly nodes by a guard variable per cost value, so
+  // any cutoff that is not lower can be used without re-encoding.
+  bool _flexible_cost;
+
+  // Nodes whose cost exceeds _cost_cutoff: (total cost, variable).
+  std::vector<std::pair<double, int>> _costly_nodes;
+
+  // The guard variable of each cost of _costly_nodes.
+  std::map<double, int> _cost_guards;
+
+  // Generate the guard clauses of _costly_nodes.
+  void generate_cost_guards();
+
+  // Encoding-time options that are not expressed as assumptions.
+  // A connector length limit tighter than the encoded one is
+  // expressed by assumptions on the link variables.
+  size_t _short_length;
+  bool _all_short;
+  bool _pp_prune;
+
+  // Assumptions of the current round.
+  vec<Lit> _assumptions;
+
+  // The blocking clauses of a round are conditioned on its variable,
+  // and are retired at the next round.
+  int _round_var = -1;
+
+  // No more linkages in this round.
+  bool _exhausted = false;
+
+  // Blocking clauses that were not yet passed to the solver. They are
+  // added in a batch just before the next solving.
+  std::vector<std::vector<Lit>> _pending_clauses;
+  void add_pending_clauses();
+
+  // Add the length-limit assumptions for the given options.
+  // Return false if some limit is looser than the encoded one.
+  bool assume_length_limits(Parse_Options opts);
+
+  // Create a variable to be used as an assumption literal.
+  int control_variable();
+
   /**
    *   Creating clauses and passing them to the MiniSAT solver
    */
@@ -279,6 +332,9 @@ protected:
   // Generate clause that prohibits the current model
   void generate_linkage_prohibiting();
 
+  // Find the next model, checking the resources while solving
+  lbool solve();
+
   // Object that contains all information about the variable
   // encoding.
   Variables* _variables;
@@ -320,8 +376,9 @@ public:
 class SATEncoderConjunctionFreeSentences : public SATEncoder
 {
 public:
-  SATEncoderConjunctionFreeSentences(Sentence sent, Parse_Options  opts)
-    : SATEncoder(sent, opts) {
+  SATEncoderConjunctionFreeSentences(Sentence sent, Parse_Options  opts,
+                                     bool flexible_cost)
+    : SATEncoder(sent, opts, flexible_cost) {
 #if 0
     fprintf(stderr, "random_var_freq=%e\ngarbage_frac=%e\nclause_decay=%e\n"
            "restart_first=%d\nvar_decay=%e\n",
@@ -341,10 +398,10 @@ public:
   }
 
   virtual void handle_null_expression(int w);
-  virtual void determine_satisfaction(int w, char* name);
+  virtual void determine_satisfaction(int w, ExpPath name);
   virtual void generate_satisfaction_for_connector(int wi, int pi,
                                                    Exp* e,
-                                                   char* var);
+                                                   ExpPath var);
 
 
   virtual void generate_linked_definitions();
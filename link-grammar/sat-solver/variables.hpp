@@ -2,8 +2,10 @@
 #define __VARIABLES_HPP__
 
 #include <ctype.h>
+#include <stdint.h>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <iostream>
 
 using std::cout;
@@ -11,17 +13,30 @@ using std::cerr;
 using std::endl;
 
 #include "guiding.hpp"
-#include "trie.hpp"
 #include "matrix-ut.hpp"
-#include "fast-sprintf.hpp"
-
-#define  MAX_VARIABLE_NAME 256
 
 extern "C"
 {
 #include "api-structures.h" // for definition of Sentence
 }
 
+/*
+ * An expression node of a word is identified by its path from the root
+ * of the word expression: the operand numbers at each n-ary AND and OR
+ * node on the way (unary nodes are skipped). Paths are dense integers.
+ * The root of the expression of word w is w, and the operands of a
+ * node get consecutive numbers when they are first asked for. Since
+ * all the passes of the encoder walk the same expressions, they get
+ * the same path numbers.
+ */
+typedef int ExpPath;
+
+/* A hash key made of two non-negative ints. */
+static inline uint64_t int_pair_key(int i, int j)
+{
+  return ((uint64_t)(unsigned int)i << 32) | (unsigned int)j;
+}
+
 // #define SAT_DEBUG
 // #define _VARS
 
@@ -69,7 +84,10 @@ class Variables
 {
 public:
   Variables(Sentence sent)
-    : _link_variable_map(sent->length)
+    : _path_variables(sent->length, -1)
+    ,_path_epsilon_variables(sent->length, std::make_pair(-1, -1))
+    ,_path_operands(sent->length, -1)
+    ,_link_variable_map(sent->length)
     ,_linked_variable_map(sent->length, -1)
     ,_link_cw_variable_map(sent->length)
     ,_guiding(new CostDistanceGuiding(sent))
@@ -93,42 +111,63 @@ public:
   }
 
 
+  // A variable that is not a part of the sentence encoding, to be
+  // used as an assumption literal.
+  int control_variable() {
+    return get_fresh_var();
+  }
+
   /*
-   * General purpose variables specified by their names
+   * Paths of expression nodes (see ExpPath)
    */
 
-  bool var_exists(const char* name) {
-    try {
-      int num = _variable_trie.lookup(name);
-      return num != Trie<int>::NOT_FOUND;
-      } catch (const std::string& s) {
-          cout << s << endl;
-          exit(EXIT_FAILURE);
-        }
+  // The path of the root of the expression of word w
+  ExpPath word_path(int w) const {
+    return w;
   }
 
+  // The path of the first operand of the n-ary node e at the given
+  // path. The path of operand i is this + i.
+  ExpPath operand_paths(ExpPath path, const Exp* e) {
+    if (_path_operands[path] == -1) {
+      size_t n = 0;
+      for (const Exp* opd = e->operand_first; opd != NULL; opd = opd->operand_next)
+        n++;
+      size_t first = _path_variables.size();
+      _path_operands[path] = first;
+      _path_variables.resize(first + n, -1);
+      _path_epsilon_variables.resize(first + n, std::make_pair(-1, -1));
+      _path_operands.resize(first + n, -1);
+    }
+    return _path_operands[path];
+  }
+
+  /*
+   * Variables that specify that the expression node at the given path
+   * is satisfied
+   */
+
   // If guiding params are unknown, they are set to default
-  int string(const char* name)
+  int string(ExpPath path)
   {
-    int var;
-    if (!get_var_from_trie(name, var)) {
+    int var = _path_variables[path];
+    if (var == -1) {
+      var = _path_variables[path] = get_fresh_var();
 #ifdef _VARS
-      var_defs_stream << name << "\t" << var << endl;
+      var_defs_stream << "exp_" << path << "\t" << var << endl;
 #endif
-      _guiding->setStringParameters(var, name);
+      _guiding->setStringParameters(var);
     }
-    assert(var != -1, "Var == -1");
     return var;
   }
 
   // If the cost is explicitly given, guiding params are calculated
   // using the cost. Any params set earlier are overridden.
-  int string_cost(const char* name, double cost)
+  int string_cost(ExpPath path, double cost)
   {
     int var;
-    var = string(name);
-    _guiding->setStringParameters(var, name, cost);
-    assert(var != -1, "Var == -1");
+    var = string(path);
+    _guiding->setStringParameters(var, cost);
     return var;
   }
 
@@ -138,21 +177,38 @@ public:
    */
 
   // If guiding params are unknown, they are set to default
-  int epsilon(char* v, char dir) {
-    char name[MAX_VARIABLE_NAME];
-    dir = (dir == '+') ? 'r' : 'l';
-    char* s = name;
-    *s++ = dir;
-    *s++ = 'e';
-    s = fast_sprintf(s, v);
-    int var;
-    if (!get_var_from_trie(name, var)) {
+  int epsilon(ExpPath path, char dir) {
+    std::pair<int, int>& vars = _path_epsilon_variables[path];
+    int& var = (dir == '+') ? vars.first : vars.second;
+    if (var == -1) {
+      var = get_fresh_var();
 #ifdef _VARS
-      var_defs_stream << name << "\t" << var << endl;
+      var_defs_stream << ((dir == '+') ? "re_" : "le_") << path << "\t" << var << endl;
 #endif
       _guiding->setEpsilonParameters(var);
     }
-    assert(var != -1, "Var == -1");
+    return var;
+  }
+
+  /*
+   * Variables that stand for a linked(wi, wj) variable, when the
+   * optional words among wi and wj (given here, or -1) are present.
+   * They are used to refine the connectivity of a linkage.
+   */
+  int conditional_linked(int linked_var, int wi, int wj, bool& existed) {
+    uint64_t key = int_pair_key(linked_var, (wi + 1) << 16 | (wj + 1));
+    std::unordered_map<uint64_t, int>::iterator it = _conditional_linked_map.find(key);
+    existed = (it != _conditional_linked_map.end());
+    if (existed)
+      return it->second;
+
+    int var = get_fresh_var();
+#ifdef _VARS
+    var_defs_stream << "linked_" << linked_var << "_" << wi << "_" << wj
+                    << "\t" << var << endl;
+#endif
+    _guiding->setStringParameters(var);
+    _conditional_linked_map[key] = var;
     return var;
   }
 
@@ -243,15 +299,13 @@ public:
 
   // Variables that specify that words i and j are connected
   int con(int i, int j) {
-    char name[MAX_VARIABLE_NAME];
-    char* s = name;
-    *s++ = 'c';
-    s = fast_sprintf(s, i);
-    *s++ = '_';
-    s = fast_sprintf(s, j);
-    int var;
-    if (!get_var_from_trie(name, var))
-      set_variable_sat_params(var, false);
+    uint64_t key = int_pair_key(i, j);
+    std::unordered_map<uint64_t, int>::iterator it = _con_variables.find(key);
+    if (it != _con_variables.end())
+      return it->second;
+    int var = get_fresh_var();
+    _con_variables[key] = var;
+    set_variable_sat_params(var, false);
     return var;
   }
 
@@ -274,25 +328,23 @@ public:
 
   // Returns the indices of all link_x_x_wj_pj variables
   const std::vector<int>& link_variables(int wj, int pj) {
-    std::pair<int, int> p(wj, pj);
-    return _link_variable_wp_map[p];
+    return _link_variable_wp_map[int_pair_key(wj, pj)];
   }
 
   // Additional info about the link(wi, pi, wj, pj) variable
   struct LinkVar
   {
-    LinkVar(const std::string& _name, char* _label,
+    LinkVar(char* _label,
             int _lw, int _lp, int _rw, int _rp,
             const char* _lc, const char* _rc,
             Exp* _le, Exp* _re)
-      : name(_name), label(_label),
+      : label(_label),
         left_word(_lw), right_word(_rw),
         left_position(_lp), right_position(_rp),
         left_connector(_lc), right_connector(_rc),
         left_exp(_le), right_exp(_re)
     {}
 
-    std::string name;
     char* label;
     int left_word;
     int right_word;
@@ -339,25 +391,35 @@ public:
 
 private:
   /*
-   * Information about string variables
+   * Information about the variables of expression paths
    */
 
-  // What is the number of the variable with the given name?
-  Trie<int> _variable_trie;
+  // What is the number of the variable of the given path?
+  std::vector<int> _path_variables;
+
+  // What are the numbers of its epsilon variables (right, left)?
+  std::vector< std::pair<int, int> > _path_epsilon_variables;
+
+  // What is the path of its first operand?
+  std::vector<ExpPath> _path_operands;
+
+  // What is the number of the conditional linked variable?
+  std::unordered_map<uint64_t, int> _conditional_linked_map;
 
   /*
    * Information about link(wi, pi, wj, pj) variables
    */
 
   // What is the number of the link(wi, pi, wj, pj) variable?
-  MatrixUpperTriangle< std::map<std::pair<int, int>, int> > _link_variable_map;
+  // (Indexed by (wi, wj); the key is (pi, pj).)
+  MatrixUpperTriangle< std::unordered_map<uint64_t, int> > _link_variable_map;
 
 
   // What are the numbers of all link(wi, pi, wj, pj) variables?
   std::vector<int>  _link_variables_indices;
 
   // What are the numbers of all link(x, x, wj, pj) variables?
-  std::map< std::pair<int, int>, std::vector<int> > _link_variable_wp_map;
+  std::unordered_map< uint64_t, std::vector<int> > _link_variable_wp_map;
 
 
   // Additional info about the link(wi, pi, wj, pj) variable with the given number
@@ -367,33 +429,12 @@ private:
   void add_link_variable(int i, int pi, const char* ci, Exp* ei,
                          int j, int pj, const char* cj, Exp* ej, size_t var)
   {
-  /* The following variable is created but is never inserted to the trie,
-     and generating it has an observable performance impact.
-     The trie even doesn't have 'k'. */
-#if 0
-    char name[MAX_VARIABLE_NAME];
-    char* s = name;
-    *s++ = 'l';    *s++ = 'i';     *s++ = 'n';     *s++ = 'k';
-    *s++ = '_';
-    s = fast_sprintf(s, i);
-    *s++ = '_';
-    s = fast_sprintf(s, pi);
-    *s++ = '_';
-    s = fast_sprintf(s, ci);
-    *s++ = '_';
-    s = fast_sprintf(s, j);
-    *s++ = '_';
-    s = fast_sprintf(s, pj);
-    *s++ = '_';
-    s = fast_sprintf(s, cj);
-#endif
     char* label = construct_link_label(ci, cj);
 
     if (var >= _link_variables.size()) {
       _link_variables.resize(var + 1, 0);
     }
-    // The first argument was the redundant variable eliminated above
-    _link_variables[var] = new LinkVar("", label, i, pi, j, pj, ci, cj, ei, ej);
+    _link_variables[var] = new LinkVar(label, i, pi, j, pj, ci, cj, ei, ej);
     _link_variables_indices.push_back(var);
   }
 
@@ -423,10 +464,11 @@ private:
    *   Information about the link_cw(w, wj, pj) variables
    */
   // What is the number of the link_cw(wi, wj, pj) variable?
-  Matrix< std::map<int, int> > _link_cw_variable_map;
+  Matrix< std::unordered_map<int, int> > _link_cw_variable_map;
 
 
 #ifdef _CONNECTIVITY_
+  std::unordered_map<uint64_t, int> _con_variables;
   std::map<std::pair<std::pair<int, int>,int>, int> _lcon_variables;
 #endif
 
@@ -446,25 +488,6 @@ private:
      fresh variable number, and false is returned. Otherwise, the number
      is retrieved and true is returned. */
 
-  bool get_var_from_trie(const char* name, int& var) {
-    try {
-      int num = _variable_trie.lookup(name);
-      if (num != Trie<int>::NOT_FOUND) {
-        var = num;
-        return true;
-      }
-      else {
-        var = get_fresh_var();
-        _variable_trie.insert(name, var);
-        return false;
-      }
-    } catch (const std::string& s) {
-      cout << s << endl;
-      exit(EXIT_FAILURE);
-    }
-  }
-
-
   bool get_2int_variable(int i, int j, int& var,
                          Matrix<int>& mp) {
     var = mp(i, j);
@@ -477,9 +500,9 @@ private:
   }
 
   bool get_3int_variable(int i, int j, int pj, int& var,
-                         Matrix< std::map<int, int> >& mp) {
-    std::map<int, int>& m = mp(i, j);
-    std::map<int, int>::iterator it = m.find(pj);
+                         Matrix< std::unordered_map<int, int> >& mp) {
+    std::unordered_map<int, int>& m = mp(i, j);
+    std::unordered_map<int, int>::iterator it = m.find(pj);
     if (it == m.end()) {
       var = get_fresh_var();
       m[pj] = var;
@@ -491,10 +514,10 @@ private:
   }
 
   bool get_4int_variable(int i, int pi, int j, int pj, int& var,
-                         Matrix< std::map<std::pair<int, int>, int> >& mp) {
-    std::map< std::pair<int, int>, int >& m = mp(i, j);
-    std::pair<int, int> p(pi, pj);
-    std::map< std::pair<int, int>, int >::iterator it = m.find(p);
+                         Matrix< std::unordered_map<uint64_t, int> >& mp) {
+    std::unordered_map<uint64_t, int>& m = mp(i, j);
+    uint64_t p = int_pair_key(pi, pj);
+    std::unordered_map<uint64_t, int>::iterator it = m.find(p);
     if (it == m.end()) {
       var = get_fresh_var();
       m[p] = var;
@@ -508,8 +531,7 @@ private:
   bool get_link_variable(int i, int pi, int j, int pj, int& var) {
     bool ret = get_4int_variable(i, pi, j, pj, var, _link_variable_map);
     if (!ret) {
-      std::pair<int, int> p(j, pj);
-      _link_variable_wp_map[p].push_back(var);
+      _link_variable_wp_map[int_pair_key(j, pj)].push_back(var);
     }
     return ret;
   }
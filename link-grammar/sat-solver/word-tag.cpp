@@ -1,5 +1,4 @@
 #include "word-tag.hpp"
-#include "fast-sprintf.hpp"
 
 extern "C" {
 #ifdef DEBUG
@@ -15,7 +14,7 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
                                 bool& leading_right, bool& leading_left,
                                 std::vector<int>& eps_right,
                                 std::vector<int>& eps_left,
-                                char* var, bool root, double parent_cost,
+                                ExpPath var, bool root, double parent_cost,
                                 Exp* parent_exp, const X_node *word_xnode)
 {
   double cost = parent_cost + exp->cost;
@@ -26,7 +25,7 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
   {
     const char*type =
       ((const char *[]) {"OR_type", "AND_type", "CONNECTOR_type"}) [exp->type-1];
-    printf("Expression type %s for Word%d, var %s:\n", type, _word, var);
+    printf("Expression type %s for Word%d, var %d:\n", type, _word, var);
     //printf("parent_exp: %s\n", lg_exp_stringify(parent_exp));
     printf("exp(%s) e=%.2f pc=%.2f %s\n",
            word_xnode->string,exp->cost, parent_cost, lg_exp_stringify(exp));
@@ -64,7 +63,7 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
       /* zeroary and */
       if (cost != 0)
       {
-        lgdebug(+D_IC, "EmptyConnector var=%s(%d) cost %.2f pcost %.2f\n",
+        lgdebug(+D_IC, "EmptyConnector var=%d(%d) cost %.2f pcost %.2f\n",
                 var, _variables->string(var), cost, parent_cost);
         _empty_connectors.push_back(EmptyConnector(_variables->string(var),cost));
       }
@@ -77,18 +76,10 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
         int i;
         Exp* opd;
 
-        char new_var[MAX_VARIABLE_NAME];
-        char* last_new_var = new_var;
-        char* last_var = var;
-        while ((*last_new_var = *last_var)) {
-          last_new_var++;
-          last_var++;
-        }
+        ExpPath first_var = _variables->operand_paths(var, exp);
 
         for (i = 0, opd = exp->operand_first; opd != NULL; opd = opd->operand_next, i++) {
-          char* s = last_new_var;
-          *s++ = 'c';
-          fast_sprintf(s, i);
+          ExpPath new_var = first_var + i;
 
           double and_cost = (i == 0) ? cost : 0;
           insert_connectors(opd, dfs_position, leading_right, leading_left,
@@ -113,17 +104,11 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
       bool ll_true = false;
       bool lr_true = false;
 
-      char new_var[MAX_VARIABLE_NAME];
-      char* last_new_var = new_var;
-      char* last_var = var;
-      while ((*last_new_var = *last_var)) {
-        last_new_var++;
-        last_var++;
-      }
+      ExpPath first_var = _variables->operand_paths(var, exp);
 
 #ifdef DEBUG
       if (0 && verbosity_level(+D_IC)) { // Extreme debug
-        printf("Word%d, var %s OR_type:\n", _word, var);
+        printf("Word%d, var %d OR_type:\n", _word, var);
         printf("exp mem: "); prt_exp_mem(exp);
       }
 #endif
@@ -132,14 +117,12 @@ void WordTag::insert_connectors(Exp* exp, int& dfs_position,
         bool lr = leading_right, ll = leading_left;
         std::vector<int> er = eps_right, el = eps_left;
 
-        char* s = last_new_var;
-        *s++ = 'd';
-        fast_sprintf(s, i);
+        ExpPath new_var = first_var + i;
 
-        assert(word_xnode != NULL, "NULL X_node for var %s", new_var);
+        assert(word_xnode != NULL, "NULL X_node for var %d", new_var);
         if (root)
         {
-          lgdebug(+D_IC, "Word%d: var: %s; exp%d=%p; X_node: %s\n",
+          lgdebug(+D_IC, "Word%d: var: %d; exp%d=%p; X_node: %s\n",
                   _word, new_var, i, opd, word_xnode->word->subword);
         }
 
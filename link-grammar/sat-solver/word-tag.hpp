@@ -36,6 +36,7 @@ struct PositionConnector
     connector.multi = e->multi;
     connector.farthest_word = e->farthest_word;
     connector.originating_gword = &w_xnode->word->gword_set_head;
+    connector.next = NULL;
 
     /*
     cout << c->string << " : ." << w << ". : ." << p << ". ";
@@ -189,7 +190,7 @@ public:
                          bool& leading_right, bool& leading_left,
                          std::vector<int>& eps_right,
                          std::vector<int>& eps_left,
-                         char* var, bool root, double parent_cost,
+                         ExpPath var, bool root, double parent_cost,
                          Exp* parent, const X_node *word_xnode);
 
   // Caches information about the found matches to the _matches vector, and also
@@ -16,11 +16,16 @@
 #include "dict-common/dict-utils.h"
 #include "disjunct-utils.h"             // free_sentence_disjuncts
 #include "linkage/linkage.h"
+#include "parse/forest.h"               // free_forest
 #include "parse/histogram.h"            // PARSE_NUM_OVERFLOW
 #include "parse/parse.h"
+#include "portfolio.h"
 #include "post-process/post-process.h"  // post_process_new
 #include "prepare/exprune.h"
+#include "prepare/reuse-disjuncts.h"  // free_disjunct_record
+#include "prune-cache.h"
 #include "resources.h"
+#include "result-cache.h"
 #include "sat-solver/sat-encoder.h"
 #include "tokenize/lookup-exprs.h"
 #include "tokenize/tokenize.h"
@@ -44,7 +49,7 @@ Sentence sentence_create(const char *input_string, Dictionary dict)
 	memset(sent, 0, sizeof(struct Sentence_s));
 
 	sent->dict = dict;
-	sent->string_set = string_set_create();
+	sent->string_set = string_set_create_overlay(dict->string_set);
 	sent->rand_state = global_rand_state;
 	sent->Exp_pool = pool_new(__func__, "Exp", /*num_elements*/4096,
 	                             sizeof(Exp), /*zero_out*/false,
@@ -89,6 +94,9 @@ int sentence_split(Sentence sent, Parse_Options opts)
 		sent->rand_state = global_rand_state;
 	}
 
+	/* Words borrowed from the result cache are not a split sentence. */
+	result_cache_release(sent);
+
 	/* Tokenize */
 	if (!separate_sentence(sent, opts))
 	{
@@ -123,8 +131,12 @@ int sentence_split(Sentence sent, Parse_Options opts)
 void sentence_delete(Sentence sent)
 {
 	if (!sent) return;
+	result_cache_release(sent);
 	sat_sentence_delete(sent);
 	free_sentence_disjuncts(sent, /*categories_too*/true);
+	free_disjunct_record(sent->disjunct_record);
+	prune_cache_entry_delete(sent->prune_cache_entry);
+	free_forest(sent->forest);
 	free_words(sent);
 	wordgraph_delete(sent);
 	string_set_delete(sent->string_set);
@@ -135,7 +147,6 @@ void sentence_delete(Sentence sent)
 	free(sent->disjunct_used);
 
 	global_rand_state = sent->rand_state;
-	pool_delete(sent->Match_node_pool);
 	pool_delete(sent->Table_tracon_pool);
 	pool_delete(sent->wordvec_pool);
 	pool_delete(sent->Exp_pool);
@@ -219,6 +230,17 @@ float sentence_disjunct_cost(Sentence sent, LinkageIdx i)
 	return sent->lnkages[i].lifo.disjunct_cost;
 }
 
+/**
+ * Return the disjunct cost cutoff that has been used for parsing the
+ * sentence. It is lower than the one in the parse options if it has
+ * been lowered due to a count overflow (see parse_options_set_adaptive_cost()).
+ */
+float sentence_max_disjunct_cost(Sentence sent)
+{
+	if (!sent) return 0.0;
+	return sent->disjunct_cost;
+}
+
 int sentence_link_cost(Sentence sent, LinkageIdx i)
 {
 	if (!sent) return 0;
@@ -254,6 +276,26 @@ int sentence_parse(Sentence sent, Parse_Options opts)
 		opts->max_disjuncts = dict->default_max_disjuncts;
 
 	sent->num_valid_linkages = 0;
+	sent->disjunct_cost = opts->disjunct_cost;
+
+	/* If this sentence has been parsed before, its results may have come
+	 * from the result cache. Return them before doing anything else. */
+	result_cache_release(sent);
+	free_forest(sent->forest);
+	sent->forest = NULL;
+
+	char *cache_key = NULL;
+	if (result_cache_enabled(dict, opts))
+	{
+		cache_key = result_cache_key(sent, opts);
+		if (result_cache_lookup(sent, cache_key))
+		{
+			free(cache_key);
+			resources_reset(opts->resources);
+			print_time(opts, "Found in the result cache");
+			return sent->num_valid_linkages;
+		}
+	}
 
 	/* If the sentence has not yet been split, do so now.
 	 * This is for backwards compatibility, for existing programs
@@ -262,7 +304,11 @@ int sentence_parse(Sentence sent, Parse_Options opts)
 	if (0 == sent->length)
 	{
 		int rc = sentence_split(sent, opts);
-		if (rc) return -1;
+		if (rc)
+		{
+			free(cache_key);
+			return -1;
+		}
 	}
 	else
 	{
@@ -278,34 +324,65 @@ int sentence_parse(Sentence sent, Parse_Options opts)
 	{
 		prt_error("Error: sentence too long, contains more than %d words\n",
 			MAX_SENTENCE);
+		free(cache_key);
 		return -2;
 	}
 
 	resources_reset(opts->resources);
-	for (WordIdx w = 0; w < sent->length; w++)
-	{
-		for (X_node *x = sent->word[w].x; x != NULL; x = x->next)
-			set_connector_farthest_word(x->exp, (int)w, (int)sent->length, opts);
-	}
+	resources_track_space(opts->resources, &sent->space_in_use);
+
+	/* The recorded disjuncts (if any) are from the previous parse, and
+	 * the expressions are going to change. */
+	free_disjunct_record(sent->disjunct_record);
+	sent->disjunct_record = NULL;
+
+	/* The pruned disjuncts may be in the prune cache. */
+	prune_cache_lookup(sent, opts);
 
 	/* Expressions were set up during the tokenize stage.
-	 * Prune them, and then parse.
+	 * Prune them (unless a pipeline has already done that on
+	 * another thread, or their pruned disjuncts have been found
+	 * in the prune cache), and then parse.
 	 */
-	expression_prune(sent, opts);
-	print_time(opts, "Finished expression pruning");
+	if (sent->exp_pruned)
+	{
+		sent->exp_pruned = false;
+	}
+	else if (!prune_cache_found(sent))
+	{
+		for (WordIdx w = 0; w < sent->length; w++)
+		{
+			for (X_node *x = sent->word[w].x; x != NULL; x = x->next)
+				set_connector_farthest_word(x->exp, (int)w, (int)sent->length, opts);
+		}
+
+		expression_prune(sent, opts);
+		print_time(opts, "Finished expression pruning");
+	}
 
 #if USE_SAT_SOLVER
 	if (opts->use_sat_solver)
 	{
 		sat_parse(sent, opts);
 	}
+	else if (opts->portfolio)
+	{
+		portfolio_parse(sent, opts);
+	}
 	else
 #endif
 	{
 		classic_parse(sent, opts);
 	}
+	resources_track_space(opts->resources, NULL);
 	print_time(opts, "Finished parse");
 
+	if (NULL != cache_key)
+	{
+		result_cache_insert(sent, opts, cache_key);
+		free(cache_key);
+	}
+
 	if ((verbosity > 0) && !IS_GENERATION(sent->dict) &&
 	   (PARSE_NUM_OVERFLOW < sent->num_linkages_found))
 	{
@@ -314,5 +391,38 @@ int sentence_parse(Sentence sent, Parse_Options opts)
 			"At the command line, use !cost-max\n",
 			sent->null_count, sent->num_linkages_found);
 	}
+	else if ((verbosity > 0) && (sent->disjunct_cost < opts->disjunct_cost))
+	{
+		prt_error("Info: Combinatorial explosion avoided by lowering "
+		          "the max disjunct cost to %.2f\n", sent->disjunct_cost);
+	}
 	return sent->num_valid_linkages;
 }
+
+/**
+ * Parse \p sent, which is an edited version of the sentence \p prev,
+ * reusing the disjuncts of the words that are not affected by the edit.
+ * The result is the same as that of sentence_parse().
+ *
+ * Only a previous sentence that has been parsed by sentence_reparse()
+ * (possibly with a NULL \p prev) can be reused, and it must not be
+ * deleted before this call returns. Typically, an editor keeps the last
+ * sentence, and after each edit calls sentence_reparse() with it and
+ * then deletes it.
+ *
+ * The recorded disjuncts of \p prev are taken over by \p sent, so each
+ * sentence can serve as the previous one only once. Disjuncts are
+ * recorded only by this call, not by a later sentence_parse().
+ */
+int sentence_reparse(Sentence sent, Sentence prev, Parse_Options opts)
+{
+	sent->record_disjuncts = true;
+	if ((prev != sent) && (NULL != prev) && (prev->dict == sent->dict))
+		sent->reparse_prev = prev;
+
+	int rc = sentence_parse(sent, opts);
+	sent->reparse_prev = NULL;
+	sent->record_disjuncts = false;
+
+	return rc;
+}
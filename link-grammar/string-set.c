@@ -39,6 +39,18 @@
    String_set * string_set_create(void);
      Create a new empty String_set.
 
+   String_set * string_set_create_overlay(const String_set *base);
+     Create a new empty String_set on top of the frozen set "base".
+     Strings that are in "base" are returned from there, so they are
+     not copied, and pointer equality still holds across the two sets.
+     Only new strings are copied to the overlay.
+     Since "base" is never changed, any number of overlays (e.g. of
+     sentences in different threads) can use it without locking.
+
+   void string_set_freeze(String_set *ss);
+     Disallow adding new strings to "ss", so it can be used as a base.
+     string_set_add() can still be used for strings that are in it.
+
    string_set_delete(String_set *ss);
      Free all the space associated with this string set.
 
@@ -124,12 +136,32 @@ String_set * string_set_create(void)
 	ss->string_pool = NULL;
 	ss_pool_alloc(MEM_POOL_INIT, ss);
 	ss->available_count = MAX_STRING_SET_TABLE_SIZE(ss->size);
+	ss->base = NULL;
+	ss->frozen = false;
 
 	return ss;
 }
 
+/**
+ * Create an overlay set of \p base. If \p base is not frozen (e.g. the
+ * string set of a dictionary that is still being added to), it is not
+ * used, and a plain string set is created.
+ */
+String_set * string_set_create_overlay(const String_set *base)
+{
+	String_set *ss = string_set_create();
+
+	if ((NULL != base) && base->frozen) ss->base = base;
+	return ss;
+}
+
+void string_set_freeze(String_set *ss)
+{
+	ss->frozen = true;
+}
+
 static bool place_found(const char *str, const ss_slot *slot, unsigned int hash,
-                         String_set *ss)
+                         const String_set *ss)
 {
 	if (slot->str == NULL) return true;
 	if (hash != slot->hash) return false;
@@ -140,7 +172,8 @@ static bool place_found(const char *str, const ss_slot *slot, unsigned int hash,
  * lookup the given string in the table.  Return an index
  * to the place it is, or the place where it should be.
  */
-static unsigned int find_place(const char *str, unsigned int h, String_set *ss)
+static unsigned int find_place(const char *str, unsigned int h,
+                               const String_set *ss)
 {
 	unsigned int coll_num = 0;
 	unsigned int key = ss->mod_func(h);
@@ -182,15 +215,8 @@ static void grow_table(String_set *ss)
 	free(old.table);
 }
 
-const char * string_set_add(const char * source_string, String_set * ss)
+static const char *ss_strcopy(const char *source_string, String_set *ss)
 {
-	assert(source_string != NULL, "STRING_SET: Can't insert a null string");
-
-	unsigned int h = hash_string(source_string, ss);
-	unsigned int p = find_place(source_string, h, ss);
-
-	if (ss->table[p].str != NULL) return ss->table[p].str;
-
 	size_t len = strlen(source_string) + 1;
 	char *str;
 
@@ -198,11 +224,43 @@ const char * string_set_add(const char * source_string, String_set * ss)
 	/* Store the String_set structure address for debug verifications */
 	size_t mlen = (len&~(sizeof(ss)-1)) + 2*sizeof(ss);
 	str = ss_stralloc(mlen, ss);
-	*(String_set **)&str[mlen-sizeof(ss)] = ss;
+	*(const String_set **)&str[mlen-sizeof(ss)] =
+		(NULL == ss->base) ? ss : ss->base;
 #else /* !DEBUG */
 	str = ss_stralloc(len, ss);
 #endif /* DEBUG */
 	memcpy(str, source_string, len);
+
+	return str;
+}
+
+const char * string_set_add(const char * source_string, String_set * ss)
+{
+	assert(source_string != NULL, "STRING_SET: Can't insert a null string");
+
+	unsigned int h = hash_string(source_string, ss);
+	unsigned int p = find_place(source_string, h, ss);
+
+	if (ss->table[p].str != NULL) return ss->table[p].str;
+
+	const char *str = NULL;
+	if (NULL != ss->base)
+	{
+		/* A string of the base set is entered into the overlay by
+		 * reference, so next time it is found in the (smaller) overlay
+		 * table. */
+		const String_set *base = ss->base;
+		unsigned int bp = find_place(source_string, h, base);
+		str = base->table[bp].str;
+	}
+
+	if (NULL == str)
+	{
+		assert(!ss->frozen, "STRING_SET: Can't add \"%s\" to a frozen set",
+		       source_string);
+		str = ss_strcopy(source_string, ss);
+	}
+
 	ss->table[p].str = str;
 	ss->table[p].hash = h;
 	ss->count++;
@@ -219,6 +277,12 @@ const char * string_set_lookup(const char * source_string, String_set * ss)
 	unsigned int h = hash_string(source_string, ss);
 	unsigned int p = find_place(source_string, h, ss);
 
+	if ((ss->table[p].str == NULL) && (NULL != ss->base))
+	{
+		p = find_place(source_string, h, ss->base);
+		return ss->base->table[p].str;
+	}
+
 	return ss->table[p].str;
 }
 
@@ -233,7 +297,11 @@ void string_set_delete(String_set *ss)
 
 	for (i=0; i<ss->size; i++)
 	{
-		if (ss->table[i].str != NULL) free((void *)ss->table[i].str);
+		const char *str = ss->table[i].str;
+		if (str == NULL) continue;
+		if ((ss->base != NULL) &&
+		    (str == string_set_lookup(str, (String_set *)ss->base))) continue;
+		free((void *)str);
 	}
 #endif /* STR_POOL */
 
@@ -42,6 +42,8 @@ struct String_set_s
 	ssize_t pool_free_count;    /* string pool free space */
 	char *alloc_next;           /* next string address */
 	str_mem_pool *string_pool;  /* string memory pool */
+	const String_set *base;     /* frozen set searched first, or NULL */
+	bool frozen;                /* no more strings can be added */
 };
 
 /* If the table gets too big, we grow it. Too big is defined as being
@@ -49,6 +51,8 @@ struct String_set_s
 #define MAX_STRING_SET_TABLE_SIZE(s) ((s) * 3 / 4)
 
 String_set * string_set_create(void);
+String_set * string_set_create_overlay(const String_set *base);
+void         string_set_freeze(String_set *ss);
 const char * string_set_add(const char * source_string, String_set * ss);
 const char * string_set_lookup(const char * source_string, String_set * ss);
 void         string_set_delete(String_set *ss);
@@ -56,6 +60,7 @@ void         string_set_delete(String_set *ss);
 /**
  * Compare 2 strings, assuming they are in the same string-set.
  * Two string-set strings are equal if and only if their pointers are equal.
+ * An overlay and its base set count as the same string-set.
  * Return true if they are equal, else false.
  * In debug mode, also "validate" that the strings are indeed from the
  * same string-set, and that their comparison is as expected.
@@ -0,0 +1,374 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <string.h>
+
+#include "api-structures.h"
+#include "dict-common/dict-affix.h"
+#include "dict-common/dict-common.h"
+#include "utilities.h"
+
+/**
+ * Streaming sentence segmentation of documents.
+ *
+ * The text of a document is fed in arbitrary chunks by
+ * document_feed(), and complete sentences are taken out by
+ * document_next_sentence(), along with their byte offset in the
+ * document. Only the text of the current (unfinished) sentence is
+ * kept, so the memory usage doesn't depend on the document size.
+ *
+ * A sentence ends:
+ * - At a sentence-final punctuation mark (one of the RPUNC tokens of
+ *   the dictionary that are listed in sentence_end[] below), possibly
+ *   repeated and followed by closing quotes or brackets, when the next
+ *   character is white-space and the next word doesn't start with a
+ *   lower-case letter. A period after an abbreviation (a dictionary
+ *   word that ends with a period, like "Mr."), an initial or an
+ *   acronym (like "e.g.") doesn't end a sentence. The full-width marks
+ *   of Asian scripts end a sentence even if no white-space follows.
+ * - At an empty line.
+ * - At the end of the document.
+ * - After DOCUMENT_MAX_SENTENCE bytes (at white-space if possible).
+ */
+
+#define D_DOC 6                       /* Debug level for this file. */
+#define DOCUMENT_MAX_SENTENCE 16384   /* Bytes */
+#define DOCUMENT_MAX_ABBREV 64        /* Bytes, including the period */
+
+/* Candidate sentence-final marks. Only those that are also RPUNC tokens
+ * of the dictionary are used. Full-width marks come first. */
+static const char *sentence_end[] =
+{
+	"。", "？", "！", "?", "!", ".", "‽", "؟", "।", "॥",
+};
+#define NUM_FULLWIDTH_END 3
+
+/* Closing quotes and brackets, in addition to the QUOTES class. */
+static const char *sentence_closer[] =
+{
+	")", "]", "}", "\"", "'", "’", "”", "»", "）", "」", "』", "》", "】",
+};
+
+#define MAX_SENTENCE_END (sizeof(sentence_end)/sizeof(sentence_end[0]))
+
+struct Document_s
+{
+	Dictionary dict;
+	const char *end_mark[MAX_SENTENCE_END];
+	bool fullwidth[MAX_SENTENCE_END];
+	unsigned int num_end_marks;
+	const char *quotes;      /* The QUOTES class characters, or NULL */
+
+	char *buf;               /* Unconsumed text, NUL-terminated */
+	size_t size;             /* Allocated size of buf */
+	size_t len;              /* Text length in buf */
+	size_t start;            /* Start of the current sentence in buf */
+	size_t pos;              /* Scanning position in buf */
+	size_t offset;           /* Document offset of buf[0] */
+	bool at_end;             /* No more text will be fed */
+
+	char *sentence;          /* Last returned sentence */
+	size_t sentence_size;
+};
+
+static bool in_rpunc(Dictionary afdict, const char *s)
+{
+	if (NULL == afdict) return false;
+
+	Afdict_class *rpunc = AFCLASS(afdict, AFDICT_RPUNC);
+	for (size_t i = 0; i < rpunc->length; i++)
+		if (0 == strcmp(rpunc->string[i], s)) return true;
+
+	return false;
+}
+
+/**
+ * Create a document for sentence segmentation according to the
+ * affix classes of the given dictionary.
+ */
+Document document_create(Dictionary dict)
+{
+	Document doc = calloc(1, sizeof(*doc));
+	doc->dict = dict;
+
+	Dictionary afdict = dict->affix_table;
+	for (size_t i = 0; i < MAX_SENTENCE_END; i++)
+	{
+		/* Without an affix file, use the ASCII marks. */
+		bool ascii = (0 == (sentence_end[i][0] & 0x80));
+		if ((NULL == afdict) ? !ascii : !in_rpunc(afdict, sentence_end[i]))
+			continue;
+
+		doc->fullwidth[doc->num_end_marks] = (i < NUM_FULLWIDTH_END);
+		doc->end_mark[doc->num_end_marks++] = sentence_end[i];
+	}
+
+	if ((NULL != afdict) && (0 < AFCLASS(afdict, AFDICT_QUOTES)->length))
+		doc->quotes = AFCLASS(afdict, AFDICT_QUOTES)->string[0];
+
+	doc->size = 4096;
+	doc->buf = malloc(doc->size);
+	doc->buf[0] = '\0';
+
+	return doc;
+}
+
+void document_delete(Document doc)
+{
+	if (NULL == doc) return;
+	free(doc->buf);
+	free(doc->sentence);
+	free(doc);
+}
+
+/**
+ * Append text to the document.
+ * NUL characters in the text are taken as blanks.
+ */
+void document_feed(Document doc, const char *text, size_t len)
+{
+	if (doc->at_end)
+	{
+		prt_error("Error: document_feed(): The document has been ended.\n");
+		return;
+	}
+
+	/* Discard the consumed text. */
+	if (0 < doc->start)
+	{
+		doc->len -= doc->start;
+		memmove(doc->buf, doc->buf + doc->start, doc->len + 1);
+		doc->pos -= doc->start;
+		doc->offset += doc->start;
+		doc->start = 0;
+	}
+
+	if (doc->len + len + 1 > doc->size)
+	{
+		while (doc->len + len + 1 > doc->size) doc->size *= 2;
+		doc->buf = realloc(doc->buf, doc->size);
+	}
+
+	char *p = doc->buf + doc->len;
+	memcpy(p, text, len);
+	for (char *e = p + len; NULL != (p = memchr(p, '\0', e - p)); p++)
+		*p = ' ';
+	doc->len += len;
+	doc->buf[doc->len] = '\0';
+}
+
+/**
+ * Declare that no more text will be fed. The rest of the text can then
+ * be taken out by document_next_sentence().
+ */
+void document_end(Document doc)
+{
+	doc->at_end = true;
+}
+
+static bool is_blank(Document doc, char c)
+{
+	return (0 == (c & 0x80)) && doc->dict->ascii_space[(unsigned char)c];
+}
+
+static size_t match_end_mark(Document doc, const char *s, bool *fullwidth)
+{
+	for (unsigned int i = 0; i < doc->num_end_marks; i++)
+	{
+		const char *m = doc->end_mark[i];
+		if (s[0] != m[0]) continue;
+
+		size_t len = strlen(m);
+		if (0 == strncmp(s, m, len))
+		{
+			*fullwidth = doc->fullwidth[i];
+			return len;
+		}
+	}
+	return 0;
+}
+
+static size_t match_closer(Document doc, const char *s)
+{
+	for (size_t i = 0; i < sizeof(sentence_closer)/sizeof(sentence_closer[0]); i++)
+	{
+		size_t len = strlen(sentence_closer[i]);
+		if (0 == strncmp(s, sentence_closer[i], len)) return len;
+	}
+
+	if (NULL == doc->quotes) return 0;
+	int len = utf8_charlen(s);
+	if ((len <= 0) || (strnlen(s, len) < (size_t)len)) return 0;
+	if (NULL == strstr(doc->quotes, strndupa(s, len))) return 0;
+	return len;
+}
+
+/**
+ * Return true if the character at buf index \p i is not complete yet
+ * (more text is needed in order to classify it).
+ */
+static bool is_incomplete(Document doc, size_t i)
+{
+	if (doc->at_end) return false;
+	if (i == doc->len) return true;
+
+	int len = utf8_charlen(doc->buf + i);
+	return (0 < len) && (strnlen(doc->buf + i, len) < (size_t)len);
+}
+
+/**
+ * Return true if the period at \p dot ends an abbreviation, an initial
+ * or an acronym, and hence doesn't end the sentence.
+ */
+static bool is_abbreviation(Document doc, size_t dot)
+{
+	const char *b = doc->buf;
+	size_t w = dot;
+
+	while ((w > doc->start) && !is_blank(doc, b[w-1])) w--;
+	while ((w < dot) && (NULL != strchr("([{\"'", b[w]))) w++;
+	if (w == dot) return false;
+
+	/* An initial. */
+	if ((w + 1 == dot) &&
+	    ((('a' <= b[w]) && (b[w] <= 'z')) || (('A' <= b[w]) && (b[w] <= 'Z'))))
+		return true;
+
+	/* An acronym, like "e.g." or "U.S.". */
+	if (NULL != memchr(b + w, '.', dot - w)) return true;
+
+	if (dot + 1 - w >= DOCUMENT_MAX_ABBREV) return false;
+	char word[DOCUMENT_MAX_ABBREV];
+	memcpy(word, b + w, dot + 1 - w);
+	word[dot + 1 - w] = '\0';
+
+	return dict_has_word(doc->dict, word);
+}
+
+/**
+ * Find the end of the current sentence.
+ * Return true if found, setting \p end to its buf index. Return false
+ * if more text is needed in order to find it.
+ */
+static bool find_sentence_end(Document doc, size_t *end)
+{
+	const char *b = doc->buf;
+	size_t len = doc->len;
+	size_t i;
+
+	for (i = doc->pos; i < len; i++)
+	{
+		if (i - doc->start >= DOCUMENT_MAX_SENTENCE)
+		{
+			/* Break at the last blank, or else between characters, or
+			 * else (in invalid UTF-8) just here. The sentence must not be
+			 * empty, else no progress would be made. */
+			size_t e = i;
+			while ((e > doc->start) && !is_blank(doc, b[e])) e--;
+			if (e == doc->start)
+				for (e = i; (e > doc->start) && ((b[e] & 0xc0) == 0x80); e--)
+					;
+			if (e == doc->start) e = i;
+			lgdebug(+D_DOC, "Too long sentence at offset %zu\n",
+			        doc->offset + doc->start);
+			*end = e;
+			return true;
+		}
+
+		if ('\n' == b[i])
+		{
+			/* An empty line. */
+			size_t j = i + 1;
+			while ((j < len) && ('\n' != b[j]) && is_blank(doc, b[j])) j++;
+			if ((j == len) && !doc->at_end) break;
+			if ((j < len) && ('\n' == b[j]))
+			{
+				*end = j + 1;
+				return true;
+			}
+			continue;
+		}
+
+		bool fullwidth = false;
+		size_t j = i;
+		size_t n;
+		while (0 < (n = match_end_mark(doc, b + j, &fullwidth))) j += n;
+		if (j == i) continue;
+		size_t marks_end = j;
+		while (0 < (n = match_closer(doc, b + j))) j += n;
+
+		if (is_incomplete(doc, j)) break;
+		if (!fullwidth)
+		{
+			if ((j < len) && !is_blank(doc, b[j])) goto next;
+			if ((marks_end == i + 1) && ('.' == b[i]) && is_abbreviation(doc, i))
+				goto next;
+
+			/* The next sentence doesn't start with a lower-case letter. */
+			size_t k = j;
+			while ((k < len) && is_blank(doc, b[k])) k++;
+			if ((k == len) && !doc->at_end) break;
+			if ((k < len) && ('a' <= b[k]) && (b[k] <= 'z')) goto next;
+		}
+
+		*end = j;
+		return true;
+
+next:
+		i = j - 1;
+	}
+
+	/* Continue later from here; but a multi-byte mark may be cut at
+	 * the end of the text, so back up a bit. */
+	if (i >= len) i = (len - doc->start > 3) ? len - 3 : doc->start;
+	doc->pos = i;
+	return false;
+}
+
+/**
+ * Return the next sentence, or NULL if there is none yet (more text
+ * needs to be fed) or at the end of the document. Leading and trailing
+ * blanks are removed. The returned string is valid until the next call.
+ * \p offset and \p length (if not NULL) are set to the byte offset of
+ * the sentence in the document and its length.
+ */
+const char *document_next_sentence(Document doc, size_t *offset, size_t *length)
+{
+	for (;;)
+	{
+		size_t end;
+		if (!find_sentence_end(doc, &end))
+		{
+			if (!doc->at_end || (doc->start == doc->len)) return NULL;
+			end = doc->len;
+		}
+
+		size_t s = doc->start;
+		size_t e = end;
+		doc->start = doc->pos = end;
+
+		while ((s < e) && is_blank(doc, doc->buf[s])) s++;
+		while ((e > s) && is_blank(doc, doc->buf[e-1])) e--;
+		if (s == e) continue;
+
+		if (e - s + 1 > doc->sentence_size)
+		{
+			doc->sentence_size = e - s + 1;
+			doc->sentence = realloc(doc->sentence, doc->sentence_size);
+		}
+		memcpy(doc->sentence, doc->buf + s, e - s);
+		doc->sentence[e - s] = '\0';
+
+		if (NULL != offset) *offset = doc->offset + s;
+		if (NULL != length) *length = e - s;
+		return doc->sentence;
+	}
+}
@@ -58,7 +58,9 @@ static Dict_node *dictionary_all_categories(Dictionary dict)
  * use it instead of the dictionary word, and as its subscript, use the
  * subscript of the dictionary word. Note that this means that the
  * X_node strings (which are later assigned to the disjuncts that are
- * derived from them) may be from two different string sets.
+ * derived from them) may be from two different string sets. Unless the
+ * dictionary is dynamic, its string set is the base of the sentence
+ * one, so they still compare by pointer.
  */
 static X_node * build_word_expressions(Sentence sent, const Gword *w,
                                        const char *s, Parse_Options opts)
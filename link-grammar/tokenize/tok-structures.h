@@ -49,6 +49,7 @@ struct gword_set
 };
 
 gword_set *gword_set_union(gword_set *, gword_set *);
+gword_set *gword_set_new(Gword *const *, size_t);
 
 typedef enum
 {
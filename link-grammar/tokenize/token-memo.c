@@ -0,0 +1,488 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include <stdint.h>
+
+#include "api-structures.h"
+#include "connectors.h"                 // string_hash
+#include "dict-common/dict-common.h"
+#include "error.h"
+#include "lru-table.h"
+#include "tok-structures.h"
+#include "token-memo.h"
+#include "tokenize.h"
+#include "utilities.h"
+
+/**
+ * A per-dictionary memo of the tokenization of single tokens.
+ *
+ * separate_word() tries, for each token, left/right stripping, unit
+ * and affix splitting, regex guesses and spell guesses. For a given
+ * token string and tokenizer state of the token (and its capitalizable
+ * position) the result doesn't depend on the rest of the sentence, and
+ * since the distribution of tokens in natural text is Zipfian, most of
+ * this work is repeated over and over.
+ *
+ * The first time a token is tokenized in a given state, its
+ * tokenization gets recorded: each issue_word_alternative() call on
+ * the token or on one of the words that have been created for it, and
+ * the final tokenizer state of these words (which separate_word() and
+ * its helpers also modify directly). The next time, the recorded calls
+ * are replayed instead of calling separate_word(), yielding the same
+ * wordgraph.
+ *
+ * The memo is bounded, and the least recently used entries get evicted.
+ * Lookups copy the entry data out under the memo lock, so the entries
+ * can be evicted while a copy is being replayed.
+ */
+
+#define D_TM 6 /* Debug level for this file (as for separate_word()). */
+
+#define TOKEN_MEMO_MAX_ENTRIES 8192
+
+/* An issue_word_alternative() call. */
+typedef struct
+{
+	uint32_t target;             /* 0: The token; else 1 + created word index */
+	uint32_t label;              /* Offset in the string area */
+	uint32_t token;              /* Index of the first token offset */
+	uint16_t num[3];             /* prefnum, stemnum, suffnum */
+} memo_op;
+
+/* Tokenizer state of a word after the tokenization of the token. */
+typedef struct
+{
+	unsigned int status;
+	Morpheme_type morpheme_type;
+	Tokenizing_step tokenizing_step;
+	const char *regex_name;      /* A dictionary string */
+} memo_word;
+
+/* The entry data. The arrays follow this header in the same block. */
+typedef struct
+{
+	size_t size;                 /* Total block size */
+	uint32_t key;                /* Offset in the string area */
+	uint32_t num_ops;
+	uint32_t num_words;          /* Number of created words */
+	uint32_t num_tokens;
+	memo_word token_state;       /* The token itself */
+	/* memo_word word[num_words];
+	 * memo_op op[num_ops];
+	 * uint32_t token[num_tokens];  (offsets in the string area)
+	 * char string_area[]; */
+} memo_data;
+
+#define MEMO_WORDS(md) ((memo_word *)((md) + 1))
+#define MEMO_OPS(md) ((memo_op *)(MEMO_WORDS(md) + (md)->num_words))
+#define MEMO_TOKENS(md) ((uint32_t *)(MEMO_OPS(md) + (md)->num_ops))
+#define MEMO_STRINGS(md) ((char *)(MEMO_TOKENS(md) + (md)->num_tokens))
+
+typedef struct Token_memo_entry_s Token_memo_entry;
+struct Token_memo_entry_s
+{
+	Lru_node node;               /* Must be first; the key is in data */
+	memo_data *data;
+};
+
+struct Token_memo_s
+{
+	Lru_table lru;
+	size_t hits;
+	size_t misses;
+};
+
+/* A tokenization being recorded. */
+struct Token_memo_rec_s
+{
+	Gword *token;
+	size_t first_node_num;       /* node_num of the first created word */
+	Gword *last_word;            /* The last word before the recording */
+	bool failed;                 /* Cannot be replayed */
+
+	memo_op *op;
+	size_t num_ops, ops_alloced;
+	uint32_t *token_offset;
+	size_t num_tokens, tokens_alloced;
+	char *string_area;
+	size_t strings_size, strings_alloced;
+};
+
+static void tm_lock(Token_memo *tm)
+{
+	lru_table_lock(&tm->lru);
+}
+
+static void tm_unlock(Token_memo *tm)
+{
+	lru_table_unlock(&tm->lru);
+}
+
+/* ======================================================================== */
+/* Memo maintenance. Called with the memo lock held. */
+
+static Token_memo_entry *find_entry(Token_memo *tm, const char *key,
+                                    uint32_t hash)
+{
+	return (Token_memo_entry *)lru_table_find(&tm->lru, key, hash);
+}
+
+static void evict(Token_memo *tm, Token_memo_entry *e)
+{
+	lru_table_remove(&tm->lru, &e->node);
+	free(e->data);
+	free(e);
+}
+
+/* ======================================================================== */
+/* Recording. */
+
+static uint32_t rec_add_string(Token_memo_rec *rec, const char *s)
+{
+	size_t len = strlen(s) + 1;
+	uint32_t offset = (uint32_t)rec->strings_size;
+
+	if (rec->strings_size + len > rec->strings_alloced)
+	{
+		rec->strings_alloced = MAX(2 * rec->strings_alloced,
+		                           rec->strings_size + len + 64);
+		rec->string_area = realloc(rec->string_area, rec->strings_alloced);
+	}
+	memcpy(rec->string_area + rec->strings_size, s, len);
+	rec->strings_size += len;
+
+	return offset;
+}
+
+static void rec_add_tokens(Token_memo_rec *rec, int num,
+                           const char * const *token)
+{
+	for (int i = 0; i < num; i++)
+	{
+		if (rec->num_tokens == rec->tokens_alloced)
+		{
+			rec->tokens_alloced = MAX(2 * rec->tokens_alloced, 8);
+			rec->token_offset = realloc(rec->token_offset,
+			          rec->tokens_alloced * sizeof(*rec->token_offset));
+		}
+		rec->token_offset[rec->num_tokens++] = rec_add_string(rec, token[i]);
+	}
+}
+
+static void rec_delete(Token_memo_rec *rec)
+{
+	free(rec->op);
+	free(rec->token_offset);
+	free(rec->string_area);
+	free(rec);
+}
+
+static void set_memo_word(memo_word *mw, const Gword *w)
+{
+	mw->status = w->status;
+	mw->morpheme_type = w->morpheme_type;
+	mw->tokenizing_step = w->tokenizing_step;
+	mw->regex_name = w->regex_name;
+}
+
+static void apply_memo_word(Gword *w, const memo_word *mw)
+{
+	w->status = mw->status;
+	w->morpheme_type = mw->morpheme_type;
+	w->tokenizing_step = mw->tokenizing_step;
+	w->regex_name = mw->regex_name;
+}
+
+/**
+ * Start recording the tokenization of \p token.
+ */
+void token_memo_record_begin(Sentence sent, Gword *token)
+{
+	Token_memo_rec *rec = malloc(sizeof(*rec));
+	memset(rec, 0, sizeof(*rec));
+
+	rec->token = token;
+	rec->first_node_num = sent->gword_node_num;
+	rec->last_word = sent->last_word;
+
+	sent->token_memo_rec = rec;
+}
+
+/**
+ * Record an issue_word_alternative() call. Its target must be the
+ * token being recorded or one of the words created for it.
+ */
+void token_memo_record_issue(Sentence sent, const Gword *unsplit_word,
+                             const char *label,
+                             int prefnum, const char * const *prefix,
+                             int stemnum, const char * const *stem,
+                             int suffnum, const char * const *suffix)
+{
+	Token_memo_rec *rec = sent->token_memo_rec;
+	if (rec->failed) return;
+
+	uint32_t target;
+	if (unsplit_word == rec->token)
+		target = 0;
+	else if (unsplit_word->node_num >= rec->first_node_num)
+		target = (uint32_t)(1 + unsplit_word->node_num - rec->first_node_num);
+	else
+	{
+		rec->failed = true;
+		return;
+	}
+
+	if (rec->num_ops == rec->ops_alloced)
+	{
+		rec->ops_alloced = MAX(2 * rec->ops_alloced, 4);
+		rec->op = realloc(rec->op, rec->ops_alloced * sizeof(*rec->op));
+	}
+
+	memo_op *op = &rec->op[rec->num_ops++];
+	op->target = target;
+	op->label = rec_add_string(rec, label);
+	op->token = (uint32_t)rec->num_tokens;
+	op->num[0] = (uint16_t)prefnum;
+	op->num[1] = (uint16_t)stemnum;
+	op->num[2] = (uint16_t)suffnum;
+
+	rec_add_tokens(rec, prefnum, prefix);
+	rec_add_tokens(rec, stemnum, stem);
+	rec_add_tokens(rec, suffnum, suffix);
+}
+
+/**
+ * Finish the recording, and memoize it under \p key.
+ */
+void token_memo_record_end(Sentence sent, const char *key)
+{
+	Token_memo_rec *rec = sent->token_memo_rec;
+	Token_memo *tm = sent->dict->token_memo;
+
+	sent->token_memo_rec = NULL;
+	if (rec->failed)
+	{
+		rec_delete(rec);
+		return;
+	}
+
+	size_t num_words = sent->gword_node_num - rec->first_node_num;
+	uint32_t key_offset = rec_add_string(rec, key);
+	size_t size = sizeof(memo_data) +
+		rec->num_ops * sizeof(memo_op) + num_words * sizeof(memo_word) +
+		rec->num_tokens * sizeof(uint32_t) + rec->strings_size;
+
+	memo_data *md = malloc(size);
+	md->size = size;
+	md->key = key_offset;
+	md->num_ops = (uint32_t)rec->num_ops;
+	md->num_words = (uint32_t)num_words;
+	md->num_tokens = (uint32_t)rec->num_tokens;
+	set_memo_word(&md->token_state, rec->token);
+
+	memo_word *mw = MEMO_WORDS(md);
+	for (Gword *w = rec->last_word->chain_next; NULL != w; w = w->chain_next)
+		set_memo_word(mw++, w);
+	assert(mw == MEMO_WORDS(md) + num_words, "Created words mismatch");
+	memcpy(MEMO_OPS(md), rec->op, rec->num_ops * sizeof(memo_op));
+	memcpy(MEMO_TOKENS(md), rec->token_offset,
+	       rec->num_tokens * sizeof(uint32_t));
+	memcpy(MEMO_STRINGS(md), rec->string_area, rec->strings_size);
+	rec_delete(rec);
+
+	Token_memo_entry *e = malloc(sizeof(*e));
+	e->node.key = MEMO_STRINGS(md) + md->key;
+	e->node.hash = string_hash(key);
+	e->data = md;
+
+	tm_lock(tm);
+	if (NULL != find_entry(tm, key, e->node.hash))
+	{
+		/* Another thread has just memoized this token. */
+		tm_unlock(tm);
+		free(md);
+		free(e);
+		return;
+	}
+
+	lru_table_insert(&tm->lru, &e->node);
+	if (tm->lru.num_entries > TOKEN_MEMO_MAX_ENTRIES)
+		evict(tm, (Token_memo_entry *)tm->lru.lru_last);
+	tm_unlock(tm);
+}
+
+/* ======================================================================== */
+/* Replaying. */
+
+/**
+ * Return the memo key of \p token, or NULL if its tokenization
+ * should not be memoized. \p capitalizable tells whether the token
+ * is an uppercase word in a capitalizable position.
+ */
+char *token_memo_key(Sentence sent, const Gword *token, Parse_Options opts,
+                     bool capitalizable)
+{
+	Dictionary dict = sent->dict;
+
+	if (NULL == dict->token_memo) return NULL;
+	if (verbosity >= D_TM) return NULL; /* Let it show its steps. */
+	if (test_enabled("no-token-memo")) return NULL;
+
+	/* Words may be added to a dynamic dictionary on each lookup, and
+	 * then the same token may get a different tokenization. */
+	if (IS_DYNAMIC_DICT(dict)) return NULL;
+
+	/* Random morphology is different each time. */
+	if ((NULL != dict->affix_table) && (NULL != dict->affix_table->anysplit))
+		return NULL;
+
+	/* Tokens are not expected to have a regex match before
+	 * their tokenization. Don't memoize them if they do. */
+	if (NULL != token->regex_name) return NULL;
+
+	dyn_str *key = dyn_str_new();
+	char buf[128];
+	snprintf(buf, sizeof(buf), "%d,%x,%d,%zu,%d,%d,%d,%d\x1f",
+	         (int)token->morpheme_type, token->status,
+	         (int)token->tokenizing_step, token->split_counter,
+	         token->issued_unsplit, capitalizable, opts->use_spell_guess,
+	         test_enabled("dictcap") != NULL);
+	dyn_strcat(key, buf);
+	dyn_strcat(key, token->subword);
+
+	return dyn_str_take(key);
+}
+
+/**
+ * Replay the memoized tokenization of \p token, if there is one.
+ * Return true if it has been replayed.
+ */
+bool token_memo_replay(Sentence sent, Gword *token, const char *key)
+{
+	Token_memo *tm = sent->dict->token_memo;
+	uint32_t hash = string_hash(key);
+	memo_data *md = NULL;
+
+	tm_lock(tm);
+	Token_memo_entry *e = find_entry(tm, key, hash);
+	if (NULL == e)
+	{
+		tm->misses++;
+	}
+	else
+	{
+		tm->hits++;
+		md = malloc(e->data->size);
+		memcpy(md, e->data, e->data->size);
+		lru_table_touch(&tm->lru, &e->node);
+	}
+	tm_unlock(tm);
+
+	if (NULL == md) return false;
+	lgdebug(+D_TM, "Replay '%s' (%u ops)\n", token->subword, md->num_ops);
+
+	const char *strings = MEMO_STRINGS(md);
+	const uint32_t *token_offset = MEMO_TOKENS(md);
+	Gword **created = alloca((md->num_words + 1) * sizeof(*created));
+	size_t num_created = 0;
+	Gword *last = sent->last_word;
+
+	for (uint32_t i = 0; i < md->num_ops; i++)
+	{
+		const memo_op *op = &MEMO_OPS(md)[i];
+		int num = op->num[0] + op->num[1] + op->num[2];
+		const char **tokens = alloca((num + 1) * sizeof(*tokens));
+
+		for (int t = 0; t < num; t++)
+			tokens[t] = strings + token_offset[op->token + t];
+
+		assert(op->target <= num_created, "Bad memo target");
+		Gword *target = (0 == op->target) ? token : created[op->target - 1];
+
+		issue_word_alternative(sent, target, strings + op->label,
+		                       op->num[0], tokens,
+		                       op->num[1], tokens + op->num[0],
+		                       op->num[2], tokens + op->num[0] + op->num[1]);
+
+		for (Gword *w = last->chain_next; NULL != w; w = w->chain_next)
+		{
+			assert(num_created < md->num_words, "Created words mismatch");
+			created[num_created++] = w;
+			last = w;
+		}
+	}
+	assert(num_created == md->num_words, "Created words mismatch");
+
+	apply_memo_word(token, &md->token_state);
+	for (size_t i = 0; i < num_created; i++)
+		apply_memo_word(created[i], &MEMO_WORDS(md)[i]);
+
+	free(md);
+	return true;
+}
+
+/* ======================================================================== */
+
+void token_memo_create(Dictionary dict)
+{
+	Token_memo *tm = malloc(sizeof(*tm));
+	memset(tm, 0, sizeof(*tm));
+	lru_table_init(&tm->lru, TOKEN_MEMO_MAX_ENTRIES);
+
+	dict->token_memo = tm;
+}
+
+size_t dictionary_get_token_memo_hits(Dictionary dict)
+{
+	if ((NULL == dict) || (NULL == dict->token_memo)) return 0;
+
+	tm_lock(dict->token_memo);
+	size_t hits = dict->token_memo->hits;
+	tm_unlock(dict->token_memo);
+	return hits;
+}
+
+size_t dictionary_get_token_memo_misses(Dictionary dict)
+{
+	if ((NULL == dict) || (NULL == dict->token_memo)) return 0;
+
+	tm_lock(dict->token_memo);
+	size_t misses = dict->token_memo->misses;
+	tm_unlock(dict->token_memo);
+	return misses;
+}
+
+void token_memo_clear(Dictionary dict)
+{
+	Token_memo *tm = dict->token_memo;
+	if (NULL == tm) return;
+
+	tm_lock(tm);
+	while (NULL != tm->lru.lru_last)
+		evict(tm, (Token_memo_entry *)tm->lru.lru_last);
+	tm_unlock(tm);
+}
+
+void token_memo_delete(Dictionary dict)
+{
+	Token_memo *tm = dict->token_memo;
+	if (NULL == tm) return;
+
+	if (verbosity >= D_USER_INFO)
+	{
+		prt_error("Info: Token memo %s: %zu hits, %zu misses\n",
+		          dict->name, tm->hits, tm->misses);
+	}
+	token_memo_clear(dict);
+	lru_table_destroy(&tm->lru);
+	free(tm);
+	dict->token_memo = NULL;
+}
@@ -0,0 +1,30 @@
+/*************************************************************************/
+/* Copyright (c) 2026                                                    */
+/* All rights reserved                                                   */
+/*                                                                       */
+/* Use of the link grammar parsing system is subject to the terms of the */
+/* license set forth in the LICENSE file included with this software.    */
+/* This license allows free redistribution and use in source and binary  */
+/* forms, with or without modification, subject to certain conditions.   */
+/*                                                                       */
+/*************************************************************************/
+
+#ifndef _TOKEN_MEMO_H
+#define _TOKEN_MEMO_H
+
+#include "api-structures.h"
+
+void token_memo_create(Dictionary);
+void token_memo_clear(Dictionary);
+void token_memo_delete(Dictionary);
+
+char *token_memo_key(Sentence, const Gword *, Parse_Options, bool);
+bool token_memo_replay(Sentence, Gword *, const char *);
+void token_memo_record_begin(Sentence, Gword *);
+void token_memo_record_issue(Sentence, const Gword *, const char *,
+                             int, const char * const *,
+                             int, const char * const *,
+                             int, const char * const *);
+void token_memo_record_end(Sentence, const char *);
+
+#endif /* _TOKEN_MEMO_H */
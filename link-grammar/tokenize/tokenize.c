@@ -27,8 +27,10 @@
 #include "dict-common/regex-morph.h"
 #include "error.h"
 #include "print/print-util.h"
+#include "resources.h"
 #include "spellcheck.h"
 #include "string-set.h"
+#include "token-memo.h"
 #include "tokenize.h"
 #include "tok-structures.h"
 #include "utilities.h"
@@ -106,12 +108,17 @@ static bool contains_digits(const char * s, locale_t dict_locale)
 	wchar_t c;
 
 	memset(&mbs, 0, sizeof(mbs));
-	while ((*s != 0) && (0 < nb))
+	for (; *s != 0; s += nb)
 	{
+		if (0 == (*s & 0x80))
+		{
+			if (('0' <= *s) && (*s <= '9')) return true;
+			nb = 1;
+			continue;
+		}
 		nb = mbrtowc(&c, s, MB_CUR_MAX, &mbs);
 		if (nb < 0) return false;
 		if (iswdigit_l(c, dict_locale)) return true;
-		s += nb;
 	}
 	return false;
 }
@@ -133,6 +140,7 @@ static char *utf8_str1chr(const char *s, const char *xc)
 {
 	int len = utf8_charlen(xc);
 	if (len < 0) return NULL; /* Invalid UTF-8 */
+	if (1 == len) return strchr(s, *xc);
 	char *xc1 = strndupa(xc, len);
 
 	return strstr(s, xc1);
@@ -171,6 +179,32 @@ static bool is_space(wchar_t wc, locale_t dict_locale)
 	return false;
 }
 
+/**
+ * Decode the character at \p s for the sentence scanner.
+ * Return its length in bytes, 0 at the end of the string, or a negative
+ * value on invalid UTF-8 (in which case \p space is left unchanged).
+ * Set \p space to whether the character is white-space.
+ *
+ * ASCII characters, which make up most of the input, are classified by
+ * a table lookup; only the others are decoded by mbrtowc().
+ */
+static inline int scan_char(Dictionary dict, const char *s, mbstate_t *mbs,
+                            bool *space)
+{
+	unsigned char b = (unsigned char)*s;
+
+	if (b < 0x80)
+	{
+		*space = dict->ascii_space[b];
+		return (0 != b);
+	}
+
+	wchar_t c;
+	int nb = mbrtowc(&c, s, MB_CUR_MAX, mbs);
+	if (0 < nb) *space = is_space(c, dict->lctype);
+	return nb;
+}
+
 static void gwordqueue_add(const Sentence sent, Gword *const word)
 {
 	word_queue_t *wq_element = malloc(sizeof(word_queue_t));
@@ -541,6 +575,12 @@ Gword *issue_word_alternative(Sentence sent, Gword *unsplit_word,
 	Gword *sole_alternative_of_itself = NULL;
 #endif
 
+	if (NULL != sent->token_memo_rec)
+	{
+		token_memo_record_issue(sent, unsplit_word, label, prefnum, prefix,
+		                        stemnum, stem, suffnum, suffix);
+	}
+
 	if (unsplit_word->split_counter > MAX_SPLITS)
 	{
 		prt_error("Error: Word %s reached %d splits. "
@@ -2888,6 +2928,34 @@ static void separate_word(Sentence sent, Gword *unsplit_word, Parse_Options opts
 #endif
 }
 
+/**
+ * Tokenize the given word like separate_word(), but replay its memoized
+ * tokenization if the same token has already been tokenized in the same
+ * state (see token-memo.c).
+ */
+static void separate_word_memo(Sentence sent, Gword *unsplit_word,
+                               Parse_Options opts)
+{
+	const Dictionary dict = sent->dict;
+	bool capitalizable = is_utf8_upper(unsplit_word->subword, dict->lctype) &&
+		is_capitalizable(dict, unsplit_word);
+	char *key = token_memo_key(sent, unsplit_word, opts, capitalizable);
+
+	if (NULL == key)
+	{
+		separate_word(sent, unsplit_word, opts);
+		return;
+	}
+
+	if (!token_memo_replay(sent, unsplit_word, key))
+	{
+		token_memo_record_begin(sent, unsplit_word);
+		separate_word(sent, unsplit_word, opts);
+		token_memo_record_end(sent, key);
+	}
+	free(key);
+}
+
 /**
  * Make the string 's' be the next word of the sentence.
  *
@@ -3031,14 +3099,14 @@ bool separate_sentence(Sentence sent, Parse_Options opts)
 
 	for(;;)
 	{
-		wchar_t c;
-		int nb = mbrtowc(&c, word_start, MB_CUR_MAX, &mbs);
+		bool space = false;
+		int nb = scan_char(dict, word_start, &mbs, &space);
 		if (0 > nb) BAD_UTF;
 
-		while (is_space(c, dict->lctype))
+		while (space)
 		{
 			word_start += nb;
-			nb = mbrtowc(&c, word_start, MB_CUR_MAX, &mbs);
+			nb = scan_char(dict, word_start, &mbs, &space);
 			if (0 == nb) break;
 			if (0 > nb) BAD_UTF;
 		}
@@ -3047,12 +3115,12 @@ bool separate_sentence(Sentence sent, Parse_Options opts)
 
 		/* Loop over non-blank characters until word-end is found. */
 		const char * word_end = word_start;
-		nb = mbrtowc(&c, word_end, MB_CUR_MAX, &mbs);
+		nb = scan_char(dict, word_end, &mbs, &space);
 		if (0 > nb) BAD_UTF;
-		while (!is_space(c, dict->lctype) && (c != 0) && (0 < nb))
+		while (!space && (0 < nb))
 		{
 			word_end += nb;
-			nb = mbrtowc(&c, word_end, MB_CUR_MAX, &mbs);
+			nb = scan_char(dict, word_end, &mbs, &space);
 			if (0 > nb) break;
 		}
 		if (0 > nb) BAD_UTF;
@@ -3078,6 +3146,16 @@ bool separate_sentence(Sentence sent, Parse_Options opts)
 			continue;
 		}
 
+		/* The wall-clock deadline and cancellation cover the tokenization
+		 * too. An incompletely tokenized sentence cannot be parsed. */
+		if (resources_interrupted(opts->resources))
+		{
+			if (verbosity >= D_USER_TIMES)
+				prt_error("#### Tokenization interrupted\n");
+			wordgraph_delete(sent);
+			return false;
+		}
+
 		/* Perform prefix, suffix splitting, if needed */
 #ifdef DEBUG_WORDGRAPH
 		if (SYNTHETIC_SENTENCE_MARK == sent->orig_sentence[0])
@@ -3087,7 +3165,7 @@ bool separate_sentence(Sentence sent, Parse_Options opts)
 			;
 #endif /* DEBUG_WORDGRAPH */
 		else
-			separate_word(sent, word, opts);
+			separate_word_memo(sent, word, opts);
 
 		word->tokenizing_step = TS_DONE;
 	}
@@ -560,6 +560,14 @@ bool sentence_display_wordgraph(Sentence sent, const char *modestr)
 	const char *mp;
 	bool rc = true;
 
+	/* Sentences whose results came from the result cache are not
+	 * necessarily tokenized. */
+	if (NULL == sent->wordgraph)
+	{
+		prt_error("Error: The sentence has no wordgraph\n");
+		return false;
+	}
+
 	for (mp = modestr; '\0' != *mp && ',' != *mp; mp++)
 	{
 		if ((*mp >= 'a') && (*mp <= 'z')) mode |= 1<<(*mp-'a');
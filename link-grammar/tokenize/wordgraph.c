@@ -566,6 +566,25 @@ gword_set *gword_set_union(gword_set *kept, gword_set *eliminated)
 	return kept;
 }
 
+/**
+ * Return a gword_set of the given gwords, in the given order.
+ * Like the sets made by gword_set_union(), it is freed along with the
+ * wordgraph.
+ *
+ * @param gw Array of gwords (with no duplicates).
+ * @param n Number of gwords (at least one).
+ */
+gword_set *gword_set_new(Gword *const *gw, size_t n)
+{
+	if (1 == n) return &gw[0]->gword_set_head;
+
+	gword_set *gset = NULL;
+	for (size_t i = n; i > 0; i--)
+		gset = gword_set_add(gset, &gw[i-1]->gword_set_head);
+
+	return gset;
+}
+
 // --------------------------------------------------------------------
 
 static void word_queue_delete(Sentence sent)
@@ -382,6 +382,9 @@ static inline int is_utf8_upper(const char *s, locale_t dict_locale)
 	wchar_t c;
 	int nbytes;
 
+	/* ASCII fast path; the same in every locale. */
+	if (0 == (*s & 0x80)) return (('A' <= *s) && (*s <= 'Z')) ? 1 : 0;
+
 	memset(&mbs, 0, sizeof(mbs));
 	nbytes = mbrtowc(&c, s, MB_CUR_MAX, &mbs);
 	if (nbytes < 0) return 0;  /* invalid mb sequence */
@@ -395,6 +398,10 @@ static inline int is_utf8_alpha(const char *s, locale_t dict_locale)
 	wchar_t c;
 	int nbytes;
 
+	/* ASCII fast path; the same in every locale. */
+	if (0 == (*s & 0x80))
+		return ((('a' <= *s) && (*s <= 'z')) || (('A' <= *s) && (*s <= 'Z'))) ? 1 : 0;
+
 	memset(&mbs, 0, sizeof(mbs));
 	nbytes = mbrtowc(&c, s, MB_CUR_MAX, &mbs);
 	if (nbytes < 0) return 0;  /* invalid mb sequence */
@@ -408,6 +415,9 @@ static inline int is_utf8_digit(const char *s, locale_t dict_locale)
 	wchar_t c;
 	int nbytes;
 
+	/* ASCII fast path; the same in every locale. */
+	if (0 == (*s & 0x80)) return (('0' <= *s) && (*s <= '9')) ? 1 : 0;
+
 	memset(&mbs, 0, sizeof(mbs));
 	nbytes = mbrtowc(&c, s, MB_CUR_MAX, &mbs);
 	if (nbytes < 0) return 0;  /* invalid mb sequence */
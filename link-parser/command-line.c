@@ -12,6 +12,7 @@
 /*************************************************************************/
 
 #include <errno.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <wchar.h>
@@ -31,13 +32,17 @@ static struct
 	int linkage_limit;
 	int islands_ok;
 	int repeatable_rand;
+	int anytime;
+	int adaptive_cost;
 	int spell_guess;
 	int short_length;
 	int batch_mode;
+	int stream_mode;
 	int panic_mode;
 	int allow_null;
 #if USE_SAT_SOLVER
 	int use_sat_solver;
+	int portfolio;
 #endif
 	int echo_on;
 	Cost_Model_type cost_model;
@@ -53,6 +58,8 @@ static struct
 	int display_disjuncts;
 	int display_morphology;
 	int display_wordgraph;
+	int result_cache;
+	char *prune_cache;
 
 	panic_options panic;
 } local, saved_defaults;
@@ -72,8 +79,11 @@ static int variables_cmd(const Switch*, int);
 
 Switch default_switches[] =
 {
+	{"adapt-cost", Bool, "Lower cost-max on combinatorial explosion", &local.adaptive_cost},
+	{"anytime",    Bool, "Keep partial results on timeout", &local.anytime},
 	{"bad",        Bool, "Display of bad linkages",         &local.display_bad},
 	{"batch",      Bool, "Batch mode",                      &local.batch_mode},
+	{"cache",      Int,  "Number of cached parse results",  &local.result_cache},
 	{"constituents", Int,  "Generate constituent output",   &local.display_constituents},
 	{"cost-model", Int,  UNDOC "Cost model used for ranking", &local.cost_model},
 	{"cost-max",   Float, "Largest cost to be considered",  &local.max_cost},
@@ -85,7 +95,7 @@ Switch default_switches[] =
 	{"islands-ok", Bool, "Use of null-linked islands",      &local.islands_ok},
 	{"limit",      Int,  "The maximum linkages processed",  &local.linkage_limit},
 	{"links",      Bool, "Display of complete link data",   &local.display_links},
-	{"memory",     Int,  UNDOC "Max memory allowed",        &local.memory},
+	{"memory",     Int,  "Abort parsing above this many bytes", &local.memory},
 	{"morphology", Bool, "Display word morphology",         &local.display_morphology},
 	{"null",       Bool, "Allow null links",                &local.allow_null},
 	{"panic",      Bool, "Use of \"panic mode\"",           &local.panic_mode},
@@ -95,13 +105,18 @@ Switch default_switches[] =
 	{"panic_max-null-count", Int, "Max number of null links allowed", &local.panic.max_null_count},
 	{"panic_spell",     Int, "Up to this many spell-guesses per unknown word", &local.panic.spell_guess},
 	{"panic_timeout",   Int, "Abort panic parsing after this many seconds", &local.panic.timeout},
+#ifdef USE_SAT_SOLVER
+	{"portfolio",  Bool, "Race the classic and SAT parsers", &local.portfolio},
+#endif /* USE_SAT_SOLVER */
 	{"postscript", Bool, "Generate postscript output",      &local.display_postscript},
+	{"prune-cache", String, "Directory of the pruned disjuncts cache", &local.prune_cache},
 	{"ps-header",  Bool, "Generate postscript header",      &local.display_ps_header},
 	{"rand",       Bool, "Use repeatable random numbers",   &local.repeatable_rand},
 	{"short",      Int,  "Max length of short links",       &local.short_length},
 #if defined HAVE_HUNSPELL || defined HAVE_ASPELL
 	{"spell",      Int, "Up to this many spell-guesses per unknown word", &local.spell_guess},
 #endif /* HAVE_HUNSPELL */
+	{"stream",     Bool, "Document stream input",           &local.stream_mode},
 	{"test",       String, "Comma-separated test features", &local.test},
 	{"timeout",    Int,  "Abort parsing after this many seconds", &local.timeout},
 #ifdef USE_SAT_SOLVER
@@ -139,6 +154,7 @@ void save_default_opts(Command_Options *copts)
 	saved_defaults.test = (char *)"";
 	saved_defaults.debug = (char *)"";
 	saved_defaults.dialect = (char *)"";
+	saved_defaults.prune_cache = (char *)"";
 	saved_defaults.verbosity = 1;
 }
 
@@ -1024,20 +1040,25 @@ void put_opts_in_local_vars(Command_Options* copts)
 	local.dialect = parse_options_get_dialect(opts);
 	local.test = parse_options_get_test(opts);
 	local.timeout = parse_options_get_max_parse_time(opts);;
-	local.memory = parse_options_get_max_memory(opts);;
+	size_t max_memory = parse_options_get_max_memory(opts);
+	local.memory = (max_memory > INT_MAX) ? -1 : (int)max_memory;
 	local.linkage_limit = parse_options_get_linkage_limit(opts);
 	local.islands_ok = parse_options_get_islands_ok(opts);
 	local.repeatable_rand = parse_options_get_repeatable_rand(opts);
+	local.anytime = parse_options_get_anytime(opts);
+	local.adaptive_cost = parse_options_get_adaptive_cost(opts);
 	local.spell_guess = parse_options_get_spell_guess(opts);
 	local.short_length = parse_options_get_short_length(opts);
 	local.cost_model = parse_options_get_cost_model_type(opts);
 	local.max_cost = parse_options_get_disjunct_cost(opts);
 #if USE_SAT_SOLVER
 	local.use_sat_solver = parse_options_get_use_sat_parser(opts);
+	local.portfolio = parse_options_get_portfolio(opts);
 #endif
 	local.screen_width = (int)copts->screen_width;
 	local.echo_on = copts->echo_on;
 	local.batch_mode = copts->batch_mode;
+	local.stream_mode = copts->stream_mode;
 	local.panic_mode = copts->panic_mode;
 	local.allow_null = copts->allow_null;
 	local.display_on = copts->display_on;
@@ -1046,6 +1067,8 @@ void put_opts_in_local_vars(Command_Options* copts)
 	local.display_ps_header = copts->display_ps_header;
 	local.display_constituents = copts->display_constituents;
 	local.display_wordgraph = copts->display_wordgraph;
+	local.result_cache = copts->result_cache;
+	local.prune_cache = copts->prune_cache;
 
 	local.display_bad = copts->display_bad;
 	local.display_disjuncts = copts->display_disjuncts;
@@ -1064,22 +1087,27 @@ void put_local_vars_in_opts(Command_Options* copts)
 	parse_options_set_test(opts, local.test);
 	parse_options_set_dialect(opts, local.dialect);
 	parse_options_set_max_parse_time(opts, local.timeout);
-	parse_options_set_max_memory(opts, local.memory);
+	parse_options_set_max_memory(opts,
+		(local.memory < 0) ? (size_t)-1 : (size_t)local.memory);
 	parse_options_set_linkage_limit(opts, local.linkage_limit);
 	parse_options_set_islands_ok(opts, local.islands_ok);
 	parse_options_set_repeatable_rand(opts, local.repeatable_rand);
+	parse_options_set_anytime(opts, local.anytime);
+	parse_options_set_adaptive_cost(opts, local.adaptive_cost);
 	parse_options_set_spell_guess(opts, local.spell_guess);
 	parse_options_set_short_length(opts, local.short_length);
 	parse_options_set_cost_model_type(opts, local.cost_model);
 	parse_options_set_disjunct_cost(opts, local.max_cost);
 #if USE_SAT_SOLVER
 	parse_options_set_use_sat_parser(opts, local.use_sat_solver);
+	parse_options_set_portfolio(opts, local.portfolio);
 #endif
 	parse_options_set_display_morphology(opts, local.display_morphology);
 
 	copts->screen_width = (size_t)local.screen_width;
 	copts->echo_on = local.echo_on;
 	copts->batch_mode = local.batch_mode;
+	copts->stream_mode = local.stream_mode;
 	copts->panic_mode = local.panic_mode;
 	copts->allow_null = local.allow_null;
 	copts->display_on = local.display_on;
@@ -1088,6 +1116,14 @@ void put_local_vars_in_opts(Command_Options* copts)
 	copts->display_ps_header = local.display_ps_header;
 	copts->display_constituents = local.display_constituents;
 	copts->display_wordgraph = local.display_wordgraph;
+	copts->result_cache = local.result_cache;
+	if (0 != strcmp(copts->prune_cache, local.prune_cache))
+	{
+		/* local.prune_cache may point to a temporary command buffer. */
+		char *prune_cache = strdup(local.prune_cache);
+		free(copts->prune_cache);
+		copts->prune_cache = prune_cache;
+	}
 
 	copts->display_bad = local.display_bad;
 	copts->display_disjuncts = local.display_disjuncts;
@@ -1124,6 +1160,7 @@ Command_Options* command_options_create(void)
 	co->screen_width = 16381;
 	co->allow_null = true;
 	co->batch_mode = false;
+	co->stream_mode = false;
 	co->echo_on = false;
 	co->panic_mode = true;
 	co->display_on = true;
@@ -1136,6 +1173,8 @@ Command_Options* command_options_create(void)
 	co->display_disjuncts = false;
 	co->display_links = false;
 	co->display_wordgraph = 0;
+	co->result_cache = 0;
+	co->prune_cache = strdup("");
 
 	co->panic.max_cost = 4.0f;
 	co->panic.linkage_limit = 1000;
@@ -1149,5 +1188,6 @@ Command_Options* command_options_create(void)
 void command_options_delete(Command_Options* co)
 {
 	parse_options_delete(co->popts);
+	free(co->prune_cache);
 	free(co);
 }
@@ -47,6 +47,7 @@ typedef struct {
 
 	unsigned int screen_width; /* width of screen for displaying linkages */
 	bool batch_mode;        /* if true, process sentences non-interactively */
+	bool stream_mode;       /* if true, split the input into sentences */
 	bool allow_null;        /* true if we allow null links in parsing */
 	bool echo_on;           /* true if we should echo the input sentence */
 	bool panic_mode;        /* if true, parse in "panic mode" after all else fails */
@@ -60,6 +61,8 @@ typedef struct {
 	bool display_disjuncts; /* if true, print disjuncts that were used */
 	bool display_links;     /* if true, a list o' links is printed out */
 	int  display_wordgraph; /* if nonzero, the word-graph is displayed */
+	int  result_cache;      /* max number of cached sentence parse results */
+	char *prune_cache;      /* directory of the pruned disjuncts cache */
 } Command_Options;
 
 void put_local_vars_in_opts(Command_Options *);
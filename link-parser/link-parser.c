@@ -56,8 +56,11 @@
 #include "lg_readline.h"                // find_history_file
 
 #define DISPLAY_MAX 1024
+#define RESULT_CACHE_MAX_BYTES (256*1024*1024)
 
 static int batch_errors = 0;
+static int result_cache_size = 0;
+static char *prune_cache_dir = NULL;
 static int verbosity = 0;
 static char * debug = (char *)"";
 static char * test = (char *)"";
@@ -358,6 +361,9 @@ static const char *process_some_linkages(FILE *in, Sentence sent,
 		{
 			if (!auto_next_linkage)
 			{
+				/* The input is the document; show only the first linkage. */
+				if (copts->stream_mode) break;
+
 				if ((verbosity > 0) && (!copts->batch_mode) && isatty_io)
 				{
 					fprintf(stdout, "Press RETURN for the next linkage.\n");
@@ -459,6 +465,32 @@ static Label strip_off_label(char * input_string)
 	}
 }
 
+#define STREAM_CHUNK (64*1024)
+
+/**
+ * In stream mode, return the next sentence of the document that is
+ * read from \p in, or NULL at its end. The document is read in chunks
+ * and split into sentences by the library, so it doesn't have to be
+ * in one-sentence-per-line format, and can be of any size.
+ */
+static char *stream_input_string(Document doc, FILE *in,
+                                 size_t *offset, size_t *length)
+{
+	static char buf[STREAM_CHUNK];
+	const char *sentence;
+
+	while (NULL == (sentence = document_next_sentence(doc, offset, length)))
+	{
+		if (feof(in) || ferror(in)) return NULL;
+
+		size_t n = fread(buf, 1, sizeof(buf), in);
+		if (0 < n) document_feed(doc, buf, n);
+		if (n < sizeof(buf)) document_end(doc);
+	}
+
+	return (char *)sentence;
+}
+
 static int divert_stdio(FILE *from, FILE *to)
 {
 	const int origfd = dup(fileno(from));
@@ -557,6 +589,7 @@ int main(int argc, char * argv[])
 	Label           label = NO_LABEL;
 	Command_Options *copts;
 	Parse_Options   opts;
+	Document        doc = NULL;
 	bool batch_in_progress = false;
 
 	isatty_io = isatty(fileno(stdin)) && isatty(fileno(stdout));
@@ -734,6 +767,25 @@ int main(int argc, char * argv[])
 		debug = parse_options_get_debug(opts);
 		test = parse_options_get_test(opts);
 
+		if (copts->stream_mode)
+		{
+			size_t offset, length;
+
+			if (NULL == doc) doc = document_create(dict);
+			input_string = stream_input_string(doc, input_fh, &offset, &length);
+			if (NULL == input_string)
+			{
+				if (ferror(input_fh))
+					prt_error("Error: Read: %s\n", strerror(errno));
+				break;
+			}
+
+			/* The input is just text; there are no commands in it. */
+			set_screen_width(copts);
+			printf("%% offset %zu length %zu\n", offset, length);
+			goto parse_sentence;
+		}
+
 		input_string = fget_input_string(use_prompt(verbosity), input_fh, stdout,
 
 		                                 isatty_io, /*check_return*/false);
@@ -815,6 +867,7 @@ open_error:
 			continue;
 		}
 
+parse_sentence:
 		if (!copts->batch_mode) batch_in_progress = false;
 		if ('\0' != test[0] && !test_enabled(test, "@"))
 		{
@@ -834,11 +887,27 @@ open_error:
 			printf("%s\n", input_string);
 		}
 
-		if (copts->batch_mode || auto_next_linkage_test(test))
+		if ((copts->batch_mode || auto_next_linkage_test(test)) &&
+		    !copts->stream_mode)
 		{
 			label = strip_off_label(input_string);
 		}
 
+		if (copts->result_cache != result_cache_size)
+		{
+			result_cache_size = MAX(copts->result_cache, 0);
+			dictionary_set_result_cache(dict, result_cache_size,
+			                            RESULT_CACHE_MAX_BYTES);
+		}
+
+		if (0 != strcmp(copts->prune_cache,
+		                (NULL == prune_cache_dir) ? "" : prune_cache_dir))
+		{
+			free(prune_cache_dir);
+			prune_cache_dir = strdup(copts->prune_cache);
+			dictionary_set_prune_cache(dict, prune_cache_dir);
+		}
+
 		// Post-processing-based pruning will clip away connectors
 		// that we might otherwise want to examine. So disable PP
 		// pruning in this situation.
@@ -968,7 +1037,12 @@ open_error:
 				fprintf(stdout, "Memory is exhausted!\n");
 		}
 
-		if (copts->panic_mode && parse_options_resources_exhausted(opts))
+		/* In anytime mode, a partial result is good enough. */
+		bool have_partial_result = parse_options_get_anytime(opts) &&
+			(sentence_num_valid_linkages(sent) > 0);
+
+		if (copts->panic_mode && parse_options_resources_exhausted(opts) &&
+		    !have_partial_result)
 		{
 			batch_errors++;
 			if (verbosity > 0)
@@ -1009,6 +1083,21 @@ open_error:
 		if ((NULL == rc) && (input_fh == stdin)) break;
 	}
 
+	if ((0 != result_cache_size) && (verbosity > 1))
+	{
+		fprintf(stdout, "Result cache: %zu hits, %zu misses\n",
+		        dictionary_get_result_cache_hits(dict),
+		        dictionary_get_result_cache_misses(dict));
+	}
+
+	if ((NULL != prune_cache_dir) && ('\0' != prune_cache_dir[0]) &&
+	    (verbosity > 1))
+	{
+		fprintf(stdout, "Prune cache: %zu hits, %zu misses\n",
+		        dictionary_get_prune_cache_hits(dict),
+		        dictionary_get_prune_cache_misses(dict));
+	}
+
 	if (copts->batch_mode)
 	{
 		/* print_time(opts, "Total"); */
@@ -1017,8 +1106,10 @@ open_error:
 	}
 
 	/* Free stuff, so that mem-leak detectors don't complain. */
+	document_delete(doc);
 	command_options_delete(copts);
 	dictionary_delete(dict);
+	free(prune_cache_dir);
 
 	printf ("Bye.\n");
 	return 0;
@@ -0,0 +1,1099 @@
+/*
+ * link-server.c
+ *
+ * A parse server. Parse requests arrive over a TCP or a Unix-domain
+ * socket, and the linkages are returned in JSON. The protocol is the
+ * one of the Java LGService (bindings/java/org/linkgrammar), so its
+ * clients (e.g. LGRemoteClient) can use this server as is.
+ *
+ * A single thread does all the socket I/O with epoll, and a fixed pool
+ * of worker threads does the parsing. All the workers share the same
+ * Dictionary; each one has its own Parse_Options.
+ *
+ * Copyright (c) 2026
+ */
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <link-includes.h>
+
+#define MAX_EVENTS 64
+#define MAX_REQUEST_SIZE (1024*1024) /* Longer requests close the connection. */
+#define READ_CHUNK 8192
+
+static int verbosity = 0;
+
+/* Server configuration. */
+static struct
+{
+	const char *language;
+	int port;
+	const char *socket_path;
+	unsigned int num_threads;
+	unsigned int batch_size;
+	double max_parse_seconds;  /* Default request deadline. */
+	double max_cost;           /* Default disjunct cost. */
+	int max_linkages;          /* Default for maxLinkages. */
+} config =
+{
+	.language = "en",
+	.port = -1,
+	.num_threads = 0,          /* 0: one per CPU */
+	.batch_size = 8,
+	.max_parse_seconds = 60,
+	.max_cost = 2.7,
+	.max_linkages = 25,
+};
+
+static Dictionary dict;
+
+/* ======================================================== */
+/* Growable string buffer. */
+
+typedef struct
+{
+	char *s;
+	size_t len;
+	size_t size;
+} buffer_t;
+
+static void buf_reserve(buffer_t *b, size_t n)
+{
+	if (b->len + n + 1 <= b->size) return;
+	size_t size = (0 == b->size) ? 256 : b->size;
+	while (b->len + n + 1 > size) size *= 2;
+	b->s = realloc(b->s, size);
+	if (NULL == b->s) { perror("realloc"); exit(EXIT_FAILURE); }
+	b->size = size;
+}
+
+static void buf_append(buffer_t *b, const char *s, size_t n)
+{
+	buf_reserve(b, n);
+	memcpy(b->s + b->len, s, n);
+	b->len += n;
+	b->s[b->len] = '\0';
+}
+
+static void buf_puts(buffer_t *b, const char *s)
+{
+	buf_append(b, s, strlen(s));
+}
+
+static void buf_printf(buffer_t *b, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+static void buf_printf(buffer_t *b, const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	int n = vsnprintf(NULL, 0, fmt, ap);
+	va_end(ap);
+
+	buf_reserve(b, n);
+	va_start(ap, fmt);
+	vsnprintf(b->s + b->len, n + 1, fmt, ap);
+	va_end(ap);
+	b->len += n;
+}
+
+/** Append \p s as a JSON string, or "null" if it is NULL. */
+static void buf_json_string(buffer_t *b, const char *s)
+{
+	if (NULL == s)
+	{
+		buf_puts(b, "null");
+		return;
+	}
+
+	buf_append(b, "\"", 1);
+	for (const char *p = s; '\0' != *p; p++)
+	{
+		unsigned char c = (unsigned char)*p;
+		switch (c)
+		{
+			case '"':  buf_append(b, "\\\"", 2); break;
+			case '\\': buf_append(b, "\\\\", 2); break;
+			case '\b': buf_append(b, "\\b", 2); break;
+			case '\f': buf_append(b, "\\f", 2); break;
+			case '\n': buf_append(b, "\\n", 2); break;
+			case '\r': buf_append(b, "\\r", 2); break;
+			case '\t': buf_append(b, "\\t", 2); break;
+			default:
+				if (c < 0x20)
+					buf_printf(b, "\\u%04x", c);
+				else
+					buf_append(b, p, 1);
+		}
+	}
+	buf_append(b, "\"", 1);
+}
+
+/* ======================================================== */
+/* Connections and requests. */
+
+typedef struct connection_s connection_t;
+typedef struct request_s request_t;
+
+struct request_s
+{
+	request_t *next;           /* Next request of the same connection */
+	request_t *qnext;          /* Next in the work or done queue */
+	connection_t *conn;
+	char *msg;                 /* The request line (may contain '\0') */
+	size_t msg_len;
+	double arrival;            /* When it has been read */
+	buffer_t response;         /* Length line, JSON and newline */
+	bool done;
+};
+
+struct connection_s
+{
+	int fd;
+	buffer_t in;               /* Unterminated request line */
+	buffer_t out;              /* Response bytes not written yet */
+	size_t out_pos;
+	request_t *head, *tail;    /* Outstanding requests, in arrival order */
+	unsigned int pending;      /* Requests not yet done by the workers */
+	bool eof;                  /* The peer has stopped sending */
+	bool closed;               /* fd is closed; free when pending is 0 */
+	bool want_write;           /* Output is waiting for EPOLLOUT */
+	uint32_t events;           /* Events now in the epoll set */
+	connection_t *next_ready;  /* In the list of collect_responses() */
+	connection_t *next_dead;   /* In dead_connections */
+	connection_t *prev, *next; /* In connections */
+};
+
+/* Requests to be parsed. */
+static struct
+{
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	request_t *head, *tail;
+	unsigned int len;          /* Number of queued requests */
+	bool stop;
+} work_queue =
+{
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+};
+
+/* Parsed requests, to be answered by the I/O thread. */
+static struct
+{
+	pthread_mutex_t lock;
+	request_t *head, *tail;
+} done_queue =
+{
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static int epoll_fd = -1;
+static int listen_fd = -1;
+static int event_fd = -1;          /* Wakes up the I/O thread */
+static volatile sig_atomic_t stop_requested;
+
+/* Closed connections with no pending requests. They are freed after
+ * the current batch of epoll events, which may still refer to them. */
+static connection_t *dead_connections;
+
+/* All the connections, to free those that are left at exit. */
+static connection_t *connections;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void wakeup_io_thread(void)
+{
+	uint64_t one = 1;
+	ssize_t rc = write(event_fd, &one, sizeof(one));
+	(void)rc; /* If the counter is full, a wakeup is pending anyway. */
+}
+
+/* ======================================================== */
+/* Request handling (worker threads). */
+
+typedef struct
+{
+	bool get_version;
+	const char *text;
+	size_t text_len;
+	int max_linkages;
+	double max_parse_seconds;
+	double max_cost;
+	bool store_constituent_string;
+	bool store_diagram_string;
+} request_params;
+
+static const char *trim(const char *s, const char *end, size_t *len)
+{
+	while ((s < end) && ((*s == ' ') || (*s == '\t') || (*s == '\r'))) s++;
+	while ((end > s) &&
+	       ((end[-1] == ' ') || (end[-1] == '\t') || (end[-1] == '\r'))) end--;
+	*len = end - s;
+	return s;
+}
+
+static bool key_is(const char *key, size_t key_len, const char *name)
+{
+	return (strlen(name) == key_len) && (0 == strncmp(key, name, key_len));
+}
+
+/**
+ * Parse a request of the LGService protocol. It is a sequence of
+ * "name:value" pairs, separated by '\0' (or ','). All the characters
+ * after "text:" are the text to parse, so "text" must be the last
+ * parameter. Return false if the request is malformed.
+ */
+static bool parse_request(const request_t *req, request_params *p)
+{
+	*p = (request_params)
+	{
+		.max_linkages = config.max_linkages,
+		.max_parse_seconds = config.max_parse_seconds,
+		.max_cost = config.max_cost,
+	};
+
+	const char *s = req->msg;
+	const char *end = req->msg + req->msg_len;
+	while (s < end)
+	{
+		const char *colon = memchr(s, ':', end - s);
+		if (NULL == colon)
+		{
+			size_t len;
+			trim(s, end, &len);
+			return (0 == len); /* Allow trailing separators */
+		}
+
+		size_t key_len;
+		const char *key = trim(s, colon, &key_len);
+		bool is_text = key_is(key, key_len, "text");
+
+		const char *vend = colon + 1;
+		while ((vend < end) && (*vend != '\0') && (is_text || (*vend != ',')))
+			vend++;
+
+		size_t val_len;
+		const char *val = trim(colon + 1, vend, &val_len);
+		char num[64];
+		snprintf(num, sizeof(num), "%.*s",
+		         (int)((val_len < sizeof(num)) ? val_len : 0), val);
+
+		if (is_text)
+		{
+			p->text = val;
+			p->text_len = val_len;
+		}
+		else if (key_is(key, key_len, "get"))
+			p->get_version = (0 == strcmp(num, "version"));
+		else if (key_is(key, key_len, "maxLinkages"))
+			p->max_linkages = atoi(num);
+		else if (key_is(key, key_len, "maxParseSeconds"))
+		{
+			/* Negative values mean "not set", as in LGService. */
+			if (atof(num) >= 0) p->max_parse_seconds = atof(num);
+		}
+		else if (key_is(key, key_len, "maxCost"))
+		{
+			if (atof(num) >= 0) p->max_cost = atof(num);
+		}
+		else if (key_is(key, key_len, "storeConstituentString"))
+			p->store_constituent_string = (0 == strcmp(num, "true"));
+		else if (key_is(key, key_len, "storeDiagramString"))
+			p->store_diagram_string = (0 == strcmp(num, "true"));
+
+		s = vend + 1;
+	}
+
+	return true;
+}
+
+static void json_linkage(buffer_t *b, Linkage lkg, Sentence sent,
+                         LinkageIdx li, const request_params *p)
+{
+	size_t num_words = linkage_get_num_words(lkg);
+
+	buf_puts(b, "{\"words\":[");
+	for (WordIdx w = 0; w < num_words; w++)
+	{
+		if (w > 0) buf_append(b, ",", 1);
+		buf_json_string(b, linkage_get_word(lkg, w));
+	}
+
+	buf_puts(b, "],\"disjuncts\":[");
+	for (WordIdx w = 0; w < num_words; w++)
+	{
+		if (w > 0) buf_append(b, ",", 1);
+		buf_json_string(b, linkage_get_disjunct_str(lkg, w));
+	}
+
+	buf_printf(b, "],\"disjunctCost\":%.6g,\"linkageCost\":%d"
+	           ",\"numViolations\":%d",
+	           linkage_disjunct_cost(lkg), linkage_link_cost(lkg),
+	           sentence_num_violations(sent, li));
+
+	if (p->store_constituent_string)
+	{
+		char *s = linkage_print_constituent_tree(lkg, MULTILINE);
+		buf_puts(b, ",\"constituentString\":");
+		buf_json_string(b, s);
+		linkage_free_constituent_tree_str(s);
+	}
+	if (p->store_diagram_string)
+	{
+		char *s = linkage_print_diagram(lkg, true, 8100);
+		buf_puts(b, ",\"diagramString\":");
+		buf_json_string(b, s);
+		linkage_free_diagram(s);
+	}
+
+	buf_puts(b, ",\"links\":[");
+	size_t num_links = linkage_get_num_links(lkg);
+	for (LinkIdx i = 0; i < num_links; i++)
+	{
+		if (i > 0) buf_append(b, ",", 1);
+		buf_puts(b, "{\"label\":");
+		buf_json_string(b, linkage_get_link_label(lkg, i));
+		buf_printf(b, ",\"left\":%zu,\"right\":%zu,\"leftLabel\":",
+		           linkage_get_link_lword(lkg, i),
+		           linkage_get_link_rword(lkg, i));
+		buf_json_string(b, linkage_get_link_llabel(lkg, i));
+		buf_puts(b, ",\"rightLabel\":");
+		buf_json_string(b, linkage_get_link_rlabel(lkg, i));
+		buf_append(b, "}", 1);
+	}
+	buf_puts(b, "]}");
+}
+
+/**
+ * Parse the text of the request, and write the result as JSON.
+ * The deadline of the request counts from its arrival, so the time it
+ * has waited in the queue is taken off its parse time.
+ */
+static void json_parse_result(buffer_t *b, const request_params *p,
+                              double arrival, Parse_Options opts)
+{
+	int num_linkages = 0;
+	int null_count = 0;
+	bool timed_out = false;
+	Sentence sent = NULL;
+
+	double time_left = p->max_parse_seconds - (now() - arrival);
+	if ((p->max_parse_seconds > 0) && (time_left <= 0))
+	{
+		timed_out = true;
+	}
+	else if (p->text_len > 0)
+	{
+		char *text = strndup(p->text, p->text_len);
+		sent = sentence_create(text, dict);
+		free(text);
+	}
+
+	if (NULL != sent)
+	{
+		parse_options_reset_resources(opts);
+		parse_options_set_deadline(opts, (p->max_parse_seconds > 0) ? time_left : 0);
+		parse_options_set_disjunct_cost(opts, p->max_cost);
+
+		/* First without null links; then allow them, as the JNI does. */
+		parse_options_set_min_null_count(opts, 0);
+		parse_options_set_max_null_count(opts, 0);
+		num_linkages = sentence_parse(sent, opts);
+		if (0 == num_linkages)
+		{
+			parse_options_set_min_null_count(opts, 1);
+			parse_options_set_max_null_count(opts, sentence_length(sent));
+			num_linkages = sentence_parse(sent, opts);
+		}
+		timed_out = parse_options_timer_expired(opts) ||
+		            (0 == parse_options_get_deadline(opts));
+		if (num_linkages > 0) null_count = sentence_null_count(sent);
+	}
+
+	buf_printf(b, "{\"numSkippedWords\":%d,\"linkages\":[", null_count);
+	int max_linkages = (p->max_linkages < num_linkages) ?
+	                   p->max_linkages : num_linkages;
+	bool first = true;
+	for (LinkageIdx li = 0; (int)li < max_linkages; li++)
+	{
+		Linkage lkg = linkage_create(li, sent, opts);
+		if (NULL == lkg) continue;
+		if (!first) buf_append(b, ",", 1);
+		first = false;
+		json_linkage(b, lkg, sent, li, p);
+		linkage_delete(lkg);
+	}
+	buf_puts(b, "]");
+	if (timed_out) buf_puts(b, ",\"timedOut\":true");
+	buf_puts(b, ",\"version\":");
+	buf_json_string(b, linkgrammar_get_version());
+	buf_puts(b, ",\"dictVersion\":");
+	buf_json_string(b, linkgrammar_get_dict_version(dict));
+	buf_puts(b, "}");
+
+	if (NULL != sent) sentence_delete(sent);
+}
+
+/**
+ * The number of UTF-16 code units of the UTF-8 string \p s. The Java
+ * clients read the response into a char array of this size.
+ */
+static size_t utf16_length(const char *s, size_t len)
+{
+	size_t n = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		unsigned char c = (unsigned char)s[i];
+		if (0x80 != (c & 0xC0)) n++;  /* Not a continuation byte */
+		if (c >= 0xF0) n++;           /* A surrogate pair */
+	}
+	return n;
+}
+
+static void handle_request(request_t *req, Parse_Options opts)
+{
+	request_params p;
+	buffer_t json = {0};
+
+	if (verbosity > 1)
+		fprintf(stderr, "Request: %.*s\n", (int)req->msg_len, req->msg);
+
+	if (!parse_request(req, &p))
+		buf_puts(&json, "{\"error\":\"Malformed request\"}");
+	else if (p.get_version)
+	{
+		buf_puts(&json, "{\"version\":");
+		buf_json_string(&json, linkgrammar_get_version());
+		buf_puts(&json, "}");
+	}
+	else
+		json_parse_result(&json, &p, req->arrival, opts);
+
+	/* The response is preceded by its length (including the final
+	 * newline) on a line of its own, like LGService does. It is the
+	 * length of the Java string, in UTF-16 code units. */
+	buf_printf(&req->response, "%zu\n", utf16_length(json.s, json.len) + 1);
+	buf_append(&req->response, json.s, json.len);
+	buf_append(&req->response, "\n", 1);
+	free(json.s);
+}
+
+/**
+ * Hand a parsed request to the I/O thread. It is woken up only if the
+ * done queue was empty, since it takes the whole queue when it wakes up.
+ */
+static void publish_response(request_t *req)
+{
+	pthread_mutex_lock(&done_queue.lock);
+	bool was_empty = (NULL == done_queue.head);
+	req->qnext = NULL;
+	if (NULL == done_queue.tail)
+		done_queue.head = req;
+	else
+		done_queue.tail->qnext = req;
+	done_queue.tail = req;
+	pthread_mutex_unlock(&done_queue.lock);
+
+	if (was_empty) wakeup_io_thread();
+}
+
+/**
+ * Worker thread. Under load, it takes several requests at a time, so
+ * that the queue lock is paid per batch and not per request. A batch is
+ * at most the fair share of the thread of the queued requests, so that
+ * the other threads are not left idle, and each response is published as
+ * soon as it is ready, so that it doesn't wait for the rest of the batch.
+ */
+static void *worker(void *arg)
+{
+	Parse_Options opts = parse_options_create();
+	parse_options_set_verbosity(opts, verbosity);
+	parse_options_set_linkage_limit(opts, 1000);
+	parse_options_set_short_length(opts, 16);
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_display_morphology(opts, true);
+
+	for (;;)
+	{
+		pthread_mutex_lock(&work_queue.lock);
+		while ((NULL == work_queue.head) && !work_queue.stop)
+			pthread_cond_wait(&work_queue.cond, &work_queue.lock);
+		if (work_queue.stop)
+		{
+			pthread_mutex_unlock(&work_queue.lock);
+			break;
+		}
+
+		unsigned int batch_size = work_queue.len / config.num_threads;
+		if (batch_size > config.batch_size) batch_size = config.batch_size;
+		if (0 == batch_size) batch_size = 1;
+
+		request_t *batch = work_queue.head;
+		request_t *last = batch;
+		for (unsigned int n = 1; n < batch_size; n++)
+			last = last->qnext;
+		work_queue.head = last->qnext;
+		if (NULL == work_queue.head) work_queue.tail = NULL;
+		work_queue.len -= batch_size;
+		pthread_mutex_unlock(&work_queue.lock);
+		last->qnext = NULL;
+
+		request_t *next;
+		for (request_t *req = batch; NULL != req; req = next)
+		{
+			next = req->qnext;
+			handle_request(req, opts);
+			publish_response(req);
+		}
+	}
+
+	parse_options_delete(opts);
+	return arg;
+}
+
+/* ======================================================== */
+/* Socket I/O (the main thread). */
+
+static void free_request(request_t *req)
+{
+	free(req->msg);
+	free(req->response.s);
+	free(req);
+}
+
+static void free_connection(connection_t *conn)
+{
+	request_t *next;
+	for (request_t *req = conn->head; NULL != req; req = next)
+	{
+		next = req->next;
+		free_request(req);
+	}
+	free(conn->in.s);
+	free(conn->out.s);
+
+	if (NULL != conn->next) conn->next->prev = conn->prev;
+	if (NULL != conn->prev)
+		conn->prev->next = conn->next;
+	else
+		connections = conn->next;
+	free(conn);
+}
+
+static void bury_connection(connection_t *conn)
+{
+	conn->next_dead = dead_connections;
+	dead_connections = conn;
+}
+
+static void free_dead_connections(void)
+{
+	connection_t *next;
+	for (connection_t *conn = dead_connections; NULL != conn; conn = next)
+	{
+		next = conn->next_dead;
+		free_connection(conn);
+	}
+	dead_connections = NULL;
+}
+
+/**
+ * Close the socket. Requests that are still being parsed refer to the
+ * connection, so it is freed only when the last one of them is done.
+ */
+static void close_connection(connection_t *conn)
+{
+	if (conn->closed) return;
+	if (verbosity > 0) fprintf(stderr, "Closing connection %d\n", conn->fd);
+
+	close(conn->fd); /* Also removes it from the epoll set */
+	conn->closed = true;
+	if (0 == conn->pending) bury_connection(conn);
+}
+
+/**
+ * Listen for input until the peer stops sending, and for output space
+ * while there is output waiting. Input is not watched after EOF, since
+ * EOF would be reported again and again while requests are pending.
+ */
+static void update_events(connection_t *conn)
+{
+	uint32_t events = (conn->eof ? 0 : EPOLLIN) |
+	                  (conn->want_write ? EPOLLOUT : 0);
+	if (conn->events == events) return;
+
+	struct epoll_event ev = { .events = events, .data.ptr = conn };
+	epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn->fd, &ev);
+	conn->events = events;
+}
+
+/**
+ * Move the responses that are ready, in request order, to the output
+ * buffer and write as much of it as the socket takes.
+ */
+static void flush_connection(connection_t *conn)
+{
+	while ((NULL != conn->head) && conn->head->done)
+	{
+		request_t *req = conn->head;
+		conn->head = req->next;
+		if (NULL == conn->head) conn->tail = NULL;
+		buf_append(&conn->out, req->response.s, req->response.len);
+		free_request(req);
+	}
+
+	while (conn->out_pos < conn->out.len)
+	{
+		ssize_t n = send(conn->fd, conn->out.s + conn->out_pos,
+		                 conn->out.len - conn->out_pos, MSG_NOSIGNAL);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) break;
+			close_connection(conn);
+			return;
+		}
+		conn->out_pos += n;
+	}
+
+	if (conn->out_pos == conn->out.len)
+	{
+		conn->out.len = conn->out_pos = 0;
+		conn->want_write = false;
+		if (conn->eof && (NULL == conn->head))
+		{
+			close_connection(conn);
+			return;
+		}
+	}
+	else
+	{
+		conn->want_write = true;
+	}
+	update_events(conn);
+}
+
+/**
+ * Read what is available, and queue a request for each complete line.
+ * All the requests that were read are queued under one lock.
+ */
+static void read_connection(connection_t *conn)
+{
+	request_t *first = NULL, *last = NULL;
+	unsigned int num_requests = 0;
+
+	while (!conn->eof)
+	{
+		buf_reserve(&conn->in, READ_CHUNK);
+		ssize_t n = recv(conn->fd, conn->in.s + conn->in.len, READ_CHUNK, 0);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) break;
+			conn->eof = true;
+			break;
+		}
+		if (0 == n)
+		{
+			conn->eof = true;
+			break;
+		}
+		conn->in.len += n;
+
+		char *line = conn->in.s;
+		char *end = conn->in.s + conn->in.len;
+		char *nl;
+		while (NULL != (nl = memchr(line, '\n', end - line)))
+		{
+			request_t *req = calloc(1, sizeof(request_t));
+			req->conn = conn;
+			req->msg_len = nl - line;
+			req->msg = malloc(req->msg_len + 1);
+			memcpy(req->msg, line, req->msg_len);
+			req->msg[req->msg_len] = '\0';
+			req->arrival = now();
+
+			if (NULL == conn->tail)
+				conn->head = req;
+			else
+				conn->tail->next = req;
+			conn->tail = req;
+			conn->pending++;
+
+			if (NULL == last)
+				first = req;
+			else
+				last->qnext = req;
+			last = req;
+			num_requests++;
+
+			line = nl + 1;
+		}
+		conn->in.len = end - line;
+		memmove(conn->in.s, line, conn->in.len);
+
+		if (conn->in.len > MAX_REQUEST_SIZE)
+		{
+			prt_error("Error: Request too long; closing the connection.\n");
+			conn->eof = true;
+			conn->in.len = 0;
+		}
+	}
+
+	if (NULL != first)
+	{
+		pthread_mutex_lock(&work_queue.lock);
+		if (NULL == work_queue.tail)
+			work_queue.head = first;
+		else
+			work_queue.tail->qnext = first;
+		work_queue.tail = last;
+		work_queue.len += num_requests;
+		pthread_cond_broadcast(&work_queue.cond);
+		pthread_mutex_unlock(&work_queue.lock);
+	}
+
+	/* A final unterminated line is not a request. */
+	if (conn->eof && (NULL == conn->head))
+		close_connection(conn);
+	else
+		update_events(conn);
+}
+
+static void accept_connections(void)
+{
+	for (;;)
+	{
+		int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK|SOCK_CLOEXEC);
+		if (fd < 0)
+		{
+			if ((errno == EINTR) || (errno == ECONNABORTED)) continue;
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+				perror("accept4");
+			return;
+		}
+
+		connection_t *conn = calloc(1, sizeof(connection_t));
+		conn->fd = fd;
+		conn->events = EPOLLIN;
+		struct epoll_event ev = { .events = EPOLLIN, .data.ptr = conn };
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+		{
+			perror("epoll_ctl");
+			close(fd);
+			free(conn);
+			continue;
+		}
+		conn->next = connections;
+		if (NULL != connections) connections->prev = conn;
+		connections = conn;
+		if (verbosity > 0) fprintf(stderr, "Accepted connection %d\n", fd);
+	}
+}
+
+/** Hand the parsed requests back to their connections. */
+static void collect_responses(void)
+{
+	uint64_t count;
+	ssize_t rc = read(event_fd, &count, sizeof(count));
+	(void)rc;
+
+	pthread_mutex_lock(&done_queue.lock);
+	request_t *done = done_queue.head;
+	done_queue.head = done_queue.tail = NULL;
+	pthread_mutex_unlock(&done_queue.lock);
+
+	/* Mark them all first, so that each connection is visited once,
+	 * for all its responses. The requests themselves belong to their
+	 * connection, and are freed with it. */
+	connection_t *flush_list = NULL;
+	for (request_t *req = done; NULL != req; req = req->qnext)
+	{
+		connection_t *conn = req->conn;
+		req->done = true;
+		conn->pending--;
+		if (conn->closed)
+		{
+			if (0 == conn->pending) bury_connection(conn);
+		}
+		else if (req == conn->head)
+		{
+			conn->next_ready = flush_list;
+			flush_list = conn;
+		}
+	}
+
+	connection_t *next;
+	for (connection_t *conn = flush_list; NULL != conn; conn = next)
+	{
+		next = conn->next_ready;
+		flush_connection(conn);
+	}
+}
+
+static int open_listen_socket(void)
+{
+	int fd;
+
+	if (NULL != config.socket_path)
+	{
+		struct sockaddr_un addr = { .sun_family = AF_UNIX };
+		if (strlen(config.socket_path) >= sizeof(addr.sun_path))
+		{
+			prt_error("Error: Socket path too long: %s\n", config.socket_path);
+			return -1;
+		}
+		strcpy(addr.sun_path, config.socket_path);
+		unlink(config.socket_path);
+
+		fd = socket(AF_UNIX, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0);
+		if ((fd < 0) || (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0))
+		{
+			perror(config.socket_path);
+			return -1;
+		}
+	}
+	else
+	{
+		struct sockaddr_in addr =
+		{
+			.sin_family = AF_INET,
+			.sin_port = htons(config.port),
+			.sin_addr.s_addr = htonl(INADDR_ANY),
+		};
+
+		fd = socket(AF_INET, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0);
+		int on = 1;
+		if ((fd < 0) ||
+		    (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0) ||
+		    (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0))
+		{
+			perror("bind");
+			return -1;
+		}
+	}
+
+	if (listen(fd, SOMAXCONN) < 0)
+	{
+		perror("listen");
+		return -1;
+	}
+	return fd;
+}
+
+static void on_signal(int sig)
+{
+	(void)sig;
+	stop_requested = 1;
+	wakeup_io_thread();
+}
+
+static void serve(void)
+{
+	static int listen_tag, event_tag; /* Their addresses tag epoll events */
+
+	struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &listen_tag };
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+	ev.data.ptr = &event_tag;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event_fd, &ev);
+
+	while (!stop_requested)
+	{
+		struct epoll_event events[MAX_EVENTS];
+		int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			perror("epoll_wait");
+			break;
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			void *tag = events[i].data.ptr;
+			if (tag == &listen_tag)
+			{
+				accept_connections();
+			}
+			else if (tag == &event_tag)
+			{
+				collect_responses();
+			}
+			else
+			{
+				connection_t *conn = tag;
+				if (conn->closed) continue;
+				if (events[i].events & (EPOLLHUP|EPOLLERR))
+				{
+					/* The peer is gone; the responses can't be sent. */
+					close_connection(conn);
+					continue;
+				}
+				if (events[i].events & EPOLLIN)
+					read_connection(conn);
+				if (!conn->closed && (events[i].events & EPOLLOUT))
+					flush_connection(conn);
+			}
+		}
+		free_dead_connections();
+	}
+}
+
+/* ======================================================== */
+
+static const char usage[] =
+"Usage: %s [options] [-p port | -s socket]\n"
+"Start a link-grammar parse server. Requests and responses are in the\n"
+"format of the Java LGService.\n"
+"\n"
+"  -l, --language=LANG     Language or dictionary directory (default \"en\").\n"
+"  -p, --port=PORT         Listen on this TCP port.\n"
+"  -s, --socket=PATH       Listen on this Unix-domain socket.\n"
+"  -t, --threads=N         Number of parsing threads (default: one per CPU).\n"
+"  -b, --batch=N           Most requests taken by a thread at a time (default 8).\n"
+"  -T, --max-parse-time=S  Default request deadline, in seconds (default 60).\n"
+"  -c, --cost-max=COST     Default maximum disjunct cost (default 2.7).\n"
+"  -v, --verbosity=N       Verbosity level.\n"
+"  -h, --help              Print this help and exit.\n"
+"      --version           Print the version and exit.\n";
+
+static const struct option long_options[] =
+{
+	{"language", required_argument, NULL, 'l'},
+	{"port", required_argument, NULL, 'p'},
+	{"socket", required_argument, NULL, 's'},
+	{"threads", required_argument, NULL, 't'},
+	{"batch", required_argument, NULL, 'b'},
+	{"max-parse-time", required_argument, NULL, 'T'},
+	{"cost-max", required_argument, NULL, 'c'},
+	{"verbosity", required_argument, NULL, 'v'},
+	{"help", no_argument, NULL, 'h'},
+	{"version", no_argument, NULL, 'V'},
+	{NULL, 0, NULL, 0}
+};
+
+int main(int argc, char *argv[])
+{
+	int c;
+	while (-1 != (c = getopt_long(argc, argv, "l:p:s:t:b:T:c:v:h",
+	                              long_options, NULL)))
+	{
+		switch (c)
+		{
+			case 'l': config.language = optarg; break;
+			case 'p': config.port = atoi(optarg); break;
+			case 's': config.socket_path = optarg; break;
+			case 't': config.num_threads = atoi(optarg); break;
+			case 'b': config.batch_size = atoi(optarg); break;
+			case 'T': config.max_parse_seconds = atof(optarg); break;
+			case 'c': config.max_cost = atof(optarg); break;
+			case 'v': verbosity = atoi(optarg); break;
+			case 'h': printf(usage, argv[0]); exit(EXIT_SUCCESS);
+			case 'V': printf("%s\n", linkgrammar_get_version()); exit(EXIT_SUCCESS);
+			default: fprintf(stderr, usage, argv[0]); exit(EXIT_FAILURE);
+		}
+	}
+
+	if ((optind < argc) || ((config.port < 0) == (NULL == config.socket_path)))
+	{
+		fprintf(stderr, usage, argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	if (0 == config.num_threads)
+	{
+		long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+		config.num_threads = (ncpu > 0) ? (unsigned int)ncpu : 1;
+	}
+	if (0 == config.batch_size) config.batch_size = 1;
+
+	dict = dictionary_create_lang(config.language);
+	if (NULL == dict)
+	{
+		prt_error("Fatal error: Unable to open the dictionary \"%s\".\n",
+		          config.language);
+		exit(EXIT_FAILURE);
+	}
+
+	listen_fd = open_listen_socket();
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	event_fd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+	if ((listen_fd < 0) || (epoll_fd < 0) || (event_fd < 0))
+	{
+		if (epoll_fd < 0) perror("epoll_create1");
+		if (event_fd < 0) perror("eventfd");
+		exit(EXIT_FAILURE);
+	}
+
+	struct sigaction sa = { .sa_handler = on_signal };
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	pthread_t *threads = malloc(config.num_threads * sizeof(pthread_t));
+	for (unsigned int i = 0; i < config.num_threads; i++)
+	{
+		if (0 != pthread_create(&threads[i], NULL, worker, NULL))
+		{
+			perror("pthread_create");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (verbosity > 0)
+	{
+		fprintf(stderr, "Listening on %s%s%.0d with %u threads\n",
+		        (NULL != config.socket_path) ? config.socket_path : "",
+		        (NULL != config.socket_path) ? "" : "port ",
+		        (NULL != config.socket_path) ? 0 : config.port,
+		        config.num_threads);
+	}
+
+	serve();
+
+	pthread_mutex_lock(&work_queue.lock);
+	work_queue.stop = true;
+	pthread_cond_broadcast(&work_queue.cond);
+	pthread_mutex_unlock(&work_queue.lock);
+	for (unsigned int i = 0; i < config.num_threads; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+
+	/* The requests that are still queued belong to their connections. */
+	while (NULL != connections)
+	{
+		if (!connections->closed) close(connections->fd);
+		free_connection(connections);
+	}
+
+	close(listen_fd);
+	if (NULL != config.socket_path) unlink(config.socket_path);
+	dictionary_delete(dict);
+	return EXIT_SUCCESS;
+}
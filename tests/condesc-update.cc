@@ -0,0 +1,135 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks the copy-on-write publishing of new connectors of a
+// dynamic dictionary (condesc_update() in connectors.c). A writer adds
+// connectors in batches, as the SQL and Atomese backends do after each
+// sentence lookup, while readers look up the published ones with no
+// lock (condesc_lookup()). Each lookup must find the
+// descriptor that the connector got when it was added, even while the
+// table is being compiled again and its old versions are freed.
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+extern "C" {
+#include "link-grammar/dict-common/dict-common.h"
+}
+#include "test-check.h"
+
+// Connectors come in groups of 3 that have the same UC part.
+#define GROUP_SIZE 3
+
+static std::string connector_name(size_t i)
+{
+	size_t g = i / GROUP_SIZE;
+	std::string s;
+	for (int d = 0; d < 4; d++, g /= 26)
+		s += (char)('A' + g % 26);
+	static const char *subscript[GROUP_SIZE] = { "", "a", "bc" };
+	return s + subscript[i % GROUP_SIZE];
+}
+
+// Look up random published connectors until the writer is done.
+static void lookup_connectors(ConTable *ct, const std::vector<const char*>* name,
+                              const std::atomic<size_t>* published,
+                              const std::atomic<bool>* done, int thread_id)
+{
+	unsigned int r = thread_id + 1;
+	size_t lookups = 0;
+
+	while (!*done || (0 == lookups))
+	{
+		size_t n = *published;
+		if (0 == n)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		r = r * 1103515245 + 12345;
+		size_t i = (r >> 8) % n;
+		const condesc_t *desc = condesc_lookup(ct, (*name)[i]);
+		lookups++;
+
+		check((NULL != desc) && (desc->more->string == (*name)[i]),
+		      "a published connector is found");
+		if (NULL == desc) continue;
+		check(desc->con_num == i, "its con_num is kept");
+		check(desc->uc_num == i / GROUP_SIZE, "its uc_num is kept");
+	}
+}
+
+int main()
+{
+	const size_t num_connectors = 60000;
+	const size_t batch_size = 500;
+	const int num_threads = 3;
+
+	struct Dictionary_s dict;
+	memset(&dict, 0, sizeof(dict));
+	dict.name = "condesc-update";
+	dict.string_set = string_set_create();
+	condesc_init(&dict, 256);
+	ConTable *ct = &dict.contable;
+
+	// The connector strings are interned before they are used.
+	std::vector<const char*> name;
+	for (size_t i = 0; i < num_connectors; i++)
+		name.push_back(string_set_add(connector_name(i).c_str(), dict.string_set));
+
+	std::atomic<size_t> published(0);
+	std::atomic<bool> done(false);
+	std::vector<std::thread> readers;
+	for (int t = 0; t < num_threads; t++)
+		readers.push_back(std::thread(lookup_connectors, ct, &name,
+		                              &published, &done, t));
+
+	for (size_t n = 0; n < num_connectors; n += batch_size)
+	{
+		for (size_t i = n; i < n + batch_size; i++)
+		{
+			condesc_t *desc = condesc_add(ct, name[i]);
+			check((NULL != desc) && (desc->con_num == i),
+			      "a new connector gets the next con_num");
+		}
+		condesc_update(&dict);
+		published = n + batch_size;
+	}
+	done = true;
+	for (std::thread& t : readers) t.join();
+
+	printf("%zu connectors published in %u versions\n", ct->num_con, ct->version);
+	check(num_connectors == ct->num_con, "all the connectors are added");
+	check(num_connectors / batch_size == ct->version, "a version per batch");
+	check(num_connectors / GROUP_SIZE == ct->num_uc,
+	      "a uc_num per different UC part");
+
+	for (size_t i = 0; i < num_connectors; i++)
+	{
+		const condesc_t *desc = condesc_lookup(ct, name[i]);
+		check((NULL != desc) && (desc->con_num == i) &&
+		      (desc->uc_num == i / GROUP_SIZE), "the final table");
+	}
+
+	// Adding a published connector returns it.
+	check(condesc_lookup(ct, name[0]) == condesc_add(ct, name[0]),
+	      "a published connector is not added again");
+	check(num_connectors == ct->num_con, "no connector is added again");
+
+	condesc_delete(&dict);
+	string_set_delete(dict.string_set);
+
+	return check_status();
+}
@@ -0,0 +1,156 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks the sentence segmentation of documents (document_*()).
+
+#include <locale.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "link-grammar/link-includes.h"
+#include "test-check.h"
+
+// Segment the text, feeding it in chunks of the given size, and check
+// that each sentence is at its reported offset in the text.
+static std::vector<std::string> segment(Dictionary dict,
+                                        const std::string &text, size_t chunk)
+{
+	std::vector<std::string> sentences;
+	Document doc = document_create(dict);
+
+	size_t fed = 0;
+	bool ended = false;
+	while (true)
+	{
+		size_t offset, length;
+		const char *s = document_next_sentence(doc, &offset, &length);
+		if (NULL != s)
+		{
+			check(text.compare(offset, length, s) == 0,
+			      "sentence is at its offset");
+			sentences.push_back(s);
+			continue;
+		}
+		if (ended) break;
+
+		if (fed < text.size())
+		{
+			size_t n = std::min(chunk, text.size() - fed);
+			document_feed(doc, text.data() + fed, n);
+			fed += n;
+		}
+		else
+		{
+			document_end(doc);
+			ended = true;
+		}
+	}
+
+	document_delete(doc);
+	return sentences;
+}
+
+// Check the segmentation of the text, fed at once and byte by byte.
+static void check_segments(Dictionary dict, const char *what,
+                           const std::string &text,
+                           const std::vector<std::string> &expected)
+{
+	for (size_t chunk : { text.size(), (size_t)1 })
+	{
+		std::vector<std::string> got = segment(dict, text, chunk);
+		bool ok = (got == expected);
+		if (!ok)
+		{
+			printf("%s (chunk %zu):\n", what, chunk);
+			for (const std::string &s : got)
+				printf("   [%s]\n", s.c_str());
+		}
+		check(ok, what);
+	}
+}
+
+int main()
+{
+	setlocale(LC_ALL, "en_US.UTF-8");
+
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		printf("Fatal error: Unable to open the dictionary\n");
+		return 1;
+	}
+
+	check_segments(dict, "simple",
+		"This is a test.  Is it? Yes!\nIt is", {
+		"This is a test.", "Is it?", "Yes!", "It is" });
+
+	check_segments(dict, "empty lines",
+		"A title\n\nThe text\ngoes on.\n \nThe end", {
+		"A title", "The text\ngoes on.", "The end" });
+
+	check_segments(dict, "abbreviations",
+		"Mr. Smith met Dr. Jones. J. R. R. Tolkien came too. "
+		"They ate e.g. apples, pears etc. and the U.S. Army came. "
+		"It ended at 5 p.m. today.", {
+		"Mr. Smith met Dr. Jones.", "J. R. R. Tolkien came too.",
+		"They ate e.g. apples, pears etc. and the U.S. Army came.",
+		"It ended at 5 p.m. today." });
+
+	check_segments(dict, "lower-case continuation",
+		"He said wait... and then left. OK.", {
+		"He said wait... and then left.", "OK." });
+
+	check_segments(dict, "closers",
+		"He said \"Stop!\" Then he left. (It was late.) "
+		"She said \xe2\x80\x9cNo.\xe2\x80\x9d He agreed.", {
+		"He said \"Stop!\"", "Then he left.", "(It was late.)",
+		"She said \xe2\x80\x9cNo.\xe2\x80\x9d", "He agreed." });
+
+	check_segments(dict, "full-width marks",
+		"\xe6\x88\x91\xe6\x98\xaf\xe5\xad\xa6\xe7\x94\x9f\xe3\x80\x82"
+		"\xe4\xbd\xa0\xe5\xa5\xbd\xef\xbc\x9f\xe5\xa5\xbd\xef\xbc\x81", {
+		"\xe6\x88\x91\xe6\x98\xaf\xe5\xad\xa6\xe7\x94\x9f\xe3\x80\x82",
+		"\xe4\xbd\xa0\xe5\xa5\xbd\xef\xbc\x9f",
+		"\xe5\xa5\xbd\xef\xbc\x81" });
+
+	// A sentence longer than 16 KB is cut at a blank.
+	std::string words;
+	while (words.size() < 20000) words += "word ";
+	words += "end.";
+	std::vector<std::string> cut = segment(dict, words, words.size());
+	check(cut.size() == 2, "an overlong sentence is cut in two");
+	if (cut.size() == 2)
+	{
+		check(cut[0].size() <= 16384, "the first part is not too long");
+		check(cut[0] + " " + cut[1] == words, "it is cut at a blank");
+	}
+
+	// A long run of invalid UTF-8 is cut too, and no byte is lost.
+	std::string invalid = "Hello there.\n" + std::string(20000, '\x80');
+	for (size_t chunk : { invalid.size(), (size_t)4096 })
+	{
+		std::vector<std::string> parts = segment(dict, invalid, chunk);
+		check(!parts.empty() && (parts[0] == "Hello there."),
+		      "a sentence before invalid UTF-8");
+		size_t total = 0;
+		for (size_t i = 1; i < parts.size(); i++)
+		{
+			check(parts[i].size() <= 16384, "invalid UTF-8 is cut");
+			total += parts[i].size();
+		}
+		check(total == 20000, "all the invalid UTF-8 is returned");
+	}
+
+	dictionary_delete(dict);
+
+	return check_status();
+}
@@ -0,0 +1,182 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks the packed parse forest (sentence_get_forest()): its
+// structure, its linkage count, and a dynamic program over it.
+
+#include <limits.h>
+#include <locale.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "link-grammar/link-includes.h"
+#include "test-check.h"
+
+static const char *sentences[] =
+{
+	"The cat sat on the mat.",
+	"I saw the man with the telescope.",
+	"He is the kind of person who would do that.",
+	"Where did you put the book that I gave you?",
+	"It was raining, so we stayed at home.",
+	// These have null words.
+	"Thieves the the stole paintings.",
+	"This is a test of of the forest.",
+	"He said that that that that was wrong.",
+};
+
+// Check the forest of a parsed sentence, and return the lowest cost of
+// its linkages, computed by a dynamic program over it.
+static double check_forest(Sentence sent, Forest forest)
+{
+	size_t num_nodes = forest_num_nodes(forest);
+	size_t num_choices = forest_num_choices(forest);
+	size_t num_disjuncts = forest_num_disjuncts(forest);
+	const lg_forest_node *node = forest_get_nodes(forest);
+	const lg_forest_choice *choice = forest_get_choices(forest);
+
+	check(0 < num_nodes, "the forest has nodes");
+	if (0 == num_nodes) return 0;
+
+	std::vector<double> min_cost(num_nodes);
+	for (size_t n = 0; n < num_nodes; n++)
+	{
+		const lg_forest_node *fn = &node[n];
+		check(fn->first_choice + fn->num_choices <= num_choices,
+		      "the choices of a node are in the choice array");
+		if (0 == fn->num_choices)
+		{
+			min_cost[n] = 0;
+			continue;
+		}
+
+		long long count = 0;
+		min_cost[n] = INFINITY;
+		for (unsigned int c = 0; c < fn->num_choices; c++)
+		{
+			const lg_forest_choice *fc = &choice[fn->first_choice + c];
+			check((fc->child[0] < n) && (fc->child[1] < n),
+			      "the children come first");
+			check((fc->disjunct < num_disjuncts) ||
+			      ((LG_FOREST_NULL_WORD == fc->disjunct) && (0 == fc->links)),
+			      "a valid disjunct index");
+			check((fn->lw < fc->word) && (fc->word < fn->rw),
+			      "the word of a choice is inside its node");
+			if ((fc->child[0] >= n) || (fc->child[1] >= n)) continue;
+
+			const lg_forest_node *l = &node[fc->child[0]];
+			const lg_forest_node *r = &node[fc->child[1]];
+			check((l->lw == fn->lw) && (l->rw == fc->word) &&
+			      (r->lw == fc->word) && (r->rw == fn->rw),
+			      "the children split the word range at the choice word");
+
+			// A choice without links skips a null word or starts an
+			// island, which the root pays for in advance.
+			int null_count = l->null_count + r->null_count +
+				((0 == fc->links) && (-1 != fn->lw) ? 1 : 0);
+			check(null_count == fn->null_count,
+			      "the null count of a node is that of its choices");
+
+			count += (long long)l->count * r->count;
+			if (count > INT_MAX) count = INT_MAX;
+
+			double cost = min_cost[fc->child[0]] + min_cost[fc->child[1]];
+			if (LG_FOREST_NULL_WORD != fc->disjunct)
+				cost += forest_get_disjunct_cost(forest, fc->disjunct);
+			if ((0 < l->count) && (0 < r->count) && (cost < min_cost[n]))
+				min_cost[n] = cost;
+		}
+		check(count == fn->count,
+		      "a node count is the sum of its choice counts");
+	}
+
+	const lg_forest_node *root = &node[num_nodes - 1];
+	check(-1 == root->lw, "the root starts before the wall");
+	check(root->count == sentence_num_linkages_found(sent),
+	      "the root count is the number of linkages found");
+	check(root->null_count == sentence_null_count(sent),
+	      "the root null count is the sentence null count");
+
+	for (size_t d = 0; d < num_disjuncts; d++)
+		check(NULL != forest_get_disjunct_str(forest, d), "a disjunct string");
+
+	return min_cost[num_nodes - 1];
+}
+
+int main()
+{
+	setlocale(LC_ALL, "en_US.UTF-8");
+
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		printf("Fatal error: Unable to open the dictionary\n");
+		return 1;
+	}
+
+	Parse_Options opts = parse_options_create();
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_verbosity(opts, 0);
+	parse_options_set_max_null_count(opts, 3);
+	parse_options_set_linkage_limit(opts, 10000);
+
+	// Not kept by default.
+	Sentence sent = sentence_create(sentences[0], dict);
+	sentence_parse(sent, opts);
+	check(NULL == sentence_get_forest(sent), "no forest by default");
+	sentence_delete(sent);
+
+	parse_options_set_keep_forest(opts, true);
+	for (bool islands : {false, true})
+	for (const char *str : sentences)
+	{
+		parse_options_set_islands_ok(opts, islands);
+		sent = sentence_create(str, dict);
+		sentence_parse(sent, opts);
+		Forest forest = sentence_get_forest(sent);
+		check(NULL != forest, "the forest is kept");
+		if (NULL == forest)
+		{
+			sentence_delete(sent);
+			continue;
+		}
+
+		double forest_cost = check_forest(sent, forest);
+
+		// All the linkages are extracted, so the lowest cost of the
+		// forest is the lowest cost of a linkage.
+		int num = sentence_num_linkages_post_processed(sent);
+		check(num == sentence_num_linkages_found(sent),
+		      "all the linkages are extracted");
+		double linkage_cost = INFINITY;
+		for (int i = 0; i < num; i++)
+		{
+			Linkage linkage = linkage_create(i, sent, opts);
+			if (NULL == linkage) continue;
+			if (linkage_disjunct_cost(linkage) < linkage_cost)
+				linkage_cost = linkage_disjunct_cost(linkage);
+			linkage_delete(linkage);
+		}
+		printf("%s%s: %d linkages, null count %d, %zu nodes, lowest cost %.3f\n",
+		       islands ? "(islands) " : "", str,
+		       sentence_num_linkages_found(sent), sentence_null_count(sent),
+		       forest_num_nodes(forest), forest_cost);
+		check(fabs(forest_cost - linkage_cost) < 1e-4,
+		      "the lowest cost of the forest is that of the linkages");
+
+		sentence_delete(sent);
+	}
+
+	parse_options_delete(opts);
+	dictionary_delete(dict);
+
+	return check_status();
+}
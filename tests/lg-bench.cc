@@ -0,0 +1,540 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// A reproducible benchmark over the bundled corpora.
+//
+// A fixed set of sentences (the first N of each corpus file, plus
+// synthetic long sentences) is parsed the same way link-parser does it
+// in batch mode. Per-stage time percentiles, sentences/sec, peak RSS and
+// memo statistics are written as JSON. Two such JSON files (e.g. from
+// two builds) can then be compared with "lg-bench -c base.json new.json".
+//
+// Run "make bench" in the tests directory, or see usage() below.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "link-grammar/link-includes.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+struct Stage
+{
+	std::vector<double> ms;
+};
+
+// The measured stages of a sentence. "parse" includes the reparse with
+// null links, if there is no complete linkage.
+enum { ST_SPLIT, ST_PARSE, ST_LINKAGE, ST_TOTAL, ST_NUM };
+static const char *stage_name[ST_NUM] = { "split", "parse", "linkage", "total" };
+
+struct Corpus
+{
+	std::string name;      // lang:file
+	std::string lang;
+	std::vector<std::string> sentences;
+	Stage stage[ST_NUM];
+	size_t parsed = 0;     // Sentences with linkages (all repeats)
+	double seconds = 0;    // Per pass over the sentences
+};
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+	   "Usage: %s [-d data-dir] [-n max-sentences] [-r repeats] [-w warmups]\n"
+	   "          [-t timeout] [-o out.json] [lang:corpus-file ...]\n"
+	   "       %s -c base.json new.json [-x percent]\n\n"
+	   "The corpus \"lang:synthetic\" denotes long sentences made by\n"
+	   "joining sentences of lang:corpus-basic.batch.\n"
+	   "With -c, report the differences, and exit with status 1 if the\n"
+	   "overall time, throughput or peak RSS got worse by more than\n"
+	   "-x percent (default 10).\n", prog, prog);
+	exit(2);
+}
+
+/* ======================================================== */
+// Corpus reading.
+
+static bool read_corpus_file(const std::string &path, size_t max,
+                             std::vector<std::string> &out, bool good_only)
+{
+	std::ifstream in(path);
+	if (!in) return false;
+
+	std::string line;
+	while ((out.size() < max) && std::getline(in, line))
+	{
+		if (!line.empty() && (line.back() == '\r')) line.pop_back();
+		if (line.empty()) continue;
+
+		// Comments and link-parser commands.
+		if ((line[0] == '%') || (line[0] == '!')) continue;
+
+		// Sentences that are expected to fail.
+		if (line[0] == '*')
+		{
+			if (good_only) continue;
+			line.erase(0, 1);
+		}
+		out.push_back(line);
+	}
+	return true;
+}
+
+// Join groups of short sentences into long ones. This is deterministic,
+// so the same sentences are used in every run.
+static void make_synthetic(const std::vector<std::string> &src, size_t max,
+                           std::vector<std::string> &out)
+{
+	const size_t group = 3;
+	for (size_t i = 0; (i + group <= src.size()) && (out.size() < max); i += group)
+	{
+		std::string s;
+		for (size_t j = 0; j < group; j++)
+		{
+			std::string part = src[i+j];
+			while (!part.empty() && strchr(".?! ", part.back())) part.pop_back();
+			if (j > 0) s += (j == group-1) ? ", and " : ", ";
+			s += part;
+		}
+		out.push_back(s + ".");
+	}
+}
+
+/* ======================================================== */
+// Benchmarking.
+
+static double ms_since(bench_clock::time_point t0, bench_clock::time_point t1)
+{
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static void parse_one(Dictionary dict, Parse_Options opts, const std::string &str,
+                      Corpus *c)
+{
+	auto t0 = bench_clock::now();
+
+	Sentence sent = sentence_create(str.c_str(), dict);
+	parse_options_set_min_null_count(opts, 0);
+	parse_options_set_max_null_count(opts, 0);
+	parse_options_reset_resources(opts);
+	int rc = sentence_split(sent, opts);
+	auto t1 = bench_clock::now();
+
+	int num_linkages = 0;
+	if (0 == rc)
+	{
+		num_linkages = sentence_parse(sent, opts);
+		if ((0 == num_linkages) && !parse_options_resources_exhausted(opts))
+		{
+			parse_options_set_min_null_count(opts, 1);
+			parse_options_set_max_null_count(opts, sentence_length(sent));
+			num_linkages = sentence_parse(sent, opts);
+		}
+	}
+	auto t2 = bench_clock::now();
+
+	if (num_linkages > 0)
+	{
+		Linkage linkage = linkage_create(0, sent, opts);
+		if (linkage != NULL)
+		{
+			char *diagram = linkage_print_diagram(linkage, true, 80);
+			linkage_free_diagram(diagram);
+			linkage_delete(linkage);
+		}
+	}
+	sentence_delete(sent);
+	auto t3 = bench_clock::now();
+
+	if (NULL == c) return; // Warm-up run.
+
+	c->stage[ST_SPLIT].ms.push_back(ms_since(t0, t1));
+	c->stage[ST_PARSE].ms.push_back(ms_since(t1, t2));
+	c->stage[ST_LINKAGE].ms.push_back(ms_since(t2, t3));
+	c->stage[ST_TOTAL].ms.push_back(ms_since(t0, t3));
+	if (num_linkages > 0) c->parsed++;
+}
+
+static double percentile(const std::vector<double> &sorted, double p)
+{
+	if (sorted.empty()) return 0;
+	size_t rank = (size_t)(p / 100 * sorted.size() + 0.5);
+	if (rank < 1) rank = 1;
+	if (rank > sorted.size()) rank = sorted.size();
+	return sorted[rank - 1];
+}
+
+static long peak_rss_kb(void)
+{
+	struct rusage u;
+	if (0 != getrusage(RUSAGE_SELF, &u)) return 0;
+#if defined __APPLE__
+	return u.ru_maxrss / 1024;
+#else
+	return u.ru_maxrss;
+#endif
+}
+
+/* ======================================================== */
+// JSON output.
+
+static std::string json_str(const std::string &s)
+{
+	std::string r = "\"";
+	for (char c : s)
+	{
+		if ((c == '"') || (c == '\\')) r += '\\';
+		r += c;
+	}
+	return r + "\"";
+}
+
+static void write_stage(FILE *f, const char *name, const Stage &st,
+                        int repeats, bool last)
+{
+	std::vector<double> v = st.ms;
+	std::sort(v.begin(), v.end());
+	double sum = 0;
+	for (double x : v) sum += x;
+
+	fprintf(f, "        \"%s\": {\"p50_ms\": %.4f, \"p90_ms\": %.4f, "
+	        "\"p99_ms\": %.4f, \"max_ms\": %.4f, \"total_ms\": %.3f}%s\n",
+	        name, percentile(v, 50), percentile(v, 90), percentile(v, 99),
+	        v.empty() ? 0 : v.back(), sum / repeats, last ? "" : ",");
+}
+
+static void write_json(FILE *f, const std::vector<Corpus> &corpora,
+                       const std::map<std::string, Dictionary> &dicts,
+                       int max_sentences, int repeats, int warmups, int timeout)
+{
+	size_t total_sentences = 0;
+	double total_seconds = 0;
+
+	fprintf(f, "{\n");
+	fprintf(f, "  \"version\": %s,\n", json_str(linkgrammar_get_version()).c_str());
+	fprintf(f, "  \"options\": {\"max_sentences\": %d, \"repeats\": %d, "
+	        "\"warmups\": %d, \"timeout\": %d},\n",
+	        max_sentences, repeats, warmups, timeout);
+	fprintf(f, "  \"corpora\": {\n");
+	for (size_t i = 0; i < corpora.size(); i++)
+	{
+		const Corpus &c = corpora[i];
+		size_t n = c.sentences.size();
+		total_sentences += n;
+		total_seconds += c.seconds;
+
+		fprintf(f, "    %s: {\n", json_str(c.name).c_str());
+		fprintf(f, "      \"sentences\": %zu,\n", n);
+		fprintf(f, "      \"parsed\": %zu,\n", c.parsed / repeats);
+		fprintf(f, "      \"seconds\": %.3f,\n", c.seconds);
+		fprintf(f, "      \"sentences_per_sec\": %.2f,\n",
+		        (c.seconds > 0) ? n / c.seconds : 0);
+		fprintf(f, "      \"stages\": {\n");
+		for (int s = 0; s < ST_NUM; s++)
+			write_stage(f, stage_name[s], c.stage[s], repeats, s == ST_NUM-1);
+		fprintf(f, "      }\n");
+		fprintf(f, "    }%s\n", (i == corpora.size()-1) ? "" : ",");
+	}
+	fprintf(f, "  },\n");
+
+	fprintf(f, "  \"memo\": {\n");
+	size_t i = 0;
+	for (const auto &d : dicts)
+	{
+		fprintf(f, "    %s: {\"token_memo_hits\": %zu, \"token_memo_misses\": %zu, "
+		        "\"result_cache_hits\": %zu, \"result_cache_misses\": %zu}%s\n",
+		        json_str(d.first).c_str(),
+		        dictionary_get_token_memo_hits(d.second),
+		        dictionary_get_token_memo_misses(d.second),
+		        dictionary_get_result_cache_hits(d.second),
+		        dictionary_get_result_cache_misses(d.second),
+		        (++i == dicts.size()) ? "" : ",");
+	}
+	fprintf(f, "  },\n");
+
+	fprintf(f, "  \"total\": {\"sentences\": %zu, \"seconds\": %.3f, "
+	        "\"sentences_per_sec\": %.2f},\n", total_sentences, total_seconds,
+	        (total_seconds > 0) ? total_sentences / total_seconds : 0);
+	fprintf(f, "  \"peak_rss_kb\": %ld\n", peak_rss_kb());
+	fprintf(f, "}\n");
+}
+
+/* ======================================================== */
+// Comparing two results. A minimal JSON reader, for what is written
+// above: nested objects with numeric or string leaves.
+
+typedef std::map<std::string, double> Metrics;
+
+static void skip_ws(const char *&p)
+{
+	while ((*p == ' ') || (*p == '\n') || (*p == '\r') || (*p == '\t')) p++;
+}
+
+static bool read_string(const char *&p, std::string &s)
+{
+	if (*p++ != '"') return false;
+	for (; *p && (*p != '"'); p++)
+	{
+		if ((*p == '\\') && p[1]) p++;
+		s += *p;
+	}
+	if (*p++ != '"') return false;
+	return true;
+}
+
+static bool read_value(const char *&p, const std::string &path, Metrics &m)
+{
+	skip_ws(p);
+	if (*p == '"')
+	{
+		std::string ignored;
+		return read_string(p, ignored);
+	}
+	if (*p != '{')
+	{
+		char *end;
+		double v = strtod(p, &end);
+		if (end == p) return false;
+		m[path] = v;
+		p = end;
+		return true;
+	}
+
+	p++;
+	for (;;)
+	{
+		skip_ws(p);
+		if (*p == '}') { p++; return true; }
+		std::string key;
+		if (!read_string(p, key)) return false;
+		skip_ws(p);
+		if (*p++ != ':') return false;
+		if (!read_value(p, path.empty() ? key : path + "/" + key, m)) return false;
+		skip_ws(p);
+		if (*p == ',') p++;
+	}
+}
+
+static bool read_metrics(const char *file, Metrics &m)
+{
+	std::ifstream in(file);
+	if (!in)
+	{
+		fprintf(stderr, "Error: Cannot open %s\n", file);
+		return false;
+	}
+	std::string text((std::istreambuf_iterator<char>(in)),
+	                 std::istreambuf_iterator<char>());
+	const char *p = text.c_str();
+	if (!read_value(p, "", m))
+	{
+		fprintf(stderr, "Error: %s: Invalid benchmark file\n", file);
+		return false;
+	}
+	return true;
+}
+
+static bool ends_with(const std::string &s, const char *suffix)
+{
+	size_t n = strlen(suffix);
+	return (s.size() >= n) && (0 == s.compare(s.size() - n, n, suffix));
+}
+
+static int compare(const char *base_file, const char *new_file, double threshold)
+{
+	Metrics base, cur;
+	if (!read_metrics(base_file, base) || !read_metrics(new_file, cur)) return 2;
+
+	int regressions = 0;
+	printf("%-60s %12s %12s %8s\n", "metric", "base", "new", "change");
+	for (const auto &b : base)
+	{
+		const std::string &key = b.first;
+		auto n = cur.find(key);
+		if (n == cur.end()) continue;
+
+		bool higher_is_better = ends_with(key, "sentences_per_sec");
+		bool is_time = ends_with(key, "_ms") || ends_with(key, "/seconds");
+		if (!higher_is_better && !is_time && !ends_with(key, "peak_rss_kb"))
+			continue;
+
+		double change = (b.second != 0) ? 100 * (n->second - b.second) / b.second : 0;
+		if (higher_is_better) change = -change;
+
+		// Only the overall figures are stable enough to fail on; small
+		// corpora take a few milliseconds and are noisy.
+		bool checked = (0 == key.compare(0, 6, "total/")) ||
+		               (key == "peak_rss_kb");
+		bool worse = checked && (change > threshold);
+		if (worse) regressions++;
+
+		printf("%-60s %12.3f %12.3f %+7.1f%%%s\n", key.c_str(), b.second,
+		       n->second, higher_is_better ? -change : change,
+		       worse ? "  REGRESSION" : "");
+	}
+
+	if (regressions > 0)
+	{
+		printf("%d regression%s above %.1f%%\n", regressions,
+		       (regressions > 1) ? "s" : "", threshold);
+		return 1;
+	}
+	return 0;
+}
+
+/* ======================================================== */
+
+int main(int argc, char *argv[])
+{
+	const char *data_dir = DICTIONARY_DIR "/data";
+	const char *out_file = NULL;
+	const char *compare_base = NULL;
+	int max_sentences = 200;
+	int repeats = 3;
+	int warmups = 1;
+	int timeout = 30;
+	double threshold = 10;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "c:d:n:o:r:t:w:x:h")) != -1)
+	{
+		switch (opt)
+		{
+			case 'c': compare_base = optarg; break;
+			case 'd': data_dir = optarg; break;
+			case 'n': max_sentences = atoi(optarg); break;
+			case 'o': out_file = optarg; break;
+			case 'r': repeats = atoi(optarg); break;
+			case 't': timeout = atoi(optarg); break;
+			case 'w': warmups = atoi(optarg); break;
+			case 'x': threshold = atof(optarg); break;
+			default: usage(argv[0]);
+		}
+	}
+
+	if (NULL != compare_base)
+	{
+		if (optind != argc - 1) usage(argv[0]);
+		return compare(compare_base, argv[optind], threshold);
+	}
+	if ((max_sentences <= 0) || (repeats <= 0) || (warmups < 0)) usage(argv[0]);
+
+	std::vector<std::string> specs;
+	for (int i = optind; i < argc; i++) specs.push_back(argv[i]);
+	if (specs.empty())
+	{
+		specs = { "en:corpus-basic.batch", "en:corpus-fixes.batch",
+		          "en:synthetic", "ru:corpus-basic.batch",
+		          "de:corpus-basic.batch", "lt:corpus-basic.batch",
+		          "he:corpus-basic.batch" };
+	}
+
+	setlocale(LC_ALL, "en_US.UTF-8");
+	dictionary_set_data_dir(data_dir);
+
+	Parse_Options opts = parse_options_create();
+	parse_options_set_verbosity(opts, 0);
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_linkage_limit(opts, 1000);
+	parse_options_set_max_parse_time(opts, timeout);
+
+	std::vector<Corpus> corpora;
+	std::map<std::string, Dictionary> dicts;
+	for (const std::string &spec : specs)
+	{
+		size_t colon = spec.find(':');
+		if ((colon == std::string::npos) || (colon == 0)) usage(argv[0]);
+
+		corpora.emplace_back();
+		Corpus &c = corpora.back();
+		c.name = spec;
+		c.lang = spec.substr(0, colon);
+		std::string file = spec.substr(colon + 1);
+		std::string dir = std::string(data_dir) + "/" + c.lang + "/";
+
+		bool ok;
+		if (file == "synthetic")
+		{
+			std::vector<std::string> src;
+			// Long sentences are slow; use fewer of them.
+			size_t n = (max_sentences + 9) / 10;
+			ok = read_corpus_file(dir + "corpus-basic.batch", 3 * n,
+			                      src, /*good_only*/true);
+			make_synthetic(src, n, c.sentences);
+		}
+		else
+		{
+			ok = read_corpus_file(dir + file, max_sentences, c.sentences,
+			                      /*good_only*/false);
+		}
+		if (!ok || c.sentences.empty())
+		{
+			fprintf(stderr, "Error: No sentences in %s\n", spec.c_str());
+			return 1;
+		}
+
+		if (dicts.find(c.lang) == dicts.end())
+		{
+			Dictionary dict = dictionary_create_lang(c.lang.c_str());
+			if (NULL == dict)
+			{
+				fprintf(stderr, "Error: Unable to open the \"%s\" dictionary\n",
+				        c.lang.c_str());
+				return 1;
+			}
+			dicts[c.lang] = dict;
+		}
+	}
+
+	for (Corpus &c : corpora)
+	{
+		Dictionary dict = dicts[c.lang];
+		fprintf(stderr, "%s: %zu sentences\n", c.name.c_str(), c.sentences.size());
+
+		for (int w = 0; w < warmups; w++)
+			for (const std::string &s : c.sentences)
+				parse_one(dict, opts, s, NULL);
+
+		auto t0 = bench_clock::now();
+		for (int r = 0; r < repeats; r++)
+			for (const std::string &s : c.sentences)
+				parse_one(dict, opts, s, &c);
+		c.seconds = ms_since(t0, bench_clock::now()) / 1000 / repeats;
+	}
+
+	FILE *f = stdout;
+	if (NULL != out_file)
+	{
+		f = fopen(out_file, "w");
+		if (NULL == f)
+		{
+			fprintf(stderr, "Error: Cannot write %s\n", out_file);
+			return 1;
+		}
+	}
+	write_json(f, corpora, dicts, max_sentences, repeats, warmups, timeout);
+	if (f != stdout) fclose(f);
+
+	for (const auto &d : dicts) dictionary_delete(d.second);
+	parse_options_delete(opts);
+	return 0;
+}
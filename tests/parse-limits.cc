@@ -0,0 +1,346 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks how a parse behaves when it runs out of its resources,
+// and when its linkage count overflows.
+
+#include <locale.h>
+#include <stdio.h>
+#include <time.h>
+#include <thread>
+#include <vector>
+#include "link-grammar/link-includes.h"
+#include "test-check.h"
+
+// A long sentence with many prepositional phrases, and hence tens of
+// millions of linkages. Its parse time is spent mostly in
+// post-processing the linkages.
+static const char *pp_sentence =
+	"The man saw the dog with the telescope in the park on the hill near "
+	"the river by the bridge under the tree beside the house with the red "
+	"roof behind the school next to the church.";
+
+// Garbled text, which is parsed only with 3 null words. Trying null
+// counts 0 to 4 takes more than 15 CPU seconds.
+static const char *hard_sentence =
+	"Christmas in well, so be everybody choked put over gifts and too "
+	"they don't be everything, hungry and we should up forget the innocent "
+	"people that was not Day, jail, yfhP strength the in The order of gerE "
+	"> cotD > yfhP P2 > was P1 and At last the infantry were ready, and "
+	"went off the cavalry to the right .";
+
+static const char *easy_sentence = "The cat sat on the mat.";
+
+// A long sentence that the SAT parser takes tens of seconds to solve.
+static const char *sat_sentence =
+	"The dog that chased the cat that saw the rat ran away and the dog "
+	"that chased the cat that saw the rat ran away and the dog that chased "
+	"the cat that saw the rat ran away and the dog that chased the cat that "
+	"saw the rat ran away and it slept.";
+
+static double wall_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Check that the linkages of the sentence are complete, i.e. that each
+// one can be extracted and has no unlinked words.
+static void check_linkages(Sentence sent, Parse_Options opts, int num)
+{
+	for (int i = 0; i < num; i++)
+	{
+		Linkage linkage = linkage_create(i, sent, opts);
+		check(NULL != linkage, "linkage can be extracted");
+		if (NULL == linkage) continue;
+
+		int num_words = (int)linkage_get_num_words(linkage);
+		int num_links = (int)linkage_get_num_links(linkage);
+		std::vector<bool> linked(num_words, false);
+		for (int l = 0; l < num_links; l++)
+		{
+			linked[linkage_get_link_lword(linkage, l)] = true;
+			linked[linkage_get_link_rword(linkage, l)] = true;
+		}
+		for (int w = 0; w < num_words; w++)
+			check(linked[w], "all the words are linked");
+		linkage_delete(linkage);
+	}
+}
+
+// When a parse runs out of time while post-processing, it finds no
+// linkages, unless it is an "anytime" parse, which returns the linkages
+// processed so far. The time limit is set to half of the time of a full
+// parse, so that it usually expires while post-processing. Whether it
+// does depends on the timing, so only the results that are possible
+// either way are checked: a parse that returns fewer linkages than a
+// full one must have been interrupted, and the linkages it returns are
+// complete.
+static void test_anytime(Dictionary dict, Parse_Options opts)
+{
+	parse_options_set_linkage_limit(opts, 10000);
+
+	Sentence sent = sentence_create(pp_sentence, dict);
+	double start = wall_time();
+	int full = sentence_parse(sent, opts);
+	double secs = wall_time() - start;
+	sentence_delete(sent);
+	printf("Full parse: %d linkages in %.2f seconds\n", full, secs);
+	check(1000 < full, "the sentence has many valid linkages");
+
+	for (int anytime = 0; anytime <= 1; anytime++)
+	{
+		parse_options_set_anytime(opts, anytime);
+		parse_options_set_deadline(opts, secs / 2);
+
+		sent = sentence_create(pp_sentence, dict);
+		int num = sentence_parse(sent, opts);
+		bool interrupted = parse_options_resources_exhausted(opts);
+		printf("anytime=%d: %d linkages%s\n", anytime, num,
+		       interrupted ? " (interrupted)" : "");
+
+		if (num < full)
+			check(interrupted, "fewer linkages only when interrupted");
+		if (anytime)
+		{
+			check((0 <= num) && (num <= full),
+			      "an anytime parse returns at most the full linkages");
+			check_linkages(sent, opts, num);
+		}
+		else
+		{
+			check((0 == num) || (full == num),
+			      "no linkages or all of them");
+		}
+		sentence_delete(sent);
+	}
+
+	parse_options_set_anytime(opts, false);
+	parse_options_set_deadline(opts, 0);
+	parse_options_set_linkage_limit(opts, 100);
+}
+
+// Parse the sentence, and return the number of linkages. Its wall-clock
+// parse time is returned in secs.
+static int timed_parse(Dictionary dict, Parse_Options opts, const char *str,
+                       double *secs)
+{
+	Sentence sent = sentence_create(str, dict);
+	double start = wall_time();
+	int num = sentence_parse(sent, opts);
+	*secs = wall_time() - start;
+	sentence_delete(sent);
+
+	return num;
+}
+
+// A parse stops soon after its deadline, and the next parse, with no
+// deadline, is not affected.
+static void test_deadline(Dictionary dict, Parse_Options opts)
+{
+	double secs;
+
+	parse_options_set_max_null_count(opts, 4);
+	parse_options_set_deadline(opts, 0.5);
+	int num = timed_parse(dict, opts, hard_sentence, &secs);
+	printf("Deadline 0.5 seconds: %d linkages in %.2f seconds\n", num, secs);
+	check(parse_options_resources_exhausted(opts), "the deadline expired");
+	check(0 == num, "no linkages after the deadline");
+	check(secs < 5.0, "the parse stopped soon after the deadline");
+	check(parse_options_get_deadline(opts) == 0, "no time is left");
+
+	parse_options_set_deadline(opts, 0);
+	check(parse_options_get_deadline(opts) < 0, "the deadline is removed");
+	parse_options_set_max_null_count(opts, 0);
+	num = timed_parse(dict, opts, easy_sentence, &secs);
+	check(0 < num, "a parse with no deadline finds linkages");
+	check(!parse_options_resources_exhausted(opts), "no deadline expired");
+}
+
+// A parse is stopped by parse_options_cancel() from another thread. The
+// cancellation stays in effect until parse_options_reset_resources().
+static void test_cancel(Dictionary dict, Parse_Options opts)
+{
+	double secs;
+
+	parse_options_set_max_null_count(opts, 4);
+	std::thread canceller([opts]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(300));
+		parse_options_cancel(opts);
+	});
+	int num = timed_parse(dict, opts, hard_sentence, &secs);
+	canceller.join();
+	printf("Cancelled after 0.3 seconds: %d linkages in %.2f seconds\n",
+	       num, secs);
+	check(parse_options_resources_exhausted(opts), "the parse is cancelled");
+	check(0 == num, "no linkages after cancellation");
+	check(secs < 5.0, "the parse stopped soon after cancellation");
+
+	parse_options_set_max_null_count(opts, 0);
+	num = timed_parse(dict, opts, easy_sentence, &secs);
+	check(0 >= num, "the cancellation is still in effect");
+
+	parse_options_reset_resources(opts);
+	num = timed_parse(dict, opts, easy_sentence, &secs);
+	check(0 < num, "a parse after a reset finds linkages");
+}
+
+// The SAT parser, which the portfolio parsing cancels when the classic
+// parser wins, stops soon after a cancellation too.
+static void test_sat_cancel(Dictionary dict, Parse_Options opts)
+{
+	double secs;
+
+	parse_options_set_use_sat_parser(opts, true);
+	if (!parse_options_get_use_sat_parser(opts))
+	{
+		printf("The SAT parser is not available; skipping its test\n");
+		return;
+	}
+
+	parse_options_reset_resources(opts);
+	double cancelled_at = 0;
+	std::thread canceller([opts, &cancelled_at]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		parse_options_cancel(opts);
+		cancelled_at = wall_time();
+	});
+	int num = timed_parse(dict, opts, sat_sentence, &secs);
+	double returned_at = wall_time();
+	canceller.join();
+
+	if (returned_at < cancelled_at)
+	{
+		printf("The SAT parse ended in %.2f seconds, before its cancellation; "
+		       "skipping its checks\n", secs);
+	}
+	else
+	{
+		printf("SAT parse cancelled after 0.5 seconds: "
+		       "%d linkages in %.2f seconds\n", num, secs);
+		check(parse_options_resources_exhausted(opts),
+		      "the SAT parse is cancelled");
+		check(0 == num, "no SAT linkages after cancellation");
+		check(secs < 5.0, "the SAT parse stopped soon after cancellation");
+	}
+
+	parse_options_reset_resources(opts);
+	parse_options_set_use_sat_parser(opts, false);
+}
+
+// A parse stops when its memory budget is exhausted, and a budget that
+// is big enough doesn't affect it.
+static void test_memory(Dictionary dict, Parse_Options opts)
+{
+	double secs;
+
+	check(parse_options_get_max_memory(opts) == (size_t)-1,
+	      "no memory budget by default");
+
+	parse_options_set_max_memory(opts, 1000000);
+	check(parse_options_get_max_memory(opts) == 1000000, "budget is set");
+	int num = timed_parse(dict, opts, pp_sentence, &secs);
+	printf("Memory budget 1MB: %d linkages\n", num);
+	check(parse_options_memory_exhausted(opts), "the budget is exhausted");
+	check(!parse_options_timer_expired(opts), "the timer didn't expire");
+	check(0 == num, "no linkages when the budget is exhausted");
+
+	parse_options_set_max_memory(opts, (size_t)5 << 30);
+	num = timed_parse(dict, opts, pp_sentence, &secs);
+	printf("Memory budget 5GB: %d linkages\n", num);
+	check(!parse_options_memory_exhausted(opts), "a big budget is enough");
+	check(0 < num, "linkages are found within a big budget");
+
+	parse_options_set_max_memory(opts, (size_t)-1);
+}
+
+// The linkage count overflows above PARSE_NUM_OVERFLOW.
+#define PARSE_NUM_OVERFLOW (1<<24)
+
+// With adaptive_cost, a sentence whose linkage count overflows is
+// parsed with a lower disjunct cost cutoff, and one that doesn't
+// overflow is parsed as without it.
+static void test_adaptive_cost(Dictionary dict, Parse_Options opts)
+{
+	float max_cost = parse_options_get_disjunct_cost(opts);
+
+	check(!parse_options_get_adaptive_cost(opts), "not adaptive by default");
+	Sentence sent = sentence_create(pp_sentence, dict);
+	sentence_parse(sent, opts);
+	printf("Not adaptive: %d linkages found, max cost %.3f\n",
+	       sentence_num_linkages_found(sent), sentence_max_disjunct_cost(sent));
+	check(PARSE_NUM_OVERFLOW < sentence_num_linkages_found(sent),
+	      "the linkage count overflows");
+	check(max_cost == sentence_max_disjunct_cost(sent),
+	      "the cost cutoff is the option value");
+	sentence_delete(sent);
+
+	parse_options_set_adaptive_cost(opts, true);
+	check(parse_options_get_adaptive_cost(opts), "adaptive is set");
+
+	sent = sentence_create(pp_sentence, dict);
+	int num = sentence_parse(sent, opts);
+	float cost = sentence_max_disjunct_cost(sent);
+	printf("Adaptive: %d linkages found, max cost %.3f\n",
+	       sentence_num_linkages_found(sent), cost);
+	check(0 < num, "linkages are found with a lower cost cutoff");
+	check(PARSE_NUM_OVERFLOW >= sentence_num_linkages_found(sent),
+	      "the linkage count doesn't overflow");
+	check(cost < max_cost, "the cost cutoff is lowered");
+	check(0 == sentence_null_count(sent), "no null words");
+	for (int i = 0; i < num; i++)
+	{
+		Linkage linkage = linkage_create(i, sent, opts);
+		if (NULL == linkage) continue;
+		for (size_t w = 0; w < linkage_get_num_words(linkage); w++)
+			check(linkage_get_disjunct_cost(linkage, w) <= cost + 1e-4,
+			      "the disjuncts are within the cost cutoff");
+		linkage_delete(linkage);
+	}
+	sentence_delete(sent);
+
+	sent = sentence_create(easy_sentence, dict);
+	check(0 < sentence_parse(sent, opts), "the easy sentence is parsed");
+	check(max_cost == sentence_max_disjunct_cost(sent),
+	      "the cost cutoff is kept without an overflow");
+	sentence_delete(sent);
+
+	parse_options_set_adaptive_cost(opts, false);
+}
+
+int main()
+{
+	setlocale(LC_ALL, "en_US.UTF-8");
+
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		printf("Fatal error: Unable to open the dictionary\n");
+		return 1;
+	}
+
+	Parse_Options opts = parse_options_create();
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_verbosity(opts, 0);
+
+	test_anytime(dict, opts);
+	test_deadline(dict, opts);
+	test_cancel(dict, opts);
+	test_sat_cancel(dict, opts);
+	test_memory(dict, opts);
+	test_adaptive_cost(dict, opts);
+
+	parse_options_delete(opts);
+	dictionary_delete(dict);
+
+	return check_status();
+}
@@ -0,0 +1,168 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks that the pipelined parse API (pipeline_*()) gives the
+// same results as parsing the sentences one by one, in the submission
+// order, with any number of helper threads.
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "link-grammar/link-includes.h"
+#include "test-check.h"
+
+static const char *sentences[] =
+{
+	"The cat sat on the mat.",
+	"He is the kind of person who would do that.",
+	"This is a test of the pipeline.",
+	"Where did you put the book that I gave you yesterday?",
+	"Thieves stole the paintings that were in the museum.",
+	"The problem is that we don't know where they went.",
+	"I saw the man with the telescope.",
+	"the the the",
+	"It was raining, so we stayed at home and read books.",
+	"John and Mary went to the store to buy some apples.",
+};
+#define NUM_SENTENCES (sizeof(sentences)/sizeof(sentences[0]))
+
+struct Result
+{
+	int num_linkages;
+	std::string diagram;
+};
+
+static Result result(Sentence sent, Parse_Options opts, int num_linkages)
+{
+	Result r = { num_linkages, "" };
+	if (num_linkages <= 0) return r;
+
+	Linkage linkage = linkage_create(0, sent, opts);
+	char *d = linkage_print_diagram(linkage, true, 80);
+	r.diagram = d;
+	linkage_free_diagram(d);
+	linkage_delete(linkage);
+
+	return r;
+}
+
+static std::vector<Result> parse_serially(Dictionary dict, Parse_Options opts)
+{
+	std::vector<Result> results;
+	for (const char *s : sentences)
+	{
+		Sentence sent = sentence_create(s, dict);
+		int num = sentence_parse(sent, opts);
+		results.push_back(result(sent, opts, num));
+		sentence_delete(sent);
+	}
+	return results;
+}
+
+// Parse all the sentences through a pipeline, submitting them as long as
+// it is not full, and check that they come out in order with the same
+// results as a serial parse. If short_length is not 0, this option,
+// which affects the preparation, is set after the pipeline creation.
+static void test_pipeline(Dictionary dict, Parse_Options opts,
+                          const std::vector<Result> &expected,
+                          int num_threads, int depth, int short_length = 0)
+{
+	Pipeline p = pipeline_create(dict, opts, num_threads, depth);
+	check(NULL != p, "pipeline is created");
+	if (NULL == p) return;
+
+	int old_short_length = parse_options_get_short_length(opts);
+	if (0 != short_length)
+		parse_options_set_short_length(opts, short_length);
+
+	size_t submitted = 0, got = 0;
+	bool was_full = false;
+	while (got < NUM_SENTENCES)
+	{
+		while ((submitted < NUM_SENTENCES) &&
+		       pipeline_submit(p, sentences[submitted], (void *)submitted))
+			submitted++;
+		if (submitted < NUM_SENTENCES)
+		{
+			was_full = true;
+			check(submitted - got == (size_t)depth, "full at the given depth");
+		}
+
+		int num;
+		void *user_data;
+		Sentence sent = pipeline_next(p, &num, &user_data);
+		check(NULL != sent, "a submitted sentence comes out");
+		if (NULL == sent) break;
+		check((size_t)(uintptr_t)user_data == got, "sentences are in order");
+
+		Result r = result(sent, opts, num);
+		check(r.num_linkages == expected[got].num_linkages,
+		      "same number of linkages");
+		check(r.diagram == expected[got].diagram, "same diagram");
+		sentence_delete(sent);
+		got++;
+	}
+
+	int num;
+	check(NULL == pipeline_next(p, &num, NULL), "the pipeline is empty");
+	check(was_full == (depth < (int)NUM_SENTENCES), "the depth is a bound");
+
+	pipeline_delete(p);
+	parse_options_set_short_length(opts, old_short_length);
+}
+
+int main()
+{
+	setlocale(LC_ALL, "en_US.UTF-8");
+
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		printf("Fatal error: Unable to open the dictionary\n");
+		return 1;
+	}
+
+	Parse_Options opts = parse_options_create();
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_verbosity(opts, 0);
+
+	std::vector<Result> expected = parse_serially(dict, opts);
+	for (int num_threads : { 0, 1, 3 })
+	{
+		test_pipeline(dict, opts, expected, num_threads, 4);
+		test_pipeline(dict, opts, expected, num_threads, NUM_SENTENCES);
+	}
+
+	// The options are changed after the pipeline creation: the
+	// sentences prepared with the old ones must be prepared again.
+	int short_length = parse_options_get_short_length(opts);
+	parse_options_set_short_length(opts, 2);
+	std::vector<Result> expected_short = parse_serially(dict, opts);
+	parse_options_set_short_length(opts, short_length);
+	bool differ = false;
+	for (size_t i = 0; i < NUM_SENTENCES; i++)
+		differ |= (expected[i].diagram != expected_short[i].diagram);
+	check(differ, "short_length changes the results");
+	test_pipeline(dict, opts, expected_short, 3, 4, 2);
+
+	// Sentences left in the pipeline are freed by pipeline_delete().
+	Pipeline p = pipeline_create(dict, opts, 2, 4);
+	for (const char *s : { sentences[0], sentences[1], sentences[2] })
+		check(pipeline_submit(p, s, NULL), "submitted");
+	pipeline_delete(p);
+
+	parse_options_delete(opts);
+	dictionary_delete(dict);
+
+	return check_status();
+}
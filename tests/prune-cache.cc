@@ -0,0 +1,214 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.     */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks the persistent prune cache (dictionary_set_prune_cache()):
+// a sentence that is parsed again is found in it with the same result,
+// and a damaged cache file or an edited dictionary is a miss, with the
+// result of a fresh parse.
+
+#include <dirent.h>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "link-grammar/link-includes.h"
+#include "test-check.h"
+
+static const char *sentences[] =
+{
+	"the cat saw the dog",
+	"the dog chased a cat",
+	"a cat sat",
+	"the cat saw",
+};
+
+// The dictionary, before and after an edit that doesn't change its
+// version: "saw" doesn't take an object any more.
+static const char *dict_text =
+	"#define dictionary-version-number 5.12.0;\n"
+	"#define dictionary-locale C;\n"
+	"LEFT-WALL: Wd+;\n"
+	"the a: D+;\n"
+	"cat dog: {D-} & (Wd- or O-) & {Ss+};\n"
+	"sat: Ss-;\n"
+	"saw chased: Ss- & {O+};\n";
+
+static const char *edited_dict_text =
+	"#define dictionary-version-number 5.12.0;\n"
+	"#define dictionary-locale C;\n"
+	"LEFT-WALL: Wd+;\n"
+	"the a: D+;\n"
+	"cat dog: {D-} & (Wd- or O-) & {Ss+};\n"
+	"sat saw: Ss-;\n"
+	"chased: Ss- & {O+};\n";
+
+static const char *knowledge_text =
+	"STARTING_LINK_TYPE_TABLE:\n"
+	"W s\n";
+
+static void write_file(const std::string& path, const std::string& text)
+{
+	FILE *f = fopen(path.c_str(), "w");
+	check(NULL != f, "a file is created");
+	if (NULL == f) return;
+	fputs(text.c_str(), f);
+	fclose(f);
+}
+
+static std::vector<std::string> cache_files(const std::string& dir)
+{
+	std::vector<std::string> files;
+	DIR *d = opendir(dir.c_str());
+	if (NULL == d) return files;
+	for (struct dirent *e; NULL != (e = readdir(d)); )
+	{
+		if ('.' != e->d_name[0]) files.push_back(dir + "/" + e->d_name);
+	}
+	closedir(d);
+	return files;
+}
+
+// The result of parsing a sentence: its null count and linkages.
+static std::string parse(Dictionary dict, Parse_Options opts, const char *str)
+{
+	Sentence sent = sentence_create(str, dict);
+	int num = sentence_parse(sent, opts);
+	std::string result = std::to_string(sentence_null_count(sent)) + "\n";
+	for (int i = 0; i < num; i++)
+	{
+		Linkage linkage = linkage_create(i, sent, opts);
+		char *d = linkage_print_diagram(linkage, true, 200);
+		result += d;
+		linkage_free_diagram(d);
+		linkage_delete(linkage);
+	}
+	sentence_delete(sent);
+	return result;
+}
+
+// Parse all the sentences with a new dictionary that uses the cache,
+// and check the number of hits and misses.
+static std::vector<std::string> parse_cached(const std::string& lang,
+                                             const std::string& cache,
+                                             Parse_Options opts,
+                                             size_t hits, const char *what)
+{
+	Dictionary dict = dictionary_create_lang(lang.c_str());
+	check(NULL != dict, "the dictionary is opened");
+	if (NULL == dict) return {};
+	dictionary_set_prune_cache(dict, cache.c_str());
+
+	std::vector<std::string> results;
+	for (const char *str : sentences)
+		results.push_back(parse(dict, opts, str));
+
+	printf("%s: %zu hits, %zu misses\n", what,
+	       dictionary_get_prune_cache_hits(dict),
+	       dictionary_get_prune_cache_misses(dict));
+	check(hits == dictionary_get_prune_cache_hits(dict), what);
+	check(sizeof(sentences)/sizeof(sentences[0]) - hits ==
+	      dictionary_get_prune_cache_misses(dict), what);
+
+	dictionary_delete(dict);
+	return results;
+}
+
+// The results without the cache.
+static std::vector<std::string> parse_uncached(const std::string& lang,
+                                               Parse_Options opts)
+{
+	Dictionary dict = dictionary_create_lang(lang.c_str());
+	std::vector<std::string> results;
+	if (NULL == dict) return results;
+	for (const char *str : sentences)
+		results.push_back(parse(dict, opts, str));
+	dictionary_delete(dict);
+	return results;
+}
+
+int main()
+{
+	setlocale(LC_ALL, "C");
+
+	char tmp[] = "/tmp/lg-prune-cache-XXXXXX";
+	if (NULL == mkdtemp(tmp))
+	{
+		perror("mkdtemp");
+		return 1;
+	}
+	std::string dir = tmp;
+	std::string lang = dir + "/tiny";
+	std::string cache = dir + "/cache";
+	mkdir(lang.c_str(), 0700);
+	mkdir(cache.c_str(), 0700);
+	write_file(lang + "/4.0.dict", dict_text);
+	write_file(lang + "/4.0.affix", "");
+	write_file(lang + "/4.0.regex", "");
+	write_file(lang + "/4.0.knowledge", knowledge_text);
+	write_file(lang + "/4.0.constituent-knowledge", knowledge_text);
+
+	Parse_Options opts = parse_options_create();
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_verbosity(opts, 0);
+
+	size_t num_sentences = sizeof(sentences)/sizeof(sentences[0]);
+	std::vector<std::string> expected = parse_uncached(lang, opts);
+
+	check(parse_cached(lang, cache, opts, 0, "first parse") == expected,
+	      "the first parse is as without the cache");
+	check(num_sentences == cache_files(cache).size(),
+	      "a cache file per sentence");
+	check(parse_cached(lang, cache, opts, num_sentences, "second parse") ==
+	      expected, "the cached parse is as without the cache");
+
+	// Damage each file at a different place; it is not used.
+	size_t n = 0;
+	for (const std::string& path : cache_files(cache))
+	{
+		FILE *f = fopen(path.c_str(), "r+b");
+		fseek(f, 0, SEEK_END);
+		long size = ftell(f);
+		fseek(f, (long)(size * (2 * n++ + 1) / (2 * num_sentences)), SEEK_SET);
+		int c = fgetc(f);
+		fseek(f, -1, SEEK_CUR);
+		fputc(c ^ 0x10, f);
+		fclose(f);
+	}
+	check(parse_cached(lang, cache, opts, 0, "damaged files") == expected,
+	      "damaged files are not used");
+	check(parse_cached(lang, cache, opts, num_sentences, "rewritten files") ==
+	      expected, "damaged files are rewritten");
+
+	// Edit the dictionary without changing its version.
+	write_file(lang + "/4.0.dict", edited_dict_text);
+	std::vector<std::string> edited = parse_uncached(lang, opts);
+	check(edited != expected, "the edit changes the result");
+	check(parse_cached(lang, cache, opts, 0, "edited dictionary") == edited,
+	      "an edited dictionary doesn't use the previous entries");
+
+	parse_options_delete(opts);
+
+	for (const std::string& path : cache_files(cache))
+		remove(path.c_str());
+	remove((lang + "/4.0.dict").c_str());
+	remove((lang + "/4.0.affix").c_str());
+	remove((lang + "/4.0.regex").c_str());
+	remove((lang + "/4.0.knowledge").c_str());
+	remove((lang + "/4.0.constituent-knowledge").c_str());
+	rmdir(cache.c_str());
+	rmdir(lang.c_str());
+	rmdir(dir.c_str());
+
+	return check_status();
+}
@@ -0,0 +1,158 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks the lock-free read cache of the Atomese dictionary
+// (dict-atomese/read-cache.h) without the AtomSpace. A file of words
+// and expressions stands in for the StorageNode, and lookups follow
+// the pattern of as_lookup_list(): a hit takes no lock, and a miss
+// fetches the word from storage under the dictionary mutex.
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "link-grammar/dict-atomese/read-cache.h"
+#include "test-check.h"
+
+static std::string word_name(int i)
+{
+	return "word" + std::to_string(i);
+}
+
+static std::string word_expression(int i)
+{
+	return "A" + std::to_string(i) + "- & B" + std::to_string(i % 7) + "+";
+}
+
+// A file of "word expression" lines. A fetch scans it for the word,
+// as a StorageNode fetches the sections of a word.
+class FileStorage
+{
+	FILE* _file;
+
+public:
+	std::atomic<int> fetches;
+
+	FileStorage(int num_words) : _file(tmpfile()), fetches(0)
+	{
+		for (int i = 0; i < num_words; i++)
+			fprintf(_file, "%s %s\n", word_name(i).c_str(),
+			        word_expression(i).c_str());
+	}
+	~FileStorage() { fclose(_file); }
+
+	// Not thread-safe; called under the dictionary mutex.
+	bool fetch(const char* word, std::string& exp)
+	{
+		fetches++;
+		rewind(_file);
+		char line[256];
+		size_t len = strlen(word);
+		while (NULL != fgets(line, sizeof(line), _file))
+		{
+			if ((0 == strncmp(line, word, len)) && (' ' == line[len]))
+			{
+				exp = line + len + 1;
+				exp.pop_back(); // The newline
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+// The part of the Atomese dictionary that the cache serves.
+class Dict
+{
+	FileStorage& _storage;
+	std::mutex _dict_mutex;
+	std::deque<std::string> _strings;  // Stands in for dict->string_set
+	ReadCache<const char*> _dict_cache;
+
+public:
+	std::atomic<int> locked;
+
+	Dict(FileStorage& storage) : _storage(storage), locked(0) {}
+
+	// Return the expression of the word, or NULL if it is not in the
+	// storage. Unknown words are not cached.
+	const char* lookup(const char* word)
+	{
+		const char* exp;
+		if (_dict_cache.find(word, exp)) return exp;
+
+		std::lock_guard<std::mutex> guard(_dict_mutex);
+		locked++;
+
+		// Some other thread might have just fetched it.
+		if (_dict_cache.find(word, exp)) return exp;
+
+		std::string s;
+		if (!_storage.fetch(word, s)) return NULL;
+		_strings.push_back(word);
+		const char* key = _strings.back().c_str();
+		_strings.push_back(s);
+		exp = _strings.back().c_str();
+		_dict_cache.insert(key, exp);
+		return exp;
+	}
+};
+
+// Each thread looks up all the words several times, in its own order,
+// while the cache is filled and grows.
+static void lookup_words(Dict* dict, int thread_id, int num_words, int rounds)
+{
+	for (int r = 0; r < rounds; r++)
+	{
+		for (int n = 0; n < num_words; n++)
+		{
+			int i = (n * 7919 + thread_id * 104729 + r) % num_words;
+			const char* exp = dict->lookup(word_name(i).c_str());
+			check((NULL != exp) && (word_expression(i) == exp),
+			      "the expression of a word");
+		}
+		check(NULL == dict->lookup("no-such-word"), "an unknown word");
+	}
+}
+
+int main()
+{
+	// Many more words than the initial table size, so that the table
+	// is replaced several times while readers are using it.
+	const int num_words = 3000;
+	const int num_threads = 8;
+	const int rounds = 5;
+
+	FileStorage storage(num_words);
+	Dict dict(storage);
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < num_threads; t++)
+		threads.push_back(std::thread(lookup_words, &dict, t, num_words, rounds));
+	for (std::thread& t : threads) t.join();
+
+	int lookups = num_threads * rounds * (num_words + 1);
+	int unknown = num_threads * rounds;
+	printf("%d lookups: %d locked, %d fetches from storage\n",
+	       lookups, dict.locked.load(), storage.fetches.load());
+
+	// Each word is fetched once; only unknown words are fetched again.
+	check(storage.fetches == num_words + unknown, "each word is fetched once");
+	// Only misses take the lock: at most one per word and thread.
+	check(dict.locked <= num_threads * num_words + unknown,
+	      "cache hits take no lock");
+
+	return check_status();
+}
@@ -0,0 +1,170 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks that sentence_reparse() of an edited sentence gives the
+// same result as a fresh parse, and reports the time it saves.
+
+#include <locale.h>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "link-grammar/link-includes.h"
+#include "test-check.h"
+
+static double cpu_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Versions of a sentence as it is edited, each one differing from the
+// previous one by a single word (replaced, inserted or deleted).
+static const char *versions[] =
+{
+	"The old man who lived near the river saw a big dog with a long tail "
+		"running after the children in the park yesterday.",
+	"The old man who lived near the river saw a small dog with a long tail "
+		"running after the children in the park yesterday.",
+	"The old man who lived near the river saw a small dog with a short tail "
+		"running after the children in the park yesterday.",
+	"The old woman who lived near the river saw a small dog with a short tail "
+		"running after the children in the park yesterday.",
+	"The old woman who lived near the river saw a small black dog with a "
+		"short tail running after the children in the park yesterday.",
+	"The old woman who lived near the river saw a small black dog with a "
+		"short tail running after the children in the park.",
+	"The woman who lived near the river saw a small black dog with a "
+		"short tail running after the children in the park.",
+};
+#define NUM_VERSIONS (sizeof(versions)/sizeof(versions[0]))
+
+// The linkages of a parsed sentence, as diagrams with their costs.
+static std::vector<std::string> linkages(Sentence sent, Parse_Options opts,
+                                         int num_linkages)
+{
+	std::vector<std::string> result;
+	for (int i = 0; i < num_linkages; i++)
+	{
+		Linkage linkage = linkage_create(i, sent, opts);
+		char *d = linkage_print_diagram(linkage, true, 200);
+		char cost[64];
+		snprintf(cost, sizeof(cost), "%.3f %d\n",
+		         linkage_disjunct_cost(linkage),
+		         linkage_unused_word_cost(linkage));
+		result.push_back(std::string(cost) + d);
+		linkage_free_diagram(d);
+		linkage_delete(linkage);
+	}
+	return result;
+}
+
+// Each edited version, reparsed with the previous one, gives the same
+// linkages as a fresh parse.
+static void test_reparse(Dictionary dict, Parse_Options opts)
+{
+	Sentence prev = NULL;
+	for (const char *str : versions)
+	{
+		Sentence fresh = sentence_create(str, dict);
+		int num_fresh = sentence_parse(fresh, opts);
+		std::vector<std::string> expected = linkages(fresh, opts, num_fresh);
+		sentence_delete(fresh);
+
+		Sentence sent = sentence_create(str, dict);
+		int num = sentence_reparse(sent, prev, opts);
+		check(0 < num, "the sentence has linkages");
+		check(num == num_fresh, "same number of linkages");
+		check(linkages(sent, opts, num) == expected, "same linkages");
+
+		sentence_delete(prev);
+		prev = sent;
+	}
+
+	// A plain parse of the last version doesn't record its disjuncts, so
+	// a reparse with it as the previous sentence builds them all, with
+	// the same result.
+	check(0 < sentence_parse(prev, opts), "a plain parse after a reparse");
+	Sentence fresh = sentence_create(versions[0], dict);
+	std::vector<std::string> expected =
+		linkages(fresh, opts, sentence_parse(fresh, opts));
+	sentence_delete(fresh);
+
+	Sentence sent = sentence_create(versions[0], dict);
+	int num = sentence_reparse(sent, prev, opts);
+	check(linkages(sent, opts, num) == expected,
+	      "a reparse after a plain parse");
+	sentence_delete(sent);
+	sentence_delete(prev);
+}
+
+// Report the time of reparsing the edits, compared to parsing each
+// version from scratch. It is not checked, as it depends on the machine.
+static void measure_gain(Dictionary dict, Parse_Options opts)
+{
+	const int rounds = 10;
+
+	double start = cpu_time();
+	for (int r = 0; r < rounds; r++)
+	{
+		for (const char *str : versions)
+		{
+			Sentence sent = sentence_create(str, dict);
+			sentence_parse(sent, opts);
+			sentence_delete(sent);
+		}
+	}
+	double fresh = (cpu_time() - start) / (rounds * NUM_VERSIONS);
+
+	start = cpu_time();
+	for (int r = 0; r < rounds; r++)
+	{
+		Sentence prev = NULL;
+		for (const char *str : versions)
+		{
+			Sentence sent = sentence_create(str, dict);
+			sentence_reparse(sent, prev, opts);
+			sentence_delete(prev);
+			prev = sent;
+		}
+		sentence_delete(prev);
+	}
+	double reparse = (cpu_time() - start) / (rounds * NUM_VERSIONS);
+
+	printf("Parse time per edit: %.2f ms fresh, %.2f ms reparsed (%.0f%% less)\n",
+	       fresh * 1e3, reparse * 1e3, 100 * (fresh - reparse) / fresh);
+}
+
+int main()
+{
+	setlocale(LC_ALL, "en_US.UTF-8");
+
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		printf("Fatal error: Unable to open the dictionary\n");
+		return 1;
+	}
+
+	Parse_Options opts = parse_options_create();
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_verbosity(opts, 0);
+	parse_options_set_linkage_limit(opts, 20);
+
+	test_reparse(dict, opts);
+	measure_gain(dict, opts);
+
+	parse_options_delete(opts);
+	dictionary_delete(dict);
+
+	return check_status();
+}
@@ -0,0 +1,154 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This checks the parse result cache: hits and misses, eviction, that
+// the cache key depends on the parse options, and that results with too
+// many linkages are not cached.
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "link-grammar/link-includes.h"
+#include "test-check.h"
+
+struct Result
+{
+	int num_linkages;
+	int length;
+	char *diagram;
+};
+
+static Result parse(Dictionary dict, Parse_Options opts, const char *str)
+{
+	Result r = { 0, 0, NULL };
+
+	Sentence sent = sentence_create(str, dict);
+	r.num_linkages = sentence_parse(sent, opts);
+	r.length = sentence_length(sent);
+	if (r.num_linkages > 0)
+	{
+		Linkage linkage = linkage_create(0, sent, opts);
+		char *d = linkage_print_diagram(linkage, true, 80);
+		r.diagram = strdup(d);
+		linkage_free_diagram(d);
+		linkage_delete(linkage);
+	}
+	sentence_delete(sent);
+
+	return r;
+}
+
+// Parse str and check that it is a hit or a miss of the result cache
+// and that the result is the same as ref (if given).
+static Result parse_check(Dictionary dict, Parse_Options opts,
+                          const char *str, bool hit, const Result *ref)
+{
+	size_t hits = dictionary_get_result_cache_hits(dict);
+	size_t misses = dictionary_get_result_cache_misses(dict);
+
+	Result r = parse(dict, opts, str);
+
+	size_t dhits = dictionary_get_result_cache_hits(dict) - hits;
+	size_t dmisses = dictionary_get_result_cache_misses(dict) - misses;
+	printf("\"%s\": %s\n", str, (dhits == 1) ? "hit" : "miss");
+	if (hit)
+		check((dhits == 1) && (dmisses == 0), "expected a cache hit");
+	else
+		check((dhits == 0) && (dmisses == 1), "expected a cache miss");
+
+	if (NULL != ref)
+	{
+		check(r.num_linkages == ref->num_linkages, "same number of linkages");
+		check(r.length == ref->length, "same sentence length");
+		check((NULL != r.diagram) && (NULL != ref->diagram) &&
+		      (0 == strcmp(r.diagram, ref->diagram)), "same diagram");
+	}
+
+	return r;
+}
+
+int main()
+{
+	const char *s1 = "The cat sat on the mat.";
+	const char *s2 = "He is the kind of person who would do that.";
+	// It has more than 1000 linkages.
+	const char *s3 =
+		"The man saw the dog with the telescope in the park on the hill near "
+		"the river by the bridge under the tree beside the house with the red "
+		"roof behind the school next to the church.";
+
+	setlocale(LC_ALL, "en_US.UTF-8");
+
+	dictionary_set_data_dir(DICTIONARY_DIR "/data");
+	Dictionary dict = dictionary_create_lang("en");
+	if (!dict) {
+		printf("Fatal error: Unable to open the dictionary\n");
+		return 1;
+	}
+
+	Parse_Options opts = parse_options_create();
+	parse_options_set_spell_guess(opts, 0);
+	parse_options_set_verbosity(opts, 0);
+
+	// Disabled by default.
+	Result r0 = parse(dict, opts, s1);
+	check(0 == dictionary_get_result_cache_hits(dict) +
+	           dictionary_get_result_cache_misses(dict),
+	      "no cache lookups when disabled");
+
+	dictionary_set_result_cache(dict, 1, 0);
+
+	// Miss, then hit with the same results.
+	Result r1 = parse_check(dict, opts, s1, false, &r0);
+	Result r2 = parse_check(dict, opts, s1, true, &r0);
+	check(r2.length > 0, "sentence length is valid on a hit");
+
+	// The key changes with the parse options.
+	parse_options_set_disjunct_cost(opts, 2.0);
+	Result r3 = parse_check(dict, opts, s1, false, NULL);
+	parse_options_set_disjunct_cost(opts, 2.7);
+	parse_options_set_min_null_count(opts, 1);
+	parse_options_set_max_null_count(opts, 1);
+	Result r4 = parse_check(dict, opts, s1, false, NULL);
+	parse_options_set_min_null_count(opts, 0);
+	parse_options_set_max_null_count(opts, 0);
+
+	// With room for a single entry, s2 evicts s1.
+	Result r5 = parse_check(dict, opts, s2, false, NULL);
+	Result r6 = parse_check(dict, opts, s2, true, &r5);
+	Result r7 = parse_check(dict, opts, s1, false, &r0);
+
+	// Growing the cache keeps both.
+	dictionary_set_result_cache(dict, 10, 0);
+	Result r8 = parse_check(dict, opts, s2, false, &r5);
+	Result r9 = parse_check(dict, opts, s1, true, &r0);
+	Result r10 = parse_check(dict, opts, s2, true, &r5);
+
+	// Finalizing and copying many linkages on each miss would cost too
+	// much, so such a result is cached only with a lower linkage limit.
+	parse_options_set_linkage_limit(opts, 10000);
+	Result r11 = parse_check(dict, opts, s3, false, NULL);
+	check(1000 < r11.num_linkages, "many linkages");
+	Result r12 = parse_check(dict, opts, s3, false, &r11);
+	parse_options_set_linkage_limit(opts, 100);
+	Result r13 = parse_check(dict, opts, s3, false, NULL);
+	Result r14 = parse_check(dict, opts, s3, true, &r13);
+
+	Result all[] = { r0, r1, r2, r3, r4, r5, r6, r7, r8, r9, r10,
+	                 r11, r12, r13, r14 };
+	for (Result &r : all) free(r.diagram);
+
+	parse_options_delete(opts);
+	dictionary_delete(dict);
+
+	return check_status();
+}
@@ -0,0 +1,219 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// This runs link-server on a Unix-domain socket and checks it as a
+// client of the LGService protocol would: the response lengths, which
+// the Java clients take as a number of UTF-16 code units, the order of
+// pipelined responses, and that a response doesn't wait for the
+// requests parsed after it.
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "test-check.h"
+
+static size_t utf16_length(const std::string& s)
+{
+	size_t n = 0;
+	for (unsigned char c : s)
+	{
+		if (0x80 != (c & 0xC0)) n++;
+		if (c >= 0xF0) n++;
+	}
+	return n;
+}
+
+class Client
+{
+	int _fd;
+	std::string _in;
+
+	// Read more input; return false on EOF or error.
+	bool fill()
+	{
+		char buf[8192];
+		ssize_t n;
+		do n = recv(_fd, buf, sizeof(buf), 0); while ((n < 0) && (EINTR == errno));
+		if (n <= 0) return false;
+		_in.append(buf, n);
+		return true;
+	}
+
+	bool read_line(std::string& line)
+	{
+		size_t nl;
+		while (std::string::npos == (nl = _in.find('\n')))
+			if (!fill()) return false;
+		line = _in.substr(0, nl + 1);
+		_in.erase(0, nl + 1);
+		return true;
+	}
+
+public:
+	Client(int fd) : _fd(fd) {}
+	~Client() { close(_fd); }
+
+	void send_text(const std::string& s)
+	{
+		check(send(_fd, s.data(), s.size(), MSG_NOSIGNAL) == (ssize_t)s.size(),
+		      "the request is sent");
+	}
+
+	// Read a response, and check its length line. The JSON doesn't
+	// contain newlines, so the line after the length is the response.
+	std::string response()
+	{
+		std::string len, json;
+		if (!read_line(len) || !read_line(json))
+		{
+			check(false, "a response");
+			return "";
+		}
+		check(strtoul(len.c_str(), NULL, 10) == utf16_length(json),
+		      "the length of the response is in UTF-16 code units");
+		return json;
+	}
+
+	// Whether more input is waiting.
+	bool has_input()
+	{
+		struct pollfd pfd = { _fd, POLLIN, 0 };
+		return !_in.empty() || (0 < poll(&pfd, 1, 0));
+	}
+};
+
+static int try_connect(const char *path)
+{
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (0 == connect(fd, (struct sockaddr *)&addr, sizeof(addr))) return fd;
+	close(fd);
+	return -1;
+}
+
+static void test_version(Client& client)
+{
+	client.send_text("get:version\n");
+	std::string r = client.response();
+	check(0 == r.find("{\"version\":\"link-grammar-"), "the version");
+}
+
+// Non-ASCII text makes the UTF-16 length differ from the byte length.
+static void test_utf16_length(Client& client)
+{
+	client.send_text("text:The caf\xc3\xa9 sold \xf0\x9f\x98\x80 mugs.\n");
+	std::string r = client.response();
+	check(std::string::npos != r.find("caf\xc3\xa9"), "the words are returned");
+	check(utf16_length(r) != r.size(), "the response is not ASCII");
+}
+
+// Pipelined requests are answered in order.
+static void test_pipeline(Client& client)
+{
+	const std::vector<std::string> nouns = { "cat", "dog", "bird", "fish" };
+	std::string requests;
+	for (const std::string& noun : nouns)
+		requests += "maxLinkages:1,text:The " + noun + " sleeps.\n";
+	client.send_text(requests);
+
+	for (const std::string& noun : nouns)
+	{
+		std::string r = client.response();
+		check(std::string::npos != r.find("\"" + noun + ".n"),
+		      "the responses are in request order");
+	}
+}
+
+// With a single thread, both requests are parsed by the same thread.
+// The response of the short sentence is sent before the long one is
+// parsed.
+static void test_early_response(Client& client)
+{
+	std::string long_text;
+	for (int i = 0; i < 6; i++)
+		long_text += "the dog that chased the cat that saw the rat ran away and ";
+	client.send_text("text:This is short.\ntext:" + long_text + "it slept.\n");
+
+	std::string r = client.response();
+	check(std::string::npos != r.find("short"), "the short sentence first");
+	check(!client.has_input(), "the short response doesn't wait");
+	r = client.response();
+	check(std::string::npos != r.find("slept"), "the long sentence next");
+}
+
+int main()
+{
+	char dir[] = "/tmp/lg-server-XXXXXX";
+	if (NULL == mkdtemp(dir))
+	{
+		perror("mkdtemp");
+		return 1;
+	}
+	std::string path = std::string(dir) + "/socket";
+
+	pid_t pid = fork();
+	if (0 == pid)
+	{
+		execl(LINK_SERVER, LINK_SERVER, "-s", path.c_str(),
+		      "-l", DICTIONARY_DIR "/data/en", "-t", "1", (char *)NULL);
+		perror(LINK_SERVER);
+		_exit(127);
+	}
+
+	// Wait for the dictionary to load.
+	int fd = -1;
+	for (int i = 0; (i < 600) && (fd < 0); i++)
+	{
+		if (0 != waitpid(pid, NULL, WNOHANG))
+		{
+			printf("Fatal error: link-server has exited\n");
+			return 1;
+		}
+		usleep(100000);
+		fd = try_connect(path.c_str());
+	}
+	if (fd < 0)
+	{
+		printf("Fatal error: Unable to connect to link-server\n");
+		kill(pid, SIGKILL);
+		return 1;
+	}
+
+	{
+		Client client(fd);
+		test_version(client);
+		test_utf16_length(client);
+		test_pipeline(client);
+		test_early_response(client);
+	}
+
+	int status;
+	kill(pid, SIGTERM);
+	waitpid(pid, &status, 0);
+	check(WIFEXITED(status) && (0 == WEXITSTATUS(status)),
+	      "link-server exits cleanly");
+	rmdir(dir);
+
+	return check_status();
+}
@@ -0,0 +1,40 @@
+/***************************************************************************/
+/* Copyright (c) 2026                                                      */
+/* All rights reserved                                                     */
+/*                                                                         */
+/* Use of the link grammar parsing system is subject to the terms of the   */
+/* license set forth in the LICENSE file included with this software.      */
+/* This license allows free redistribution and use in source and binary    */
+/* forms, with or without modification, subject to certain conditions.     */
+/*                                                                         */
+/***************************************************************************/
+
+// The checks of the unit tests. A failed check is counted and printed,
+// and the test fails if any check failed. The count is atomic, since
+// some tests check from several threads; only the first failures are
+// printed, so a check that fails in a loop doesn't flood the log.
+
+#ifndef _LG_TEST_CHECK_H
+#define _LG_TEST_CHECK_H
+
+#include <stdio.h>
+#include <atomic>
+
+#define MAX_FAILS_PRINTED 10
+
+static std::atomic<int> errors(0);
+
+static void check(bool ok, const char *what)
+{
+	if (ok) return;
+	if (errors++ < MAX_FAILS_PRINTED) printf("FAIL: %s\n", what);
+}
+
+// The exit status of the test.
+static int check_status(void)
+{
+	if (errors) printf("%d errors\n", errors.load());
+	return (0 == errors) ? 0 : 1;
+}
+
+#endif // _LG_TEST_CHECK_H